@@ -0,0 +1,246 @@
+#include "benchmark/Benchmark.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <new>
+#include <sstream>
+#include "include/Container.h"
+#include "include/Enum.h"
+#include "include/Utility.h"
+
+using namespace std;
+using namespace Utility;
+
+// Version of the JSON results. Increase it whenever results are no longer comparable with those of earlier versions,
+// e.g. when the declarations are counted differently, so older baselines are rejected.
+static const unsigned ResultFormat = 2;
+
+static std::atomic<uint64_t> allocationCount;
+static std::atomic<uint64_t> allocatedBytes;
+
+// Replacements of the global allocation functions, counting every allocation of the benchmark executable
+void * operator new(size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    void * result = malloc((size == 0) ? 1 : size);
+    if (result == nullptr)
+        throw std::bad_alloc();
+    return result;
+}
+
+void * operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void * pointer) noexcept
+{
+    free(pointer);
+}
+
+void operator delete[](void * pointer) noexcept
+{
+    free(pointer);
+}
+
+namespace CPPParser
+{
+
+Benchmark::Benchmark(unsigned iterations)
+    : _iterations((iterations > 0) ? iterations : 1)
+    , _results()
+{
+}
+
+void Benchmark::Run(const std::string & suite, const std::string & stage, size_t files, const Stage & run,
+                    const Counter & count)
+{
+    BenchmarkResult result;
+    result.suite = suite;
+    result.stage = stage;
+    result.files = files;
+    result.iterations = _iterations;
+    double totalSeconds = 0.0;
+    uint64_t allocationsBefore = AllocationCount();
+    uint64_t bytesBefore = AllocatedBytes();
+    for (unsigned iteration = 0; iteration < _iterations; ++iteration)
+    {
+        auto start = std::chrono::steady_clock::now();
+        run();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        totalSeconds += seconds;
+        if ((iteration == 0) || (seconds < result.bestSeconds))
+            result.bestSeconds = seconds;
+    }
+    result.meanSeconds = totalSeconds / _iterations;
+    result.allocations = (AllocationCount() - allocationsBefore) / _iterations;
+    result.allocatedBytes = (AllocatedBytes() - bytesBefore) / _iterations;
+    result.declarations = count();
+    _results.push_back(result);
+}
+
+void Benchmark::Report(std::ostream & stream) const
+{
+    stream << std::left << std::setw(14) << "Suite" << std::setw(18) << "Stage" << std::right
+           << std::setw(8) << "Files" << std::setw(14) << "Best (ms)" << std::setw(14) << "Mean (ms)"
+           << std::setw(14) << "Decls" << std::setw(14) << "Decls/s" << std::setw(14) << "Allocs"
+           << std::setw(16) << "Alloc bytes" << endl;
+    std::ios::fmtflags flags = stream.flags();
+    stream << std::fixed << std::setprecision(3);
+    for (auto const & result : _results)
+    {
+        stream << std::left << std::setw(14) << result.suite << std::setw(18) << result.stage << std::right
+               << std::setw(8) << result.files << std::setw(14) << result.bestSeconds * 1000
+               << std::setw(14) << result.meanSeconds * 1000 << std::setw(14) << result.declarations
+               << std::setw(14) << std::setprecision(0) << result.DeclarationsPerSecond() << std::setprecision(3)
+               << std::setw(14) << result.allocations << std::setw(16) << result.allocatedBytes << endl;
+    }
+    stream.flags(flags);
+}
+
+void Benchmark::ReportJSON(std::ostream & stream) const
+{
+    // One result per line, which is what ReadJSON expects
+    stream << "{" << endl << "  \"format\": " << ResultFormat << "," << endl << "  \"benchmarks\": [";
+    for (size_t index = 0; index < _results.size(); ++index)
+    {
+        const BenchmarkResult & result = _results[index];
+        stream << ((index > 0) ? "," : "") << endl
+               << "    {\"suite\": " << JSONString(result.suite) << ", \"stage\": " << JSONString(result.stage)
+               << ", \"files\": " << result.files << ", \"iterations\": " << result.iterations
+               << ", \"bestSeconds\": " << result.bestSeconds << ", \"meanSeconds\": " << result.meanSeconds
+               << ", \"declarations\": " << result.declarations
+               << ", \"declarationsPerSecond\": " << result.DeclarationsPerSecond()
+               << ", \"allocations\": " << result.allocations << ", \"allocatedBytes\": " << result.allocatedBytes
+               << "}";
+    }
+    stream << endl << "  ]" << endl << "}" << endl;
+}
+
+// Reads the value of the field from a line written by ReportJSON. String values do not contain escaped characters.
+static bool ReadField(const std::string & line, const std::string & name, std::string & value)
+{
+    std::string key = "\"" + name + "\": ";
+    size_t start = line.find(key);
+    if (start == std::string::npos)
+        return false;
+    start += key.length();
+    if ((start < line.length()) && (line[start] == '"'))
+    {
+        size_t end = line.find('"', start + 1);
+        if (end == std::string::npos)
+            return false;
+        value = line.substr(start + 1, end - start - 1);
+        return true;
+    }
+    size_t end = line.find_first_of(",}", start);
+    value = line.substr(start, end - start);
+    return true;
+}
+
+bool Benchmark::ReadJSON(const std::string & path, std::vector<BenchmarkResult> & results)
+{
+    results.clear();
+    std::ifstream stream(path);
+    if (!stream)
+    {
+        ErrorStream() << "Cannot read benchmark results from " << path << endl;
+        return false;
+    }
+    std::string line;
+    bool formatFound = false;
+    while (std::getline(stream, line))
+    {
+        std::string format;
+        if (!formatFound && ReadField(line, "format", format))
+        {
+            if (format != std::to_string(ResultFormat))
+            {
+                ErrorStream() << "Benchmark results in " << path << " have format " << format << ", expected "
+                              << ResultFormat << endl;
+                return false;
+            }
+            formatFound = true;
+            continue;
+        }
+        BenchmarkResult result;
+        std::string bestSeconds;
+        std::string allocations;
+        if (!ReadField(line, "suite", result.suite) || !ReadField(line, "stage", result.stage) ||
+            !ReadField(line, "bestSeconds", bestSeconds) || !ReadField(line, "allocations", allocations))
+            continue;
+        result.bestSeconds = std::strtod(bestSeconds.c_str(), nullptr);
+        result.allocations = std::strtoull(allocations.c_str(), nullptr, 10);
+        results.push_back(result);
+    }
+    if (!formatFound)
+    {
+        ErrorStream() << "Benchmark results in " << path << " have no format, expected " << ResultFormat << endl;
+        return false;
+    }
+    return true;
+}
+
+bool Benchmark::Compare(const std::vector<BenchmarkResult> & baseline, double threshold, std::ostream & stream) const
+{
+    bool ok = true;
+    std::ios::fmtflags flags = stream.flags();
+    stream << std::fixed << std::setprecision(1);
+    stream << "Comparison with baseline (time change / allocation change)" << endl;
+    for (auto const & result : _results)
+    {
+        const BenchmarkResult * base = nullptr;
+        for (auto const & candidate : baseline)
+        {
+            if ((candidate.suite == result.suite) && (candidate.stage == result.stage))
+                base = &candidate;
+        }
+        stream << "  " << std::left << std::setw(14) << result.suite << std::setw(18) << result.stage << std::right;
+        if (base == nullptr)
+        {
+            stream << "  not in baseline" << endl;
+            continue;
+        }
+        double timeChange = (base->bestSeconds > 0) ? result.bestSeconds / base->bestSeconds - 1.0 : 0.0;
+        double allocationChange = (base->allocations > 0)
+                                  ? static_cast<double>(result.allocations) / base->allocations - 1.0 : 0.0;
+        bool regression = (timeChange > threshold) || (allocationChange > threshold);
+        stream << std::setw(10) << timeChange * 100 << "%" << std::setw(10) << allocationChange * 100 << "%"
+               << (regression ? "  REGRESSION" : "") << endl;
+        if (regression)
+            ok = false;
+    }
+    stream.flags(flags);
+    return ok;
+}
+
+uint64_t Benchmark::CountDeclarations(const Container & tree)
+{
+    uint64_t result = 0;
+    for (auto const & element : tree.Contents())
+    {
+        ++result;
+        if (element->Kind() == ElementKind::Enum)
+            result += static_cast<const Enum &>(*element).Values().size();
+        const Container * childContainer = dynamic_cast<const Container *>(element.get());
+        if (childContainer != nullptr)
+            result += CountDeclarations(*childContainer);
+    }
+    return result;
+}
+
+uint64_t Benchmark::AllocationCount()
+{
+    return allocationCount;
+}
+
+uint64_t Benchmark::AllocatedBytes()
+{
+    return allocatedBytes;
+}
+
+} // namespace CPPParser
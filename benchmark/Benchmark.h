@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace CPPParser
+{
+
+class Container;
+
+// Result of running one stage over the inputs of a suite
+struct BenchmarkResult
+{
+    BenchmarkResult()
+        : suite()
+        , stage()
+        , files()
+        , iterations()
+        , bestSeconds()
+        , meanSeconds()
+        , declarations()
+        , allocations()
+        , allocatedBytes()
+    {}
+    // Declarations per second in the fastest iteration
+    double DeclarationsPerSecond() const { return (bestSeconds > 0) ? declarations / bestSeconds : 0.0; }
+
+    std::string suite;
+    std::string stage;
+    uint64_t files;
+    uint64_t iterations;
+    double bestSeconds;
+    double meanSeconds;
+    // Declarations processed per iteration
+    uint64_t declarations;
+    // Allocations per iteration
+    uint64_t allocations;
+    uint64_t allocatedBytes;
+};
+
+// Runs stages of the generator a number of times, and reports the time, throughput and allocations of each.
+// Allocations are counted by the replacement of operator new in the benchmark executable.
+class Benchmark
+{
+public:
+    // Runs one iteration of a stage
+    using Stage = std::function<void ()>;
+    // Returns the number of declarations one iteration of a stage processed
+    using Counter = std::function<uint64_t ()>;
+
+    explicit Benchmark(unsigned iterations);
+
+    // The declarations are counted once after the last iteration, outside the measurements
+    void Run(const std::string & suite, const std::string & stage, size_t files, const Stage & run,
+             const Counter & count);
+    unsigned Iterations() const { return _iterations; }
+    const std::vector<BenchmarkResult> & Results() const { return _results; }
+
+    // Writes the results as a table, or as JSON which ReadJSON can read back as a baseline. ReadJSON fails on results
+    // written in another format version.
+    void Report(std::ostream & stream) const;
+    void ReportJSON(std::ostream & stream) const;
+    static bool ReadJSON(const std::string & path, std::vector<BenchmarkResult> & results);
+    // Writes the change of every stage against the baseline. Returns false if a stage got slower, or allocates more,
+    // by more than the threshold, a fraction of the baseline.
+    bool Compare(const std::vector<BenchmarkResult> & baseline, double threshold, std::ostream & stream) const;
+
+    // Number of declarations in the tree, including enum constants and not counting its root
+    static uint64_t CountDeclarations(const Container & tree);
+
+    static uint64_t AllocationCount();
+    static uint64_t AllocatedBytes();
+
+private:
+    unsigned _iterations;
+    std::vector<BenchmarkResult> _results;
+};
+
+} // namespace CPPParser
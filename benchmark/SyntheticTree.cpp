@@ -0,0 +1,161 @@
+#include "benchmark/SyntheticTree.h"
+
+#include "include/Enum.h"
+#include "include/Function.h"
+#include "include/Namespace.h"
+#include "include/Struct.h"
+#include "include/Typedef.h"
+#include "include/Variable.h"
+
+using namespace std;
+
+namespace CPPParser
+{
+
+static const char * const Types[] = { "int", "unsigned int", "bool", "const std::string &", "uint32_t", "double" };
+static const size_t TypeCount = sizeof(Types) / sizeof(Types[0]);
+
+SyntheticTree::SyntheticTree()
+    : _ast()
+    , _arena(_ast.Arena())
+    , _location()
+{
+    _location.fileName = "Synthetic.h";
+}
+
+void SyntheticTree::AddNamespaces(unsigned count)
+{
+    for (unsigned index = 0; index < count; ++index)
+    {
+        std::string suffix = std::to_string(index);
+        auto aNamespace = MakeNode<Namespace>(_arena, Element::WeakPtr(), NextLocation(), "Namespace" + suffix);
+        for (unsigned classIndex = 0; classIndex < 2; ++classIndex)
+        {
+            aNamespace->Add(MakeClass(aNamespace, "Class" + suffix + "_" + std::to_string(classIndex), 10));
+        }
+        auto aStruct = MakeNode<Struct>(_arena, aNamespace, NextLocation(), "Struct" + suffix, AccessSpecifier::Invalid);
+        for (unsigned member = 0; member < 4; ++member)
+        {
+            aStruct->Add(MakeNode<DataMember>(_arena, aStruct, NextLocation(), "member" + std::to_string(member),
+                                              AccessSpecifier::Public, Types[member % TypeCount]));
+        }
+        aNamespace->Add(aStruct);
+        auto anEnum = MakeNode<Enum>(_arena, aNamespace, NextLocation(), "Enum" + suffix, AccessSpecifier::Invalid,
+                                     "int");
+        for (unsigned constant = 0; constant < 16; ++constant)
+        {
+            anEnum->AddValue("Value" + suffix + "_" + std::to_string(constant), constant);
+        }
+        aNamespace->Add(anEnum);
+        aNamespace->Add(MakeNode<Typedef>(_arena, aNamespace, NextLocation(), "Type" + suffix, AccessSpecifier::Invalid,
+                                          Types[index % TypeCount]));
+        _ast.Add(aNamespace);
+    }
+}
+
+void SyntheticTree::AddInterfaces(unsigned namespaces, unsigned classes)
+{
+    for (unsigned index = 0; index < namespaces; ++index)
+    {
+        auto aNamespace = MakeNode<Namespace>(_arena, Element::WeakPtr(), NextLocation(),
+                                              "Interfaces" + std::to_string(index));
+        for (unsigned classIndex = 0; classIndex < classes; ++classIndex)
+        {
+            std::string name = "I" + std::to_string(classIndex);
+            auto aClass = MakeNode<Class>(_arena, aNamespace, NextLocation(), name, AccessSpecifier::Invalid);
+            aClass->Add(MakeNode<Constructor>(_arena, aClass, NextLocation(), name, AccessSpecifier::Public,
+                                              ParameterList(), FunctionFlags::Default));
+            aClass->Add(MakeNode<Destructor>(_arena, aClass, NextLocation(), "~" + name, AccessSpecifier::Public,
+                                             FunctionFlags::Virtual));
+            for (unsigned method = 0; method < 5; ++method)
+            {
+                aClass->Add(MakeNode<Method>(_arena, aClass, NextLocation(), "Method" + std::to_string(method),
+                                             AccessSpecifier::Public, "uint32_t",
+                                             ParameterList{Parameter("a", "const string &"), Parameter("b", "int")},
+                                             FunctionFlags::PureVirtual));
+            }
+            for (unsigned member = 0; member < 3; ++member)
+            {
+                aClass->Add(MakeNode<DataMember>(_arena, aClass, NextLocation(), "_member" + std::to_string(member),
+                                                 AccessSpecifier::Private, "int"));
+            }
+            aNamespace->Add(aClass);
+        }
+        _ast.Add(aNamespace);
+    }
+}
+
+void SyntheticTree::AddWideClasses(unsigned count, unsigned methods)
+{
+    auto aNamespace = MakeNode<Namespace>(_arena, Element::WeakPtr(), NextLocation(), "Wide");
+    for (unsigned index = 0; index < count; ++index)
+    {
+        aNamespace->Add(MakeClass(aNamespace, "WideClass" + std::to_string(index), methods));
+    }
+    _ast.Add(aNamespace);
+}
+
+void SyntheticTree::AddLargeEnums(unsigned count, unsigned constants)
+{
+    auto aNamespace = MakeNode<Namespace>(_arena, Element::WeakPtr(), NextLocation(), "Enums");
+    for (unsigned index = 0; index < count; ++index)
+    {
+        std::string name = "LargeEnum" + std::to_string(index);
+        auto anEnum = MakeNode<Enum>(_arena, aNamespace, NextLocation(), name, AccessSpecifier::Invalid,
+                                     "unsigned int");
+        for (unsigned constant = 0; constant < constants; ++constant)
+        {
+            anEnum->AddValue(name + "_Value" + std::to_string(constant), constant);
+        }
+        aNamespace->Add(anEnum);
+    }
+    _ast.Add(aNamespace);
+}
+
+void SyntheticTree::AddDeepNesting(unsigned depth)
+{
+    // Namespaces in the outer half, and classes nested in each other in the inner half
+    Container::Ptr outer = MakeNode<Namespace>(_arena, Element::WeakPtr(), NextLocation(), "Nested0");
+    _ast.Add(outer);
+    for (unsigned level = 1; level < depth; ++level)
+    {
+        std::string name = "Nested" + std::to_string(level);
+        Container::Ptr inner;
+        if (level < depth / 2)
+            inner = MakeNode<Namespace>(_arena, outer, NextLocation(), name);
+        else
+        {
+            auto aClass = MakeClass(outer, name, 1);
+            aClass->Add(MakeNode<DataMember>(_arena, aClass, NextLocation(), "member", AccessSpecifier::Private,
+                                             Types[level % TypeCount]));
+            inner = aClass;
+        }
+        outer->Add(inner);
+        outer = inner;
+    }
+}
+
+SourceLocation SyntheticTree::NextLocation()
+{
+    ++_location.line;
+    return _location;
+}
+
+std::shared_ptr<Class> SyntheticTree::MakeClass(const Element::Ptr & parent, const std::string & name, unsigned methods)
+{
+    auto aClass = MakeNode<Class>(_arena, parent, NextLocation(), name, AccessSpecifier::Invalid);
+    for (unsigned method = 0; method < methods; ++method)
+    {
+        ParameterList parameters;
+        for (unsigned parameter = 0; parameter < method % 4; ++parameter)
+        {
+            parameters.emplace_back("parameter" + std::to_string(parameter), Types[(method + parameter) % TypeCount]);
+        }
+        FunctionFlags flags = (method % 2 == 0) ? FunctionFlags::PureVirtual : FunctionFlags::Const;
+        aClass->Add(MakeNode<Method>(_arena, aClass, NextLocation(), "Method" + std::to_string(method),
+                                     AccessSpecifier::Public, Types[method % TypeCount], parameters, flags));
+    }
+    return aClass;
+}
+
+} // namespace CPPParser
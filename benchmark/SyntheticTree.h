@@ -0,0 +1,43 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include "include/AST.h"
+#include "include/Class.h"
+#include "include/NodeArena.h"
+
+namespace CPPParser
+{
+
+// Builds a tree in memory from the node constructors, allocating the nodes from an arena as the parser does, so the
+// visitors can be measured without parsing. Names and types are varied, so the strings are not all shared.
+class SyntheticTree
+{
+public:
+    SyntheticTree();
+
+    // Namespaces, each holding classes with a few methods, a struct, an enum and a typedef
+    void AddNamespaces(unsigned count);
+    // Namespaces holding interface classes, each with a constructor, a virtual destructor, pure virtual methods and
+    // data members
+    void AddInterfaces(unsigned namespaces, unsigned classes);
+    // Classes with many methods each, taking up to three parameters
+    void AddWideClasses(unsigned count, unsigned methods);
+    void AddLargeEnums(unsigned count, unsigned constants);
+    // Namespaces nested in each other, with classes nested in each other in the innermost one, each class with a method
+    // and a data member
+    void AddDeepNesting(unsigned depth);
+
+    const AST & Tree() const { return _ast; }
+
+private:
+    AST _ast;
+    // Arena of the tree, which owns it
+    std::shared_ptr<NodeArena> _arena;
+    SourceLocation _location;
+
+    SourceLocation NextLocation();
+    std::shared_ptr<Class> MakeClass(const Element::Ptr & parent, const std::string & name, unsigned methods);
+};
+
+} // namespace CPPParser
@@ -0,0 +1,359 @@
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <dirent.h>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <streambuf>
+#include <benchmark/Benchmark.h>
+#include <benchmark/SyntheticTree.h>
+#include <corpus/CorpusGenerator.h>
+#include <include/CursorMap.h>
+#include <include/Parser.h>
+
+using namespace std;
+
+// Discards the generated output, so writing it does not take part in the measurements
+class NullBuffer : public std::streambuf
+{
+protected:
+    virtual int overflow(int c) override { return c; }
+    virtual std::streamsize xsputn(const char *, std::streamsize count) override { return count; }
+};
+
+static void ShowUsage(const char * program)
+{
+    cerr << "Usage " << program << " [--iterations=<count>] [--suite=testdata|corpus|namespaces|interfaces|wide-classes|large-enums|deep-nesting|cursor-lookup] ... [--corpus-files=<count>] [--seed=<number>] [--corpus-dir=<directory>] [--output=<json file>] [--baseline=<json file>] [--threshold=<percentage>]" << endl;
+}
+
+static bool ParsePercentage(const std::string & text, double & value)
+{
+    if (text.empty())
+        return false;
+    char * end = nullptr;
+    errno = 0;
+    double result = std::strtod(text.c_str(), &end);
+    if ((errno == ERANGE) || (*end != '\0') || !std::isfinite(result) || (result < 0))
+        return false;
+    value = result;
+    return true;
+}
+
+static bool ListHeaders(const std::string & directory, std::vector<std::string> & files)
+{
+    DIR * dir = opendir(directory.c_str());
+    if (dir == nullptr)
+    {
+        cerr << "Cannot read directory " << directory << endl;
+        return false;
+    }
+    while (struct dirent * entry = readdir(dir))
+    {
+        std::string path = directory + "/" + entry->d_name;
+        std::string directoryPart;
+        std::string fileName;
+        std::string extension;
+        Utility::SplitPath(path, directoryPart, fileName, extension);
+        if ((extension == "h") || (extension == "hpp"))
+            files.push_back(path);
+    }
+    closedir(dir);
+    std::sort(files.begin(), files.end());
+    return true;
+}
+
+static uint64_t CountDeclarations(const std::vector<const CPPParser::AST *> & trees)
+{
+    uint64_t declarations = 0;
+    for (auto tree : trees)
+    {
+        declarations += CPPParser::Benchmark::CountDeclarations(*tree);
+    }
+    return declarations;
+}
+
+// Runs the visitors over the trees, writing to a stream that discards the output
+static void RunVisitors(CPPParser::Benchmark & benchmark, const std::string & suite, size_t files,
+                        const std::vector<const CPPParser::AST *> & trees)
+{
+    NullBuffer nullBuffer;
+    std::ostream nullStream(&nullBuffer);
+    auto count = [&]() { return CountDeclarations(trees); };
+    benchmark.Run(suite, "tree-info", files, [&]()
+    {
+        for (auto tree : trees)
+        {
+            tree->Show(nullStream, 0);
+        }
+    }, count);
+    benchmark.Run(suite, "code-generator", files, [&]()
+    {
+        for (auto tree : trees)
+        {
+            tree->GenerateCode(nullStream, 0);
+        }
+    }, count);
+}
+
+// Parses the files, then runs the stages after parsing on the trees of the last parse
+static bool RunSuite(CPPParser::Benchmark & benchmark, const std::string & suite, const std::vector<std::string> & files)
+{
+    const CPPParser::OptionsList options = { "-x", "c++" };
+    std::vector<std::unique_ptr<CPPParser::Parser>> parsers;
+    std::vector<const CPPParser::AST *> trees;
+    bool ok = true;
+    // Building the AST is interleaved with visiting the cursors, so it is part of the parse stage
+    benchmark.Run(suite, "parse", files.size(), [&]()
+    {
+        parsers.clear();
+        for (auto const & file : files)
+        {
+            std::unique_ptr<CPPParser::Parser> parser(new CPPParser::Parser(file));
+            if (!parser->Parse(options))
+                ok = false;
+            parsers.push_back(std::move(parser));
+        }
+    }, [&]()
+    {
+        trees.clear();
+        for (auto const & parser : parsers)
+        {
+            trees.push_back(&parser->GetAST());
+        }
+        return CountDeclarations(trees);
+    });
+    if (!ok)
+    {
+        cerr << "Parsing the " << suite << " suite failed" << endl;
+        return false;
+    }
+
+    // The collections are not kept, so they are built once more to count them
+    benchmark.Run(suite, "ast-collection", files.size(), [&]()
+    {
+        for (auto const & parser : parsers)
+        {
+            CPPParser::ASTCollection collection;
+            collection.Merge(parser->GetAST());
+        }
+    }, [&]()
+    {
+        uint64_t declarations = 0;
+        for (auto const & parser : parsers)
+        {
+            CPPParser::ASTCollection collection;
+            collection.Merge(parser->GetAST());
+            declarations += CPPParser::Benchmark::CountDeclarations(collection);
+        }
+        return declarations;
+    });
+
+    RunVisitors(benchmark, suite, files.size(), trees);
+    return true;
+}
+
+static CXChildVisitResult collectVisitor(CXCursor cursor, CXCursor, CXClientData clientData)
+{
+    reinterpret_cast<std::vector<CXCursor> *>(clientData)->push_back(cursor);
+    return CXChildVisit_Recurse;
+}
+
+// Looks up every cursor of a translation unit with over 100k cursors, in the CursorMap the parser uses and in the
+// std::map ordered by memcmp it replaced. The declarations reported are the lookups of one iteration.
+static bool RunCursorSuite(CPPParser::Benchmark & benchmark, const std::string & suite, const std::string & directory)
+{
+    std::string path = directory + "/CursorLookup.h";
+    {
+        if (!Utility::CreateDirectory(directory))
+        {
+            cerr << "Cannot create directory " << directory << endl;
+            return false;
+        }
+        std::ofstream file(path);
+        file << "namespace Benchmark {" << endl;
+        for (int index = 0; index < 20000; ++index)
+        {
+            file << "class C" << index << " { public: void M0(int a, int b); int M1() const; int f; };" << endl;
+        }
+        file << "}" << endl;
+        if (!file)
+        {
+            cerr << "Cannot write " << path << endl;
+            return false;
+        }
+    }
+    const char * args[] = { "-x", "c++", "-std=c++11" };
+    CXIndex index = clang_createIndex(0, 0);
+    CXTranslationUnit unit = nullptr;
+    if (clang_parseTranslationUnit2(index, path.c_str(), args, 3, nullptr, 0, CXTranslationUnit_SkipFunctionBodies,
+                                    &unit) != CXError_Success)
+    {
+        cerr << "Cannot parse " << path << endl;
+        clang_disposeIndex(index);
+        return false;
+    }
+    std::vector<CXCursor> cursors;
+    clang_visitChildren(clang_getTranslationUnitCursor(unit), collectVisitor, &cursors);
+
+    std::map<CXCursor, size_t> orderedMap;
+    CPPParser::CursorMap<size_t> cursorMap;
+    for (size_t position = 0; position < cursors.size(); ++position)
+    {
+        orderedMap.insert({cursors[position], position});
+        cursorMap.Insert(cursors[position], position);
+    }
+    size_t found = 0;
+    auto count = [&]() -> uint64_t { return cursors.size(); };
+    benchmark.Run(suite, "cursor-map", 1, [&]()
+    {
+        for (auto const & cursor : cursors)
+            found += (cursorMap.Find(cursor) != nullptr) ? 1 : 0;
+    }, count);
+    benchmark.Run(suite, "ordered-map", 1, [&]()
+    {
+        for (auto const & cursor : cursors)
+            found += (orderedMap.find(cursor) != orderedMap.end()) ? 1 : 0;
+    }, count);
+
+    clang_disposeTranslationUnit(unit);
+    clang_disposeIndex(index);
+    if (found != 2 * benchmark.Iterations() * cursors.size())
+    {
+        cerr << "Not every cursor was found in the " << suite << " suite" << endl;
+        return false;
+    }
+    return true;
+}
+
+// Builds a tree of the shape of the suite in memory, and runs the visitors over it without parsing
+static bool RunTreeSuite(CPPParser::Benchmark & benchmark, const std::string & suite)
+{
+    CPPParser::SyntheticTree tree;
+    if (suite == "namespaces")
+        tree.AddNamespaces(1000);
+    else if (suite == "interfaces")
+        tree.AddInterfaces(200, 100);
+    else if (suite == "wide-classes")
+        tree.AddWideClasses(50, 500);
+    else if (suite == "large-enums")
+        tree.AddLargeEnums(20, 5000);
+    else if (suite == "deep-nesting")
+        tree.AddDeepNesting(1000);
+    else
+        return false;
+    RunVisitors(benchmark, suite, 0, { &tree.Tree() });
+    return true;
+}
+
+int main(int argc, char * argv[])
+{
+    unsigned iterations = 5;
+    CPPParser::CorpusOptions corpusOptions;
+    corpusOptions.files = 200;
+    std::string corpusDirectory = BENCHMARK_CORPUS_DIR;
+    std::vector<std::string> suites;
+    std::string outputFile;
+    std::string baselineFile;
+    double threshold = 10;
+    const std::string optionIterations = "--iterations=";
+    const std::string optionSuite = "--suite=";
+    const std::string optionCorpusFiles = "--corpus-files=";
+    const std::string optionSeed = "--seed=";
+    const std::string optionCorpusDir = "--corpus-dir=";
+    const std::string optionOutput = "--output=";
+    const std::string optionBaseline = "--baseline=";
+    const std::string optionThreshold = "--threshold=";
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        bool valid = true;
+        if (argument.compare(0, optionIterations.length(), optionIterations) == 0)
+            valid = Utility::ParseNumber(argument.substr(optionIterations.length()), iterations) && (iterations > 0);
+        else if (argument.compare(0, optionSuite.length(), optionSuite) == 0)
+            suites.push_back(argument.substr(optionSuite.length()));
+        else if (argument.compare(0, optionCorpusFiles.length(), optionCorpusFiles) == 0)
+            valid = Utility::ParseNumber(argument.substr(optionCorpusFiles.length()), corpusOptions.files) &&
+                    (corpusOptions.files > 0);
+        else if (argument.compare(0, optionSeed.length(), optionSeed) == 0)
+            valid = Utility::ParseNumber(argument.substr(optionSeed.length()), corpusOptions.seed);
+        else if (argument.compare(0, optionCorpusDir.length(), optionCorpusDir) == 0)
+            corpusDirectory = argument.substr(optionCorpusDir.length());
+        else if (argument.compare(0, optionOutput.length(), optionOutput) == 0)
+            outputFile = argument.substr(optionOutput.length());
+        else if (argument.compare(0, optionBaseline.length(), optionBaseline) == 0)
+            baselineFile = argument.substr(optionBaseline.length());
+        else if (argument.compare(0, optionThreshold.length(), optionThreshold) == 0)
+            valid = ParsePercentage(argument.substr(optionThreshold.length()), threshold);
+        else
+        {
+            ShowUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        if (!valid)
+        {
+            cerr << "Invalid value: " << argument << endl;
+            ShowUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (suites.empty())
+        suites = { "testdata", "corpus", "namespaces", "interfaces", "wide-classes", "large-enums", "deep-nesting", "cursor-lookup" };
+
+    CPPParser::Benchmark benchmark(iterations);
+    for (auto const & suite : suites)
+    {
+        std::vector<std::string> files;
+        if (suite == "testdata")
+        {
+            if (!ListHeaders(TESTDATA_ROOT, files))
+                return EXIT_FAILURE;
+        }
+        else if (suite == "corpus")
+        {
+            CPPParser::CorpusGenerator generator(corpusOptions);
+            if (!generator.Generate(corpusDirectory, files))
+                return EXIT_FAILURE;
+        }
+        else if (suite == "cursor-lookup")
+        {
+            if (!RunCursorSuite(benchmark, suite, corpusDirectory))
+                return EXIT_FAILURE;
+            continue;
+        }
+        else
+        {
+            if (!RunTreeSuite(benchmark, suite))
+            {
+                cerr << "Unknown suite: " << suite << endl;
+                return EXIT_FAILURE;
+            }
+            continue;
+        }
+        if (!RunSuite(benchmark, suite, files))
+            return EXIT_FAILURE;
+    }
+    benchmark.Report(cout);
+
+    if (!outputFile.empty())
+    {
+        std::ofstream outputStream(outputFile);
+        benchmark.ReportJSON(outputStream);
+        if (!outputStream)
+        {
+            cerr << "Cannot write benchmark results to " << outputFile << endl;
+            return EXIT_FAILURE;
+        }
+    }
+    if (!baselineFile.empty())
+    {
+        std::vector<CPPParser::BenchmarkResult> baseline;
+        if (!CPPParser::Benchmark::ReadJSON(baselineFile, baseline))
+            return EXIT_FAILURE;
+        if (!benchmark.Compare(baseline, threshold / 100, cout))
+            return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,293 @@
+#include "corpus/CorpusGenerator.h"
+
+#include <cstdio>
+#include <fstream>
+#include <set>
+
+using namespace std;
+using namespace Utility;
+
+namespace CPPParser
+{
+
+static const char * const Namespaces[] =
+    { "Exchange", "PluginHost", "RPC", "Display", "Network", "Media", "Security", "Storage" };
+static const char * const Areas[] =
+    { "Display", "Audio", "Network", "Power", "Storage", "Input", "Bluetooth", "Camera", "Location", "Time" };
+static const char * const Nouns[] =
+    { "Controller", "Manager", "Service", "Monitor", "Provider", "Session", "Device", "Settings" };
+static const char * const Verbs[] =
+    { "Get", "Set", "Start", "Stop", "Reset", "Query", "Update", "Enable", "Disable", "Configure" };
+static const char * const Objects[] =
+    { "State", "Mode", "Level", "Name", "Properties", "Status", "Volume", "Address", "Timeout", "Priority" };
+static const char * const Events[] =
+    { "StateChanged", "ModeChanged", "Updated", "Connected", "Disconnected", "Error" };
+static const char * const Templates[] =
+    { "Buffer", "Iterator", "Container", "Queue" };
+static const char * const ParameterTypes[] =
+    { "const uint32", "const uint16", "const uint8", "const bool", "const string &", "uint32 &", "string &", "bool &" };
+static const char * const ReturnTypes[] =
+    { "uint32", "uint32", "uint32", "void", "bool", "string" };
+
+template<size_t Size>
+static unsigned Count(const char * const (&)[Size])
+{
+    return static_cast<unsigned>(Size);
+}
+
+// Interfaces are numbered across the corpus, and each gets two IDs, for itself and for its notification interface
+static const unsigned InterfaceIDBase = 0x00010000;
+
+CorpusGenerator::CorpusGenerator(const CorpusOptions & options)
+    : _options(options)
+{
+}
+
+bool CorpusGenerator::Generate(const std::string & directory, std::vector<std::string> & files) const
+{
+    files.clear();
+    if (!CreateDirectory(directory))
+    {
+        ErrorStream() << "Cannot create corpus directory " << directory << endl;
+        return false;
+    }
+    std::string modulePath = directory + "/Module.h";
+    std::ofstream moduleStream(modulePath);
+    GenerateModule(moduleStream);
+    if (!moduleStream)
+    {
+        ErrorStream() << "Cannot write " << modulePath << endl;
+        return false;
+    }
+    for (unsigned index = 0; index < _options.files; ++index)
+    {
+        std::string path = directory + "/" + FileName(index);
+        std::ofstream stream(path);
+        GenerateFile(index, stream);
+        if (!stream)
+        {
+            ErrorStream() << "Cannot write " << path << endl;
+            return false;
+        }
+        files.push_back(path);
+    }
+    return true;
+}
+
+void CorpusGenerator::GenerateModule(std::ostream & stream)
+{
+    CodeWriter writer(stream);
+    writer.Indent(0) << "#pragma once" << EndLine;
+    writer.Indent(0) << EndLine;
+    writer.Indent(0) << "#define EXTERNAL" << EndLine;
+    writer.Indent(0) << EndLine;
+    writer.Indent(0) << "typedef unsigned long long uint64;" << EndLine;
+    writer.Indent(0) << "typedef unsigned int uint32;" << EndLine;
+    writer.Indent(0) << "typedef unsigned short uint16;" << EndLine;
+    writer.Indent(0) << "typedef unsigned char uint8;" << EndLine;
+    writer.Indent(0) << "class string {" << EndLine;
+    writer.Indent(0) << "};" << EndLine;
+    writer.Indent(0) << EndLine;
+    writer.Indent(0) << "namespace WPEFramework {" << EndLine;
+    writer.Indent(0) << "namespace Core {" << EndLine;
+    writer.Indent(0) << EndLine;
+    writer.Indent(1) << "struct EXTERNAL IUnknown {" << EndLine;
+    writer.Indent(2) << "virtual ~IUnknown() {}" << EndLine;
+    writer.Indent(2) << "virtual void AddRef() const = 0;" << EndLine;
+    writer.Indent(2) << "virtual uint32 Release() const = 0;" << EndLine;
+    writer.Indent(2) << "virtual void * QueryInterface(const uint32 id) = 0;" << EndLine;
+    writer.Indent(1) << "};" << EndLine;
+    writer.Indent(0) << EndLine;
+    writer.Indent(0) << "} // namespace Core" << EndLine;
+    writer.Indent(0) << "} // namespace WPEFramework" << EndLine;
+}
+
+void CorpusGenerator::GenerateFile(unsigned index, std::ostream & stream) const
+{
+    FileState state(_options, index, stream);
+    state.Generate();
+}
+
+std::string CorpusGenerator::FileName(unsigned index)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "Corpus%04u.h", index);
+    return name;
+}
+
+CorpusGenerator::FileState::FileState(const CorpusOptions & options, unsigned index, std::ostream & stream)
+    : _options(options)
+    , _index(index)
+    , _random()
+    , _writer(stream)
+    , _interfaces()
+    , _templates()
+{
+    // The header does not depend on the headers generated before it, so any one header can be generated on its own
+    std::seed_seq sequence { options.seed, index };
+    _random.seed(sequence);
+}
+
+unsigned CorpusGenerator::FileState::Next(unsigned range)
+{
+    return (range == 0) ? 0 : static_cast<unsigned>(_random() % range);
+}
+
+void CorpusGenerator::FileState::Generate()
+{
+    _writer.Indent(0) << "#pragma once" << EndLine;
+    _writer.Indent(0) << EndLine;
+    GenerateIncludes();
+    _writer.Indent(0) << EndLine;
+
+    std::vector<std::string> namespaces { "WPEFramework" };
+    unsigned depth = Next(_options.namespaceDepth + 1);
+    for (unsigned level = 0; level < depth; ++level)
+    {
+        namespaces.push_back(Namespaces[Next(Count(Namespaces))]);
+    }
+    for (auto const & name : namespaces)
+    {
+        _writer.Indent(0) << "namespace " << name << " {" << EndLine;
+    }
+
+    for (unsigned number = 0; number < _options.templatesPerFile; ++number)
+    {
+        _writer.Indent(0) << EndLine;
+        GenerateTemplate(1, _index * _options.templatesPerFile + number);
+    }
+    for (unsigned number = 0; number < _options.interfacesPerFile; ++number)
+    {
+        _writer.Indent(0) << EndLine;
+        GenerateInterface(1, _index * _options.interfacesPerFile + number);
+    }
+
+    _writer.Indent(0) << EndLine;
+    for (auto it = namespaces.rbegin(); it != namespaces.rend(); ++it)
+    {
+        _writer.Indent(0) << "} // namespace " << *it << EndLine;
+    }
+}
+
+void CorpusGenerator::FileState::GenerateIncludes()
+{
+    _writer.Indent(0) << "#include \"Module.h\"" << EndLine;
+    std::set<unsigned> includes;
+    for (unsigned count = 0; count < _options.includesPerFile; ++count)
+    {
+        if (_index > 0)
+            includes.insert(Next(_index));
+    }
+    for (auto include : includes)
+    {
+        _writer.Indent(0) << "#include \"" << CorpusGenerator::FileName(include) << "\"" << EndLine;
+    }
+}
+
+void CorpusGenerator::FileState::GenerateInterface(int indent, unsigned number)
+{
+    std::string name = std::string("I") + Areas[Next(Count(Areas))];
+    name += Nouns[Next(Count(Nouns))] + std::to_string(number);
+    bool hasNotification = Chance(_options.notificationPercentage);
+
+    _writer.Indent(indent) << "struct EXTERNAL " << name << " : virtual public Core::IUnknown {" << EndLine;
+    _writer.Indent(indent + 1) << "enum {" << EndLine;
+    _writer.Indent(indent + 2) << "ID = " << InterfaceID(InterfaceIDBase + 2 * number) << EndLine;
+    _writer.Indent(indent + 1) << "};" << EndLine;
+    if (hasNotification)
+    {
+        _writer.Indent(0) << EndLine;
+        GenerateNotification(indent + 1, InterfaceID(InterfaceIDBase + 2 * number + 1));
+    }
+    _writer.Indent(0) << EndLine;
+    _writer.Indent(indent + 1) << "virtual ~" << name << "() {}" << EndLine;
+    if (hasNotification)
+    {
+        _writer.Indent(indent + 1) << "virtual uint32 Register(INotification * sink) = 0;" << EndLine;
+        _writer.Indent(indent + 1) << "virtual uint32 Unregister(INotification * sink) = 0;" << EndLine;
+    }
+
+    unsigned methods = (_options.methodsPerInterface + 1) / 2 + Next(_options.methodsPerInterface + 1);
+    std::set<std::string> methodNames;
+    for (unsigned method = 0; method < methods; ++method)
+    {
+        std::string methodName = Verbs[Next(Count(Verbs))];
+        methodName += Objects[Next(Count(Objects))];
+        if (!methodNames.insert(methodName).second)
+            methodName += std::to_string(method);
+        GenerateMethod(indent + 1, methodName);
+    }
+    _writer.Indent(indent) << "};" << EndLine;
+    _interfaces.push_back(name);
+}
+
+void CorpusGenerator::FileState::GenerateNotification(int indent, const std::string & id)
+{
+    _writer.Indent(indent) << "struct EXTERNAL INotification : virtual public Core::IUnknown {" << EndLine;
+    _writer.Indent(indent + 1) << "enum {" << EndLine;
+    _writer.Indent(indent + 2) << "ID = " << id << EndLine;
+    _writer.Indent(indent + 1) << "};" << EndLine;
+    _writer.Indent(0) << EndLine;
+    _writer.Indent(indent + 1) << "virtual ~INotification() {}" << EndLine;
+    unsigned events = 1 + Next(3);
+    std::set<std::string> eventNames;
+    for (unsigned event = 0; event < events; ++event)
+    {
+        std::string eventName = Events[Next(Count(Events))];
+        if (!eventNames.insert(eventName).second)
+            eventName += std::to_string(event);
+        _writer.Indent(indent + 1) << "virtual void " << eventName << "(" << ParameterType() << " value) = 0;" << EndLine;
+    }
+    _writer.Indent(indent) << "};" << EndLine;
+}
+
+void CorpusGenerator::FileState::GenerateMethod(int indent, const std::string & name)
+{
+    _writer.Indent(indent) << "virtual " << ReturnType() << " " << name << "(";
+    unsigned parameters = Next(_options.maxParameters + 1);
+    for (unsigned parameter = 0; parameter < parameters; ++parameter)
+    {
+        if (parameter > 0)
+            _writer << ", ";
+        _writer << ParameterType() << " parameter" << std::to_string(parameter);
+    }
+    _writer << ")" << (Chance(25) ? " const" : "") << " = 0;" << EndLine;
+}
+
+void CorpusGenerator::FileState::GenerateTemplate(int indent, unsigned number)
+{
+    std::string name = Templates[Next(Count(Templates))] + std::to_string(number);
+    _writer.Indent(indent) << "template <typename TYPE>" << EndLine;
+    _writer.Indent(indent) << "class " << name << " {" << EndLine;
+    _writer.Indent(indent) << "public:" << EndLine;
+    _writer.Indent(indent + 1) << "TYPE Get(const uint32 index) const;" << EndLine;
+    _writer.Indent(indent + 1) << "void Set(const uint32 index, const TYPE & value);" << EndLine;
+    _writer.Indent(indent + 1) << "uint32 Count() const;" << EndLine;
+    _writer.Indent(indent) << "};" << EndLine;
+    _templates.push_back(name);
+}
+
+std::string CorpusGenerator::FileState::ParameterType()
+{
+    // Some parameters refer to the interfaces and templates declared before them in the header
+    unsigned choice = Next(10);
+    if ((choice == 0) && !_interfaces.empty())
+        return _interfaces[Next(static_cast<unsigned>(_interfaces.size()))] + " *";
+    if ((choice == 1) && !_templates.empty())
+        return "const " + _templates[Next(static_cast<unsigned>(_templates.size()))] + "<uint32> &";
+    return ParameterTypes[Next(Count(ParameterTypes))];
+}
+
+std::string CorpusGenerator::FileState::ReturnType()
+{
+    return ReturnTypes[Next(Count(ReturnTypes))];
+}
+
+std::string CorpusGenerator::FileState::InterfaceID(unsigned id)
+{
+    char text[16];
+    snprintf(text, sizeof(text), "0x%08X", id);
+    return text;
+}
+
+} // namespace CPPParser
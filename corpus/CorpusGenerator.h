@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "include/CodeWriter.h"
+
+namespace CPPParser
+{
+
+// Shape of a synthetic corpus
+struct CorpusOptions
+{
+    CorpusOptions()
+        : seed(1)
+        , files(100)
+        , namespaceDepth(2)
+        , interfacesPerFile(4)
+        , methodsPerInterface(8)
+        , maxParameters(4)
+        , notificationPercentage(50)
+        , templatesPerFile(1)
+        , includesPerFile(2)
+    {}
+
+    unsigned seed;
+    // Number of interface headers, not counting Module.h
+    unsigned files;
+    // Interfaces are declared in WPEFramework and up to this many nested namespaces below it
+    unsigned namespaceDepth;
+    unsigned interfacesPerFile;
+    // Methods per interface vary between half and one and a half times this number
+    unsigned methodsPerInterface;
+    // Methods take between zero and this many parameters
+    unsigned maxParameters;
+    // Share of interfaces with a nested INotification interface
+    unsigned notificationPercentage;
+    unsigned templatesPerFile;
+    // Each header includes up to this many of the headers before it
+    unsigned includesPerFile;
+};
+
+// Generates headers in the style of WPEFramework interfaces: IUnknown derived interfaces with an ID enum, methods
+// taking parameters of varying types and arity, nested notification interfaces, class templates, and includes
+// between the headers. All headers include Module.h, which declares the types they use.
+// The corpus only depends on the options, including the seed, so it is the same on every run and every platform:
+// every header is generated by its own mt19937, whose sequence is fixed by the standard, and the numbers are taken
+// from it directly, as the standard distributions differ between standard libraries. Every number is drawn in a
+// statement of its own, as the order in which the operands of an expression are evaluated is unspecified.
+class CorpusGenerator
+{
+public:
+    explicit CorpusGenerator(const CorpusOptions & options);
+
+    // Writes Module.h and the headers to the directory, which is created if needed, and returns the paths of the
+    // headers written
+    bool Generate(const std::string & directory, std::vector<std::string> & files) const;
+    static void GenerateModule(std::ostream & stream);
+    void GenerateFile(unsigned index, std::ostream & stream) const;
+    static std::string FileName(unsigned index);
+
+private:
+    // State of generating one header
+    class FileState
+    {
+    public:
+        FileState(const CorpusOptions & options, unsigned index, std::ostream & stream);
+
+        void Generate();
+
+    private:
+        const CorpusOptions & _options;
+        unsigned _index;
+        std::mt19937 _random;
+        Utility::CodeWriter _writer;
+        std::vector<std::string> _interfaces;
+        std::vector<std::string> _templates;
+
+        // Returns a number below the range, or 0 for an empty range
+        unsigned Next(unsigned range);
+        bool Chance(unsigned percentage) { return Next(100) < percentage; }
+        void GenerateIncludes();
+        void GenerateInterface(int indent, unsigned number);
+        void GenerateNotification(int indent, const std::string & id);
+        void GenerateMethod(int indent, const std::string & name);
+        void GenerateTemplate(int indent, unsigned number);
+        std::string ParameterType();
+        std::string ReturnType();
+        static std::string InterfaceID(unsigned id);
+    };
+
+    CorpusOptions _options;
+};
+
+} // namespace CPPParser
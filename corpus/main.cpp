@@ -0,0 +1,64 @@
+#include <iostream>
+#include <corpus/CorpusGenerator.h>
+#include <include/Utility.h>
+
+using namespace std;
+
+static void ShowUsage(const char * program)
+{
+    cerr << "Usage " << program << " [--seed=<number>] [--files=<count>] [--namespace-depth=<count>] [--interfaces=<count>] [--methods=<count>] [--max-parameters=<count>] [--notifications=<percentage>] [--templates=<count>] [--includes=<count>] <output directory>" << endl;
+}
+
+int main(int argc, char * argv[])
+{
+    if (argc < 2)
+    {
+        ShowUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    CPPParser::CorpusOptions options;
+    const std::vector<std::pair<std::string, unsigned *>> numberOptions = {
+        { "--seed=", &options.seed },
+        { "--files=", &options.files },
+        { "--namespace-depth=", &options.namespaceDepth },
+        { "--interfaces=", &options.interfacesPerFile },
+        { "--methods=", &options.methodsPerInterface },
+        { "--max-parameters=", &options.maxParameters },
+        { "--notifications=", &options.notificationPercentage },
+        { "--templates=", &options.templatesPerFile },
+        { "--includes=", &options.includesPerFile },
+    };
+    for (int i = 1; i < argc - 1; ++i)
+    {
+        std::string argument = argv[i];
+        bool found = false;
+        for (auto const & option : numberOptions)
+        {
+            if (argument.compare(0, option.first.length(), option.first) == 0)
+            {
+                found = true;
+                if (!Utility::ParseNumber(argument.substr(option.first.length()), *option.second))
+                {
+                    cerr << "Invalid value: " << argument << endl;
+                    ShowUsage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+                break;
+            }
+        }
+        if (!found)
+        {
+            cerr << "Unknown option: " << argument << endl;
+            ShowUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    std::string outputDirectory = argv[argc - 1];
+
+    CPPParser::CorpusGenerator generator(options);
+    std::vector<std::string> files;
+    if (!generator.Generate(outputDirectory, files))
+        return EXIT_FAILURE;
+    cout << "Generated " << files.size() << " headers in " << outputDirectory << endl;
+    return EXIT_SUCCESS;
+}
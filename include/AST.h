@@ -10,6 +10,8 @@
 #include "include/Struct.h"
 #include "include/ClassTemplate.h"
 #include "include/Enum.h"
+#include "include/CursorMap.h"
+#include "include/NodeArena.h"
 #include "include/SymbolStack.h"
 
 using namespace Utility;
@@ -17,18 +19,22 @@ using namespace Utility;
 namespace CPPParser
 {
 
-using TokenLookupMap = std::map<CXCursor, Declaration::Ptr>;
+using TokenLookupMap = CursorMap<Declaration::Ptr>;
+using ScopeStack = SymbolStack<CXCursor, Declaration::Ptr, CursorHash>;
 
-class AST : public Container
+// The arena owner comes first, so the nodes are released before their arena
+class AST : public NodeArenaOwner, public Container
 {
 public:
     AST();
+    AST(const AST &) = default;
+    AST & operator = (const AST & other);
     virtual bool IsValid() const override { return false; }
     void Show(std::ostream & stream, int indent) const;
     void GenerateCode(std::ostream & stream, int indent) const;
 
-    virtual std::string QualifiedDescription() const override { return ""; }
-    virtual std::string QualifiedName() const override { return ""; }
+    virtual std::string BuildQualifiedDescription() const override { return ""; }
+    virtual std::string BuildQualifiedName() const override { return ""; }
     virtual bool TraverseBegin(IASTVisitor & visitor) const override;
     virtual bool TraverseEnd(IASTVisitor & visitor) const override;
     virtual bool Visit(IASTVisitor & visitor) const override;
@@ -52,14 +58,17 @@ public:
     Declaration::Ptr AddFunctionTemplate(CXCursor token, CXCursor parentToken);
     Declaration::Ptr AddClassTemplate(CXCursor token, CXCursor parentToken);
     void AddTemplateTypeParameter(CXCursor token, CXCursor parentToken);
+    void AddInclude(CXCursor token, CXCursor parentToken);
 
     void ShowInfo();
 
+    const TokenLookupMap & LookupMap() const { return _tokenLookupMap; }
+
 private:
-    SymbolStack<CXCursor> _stack;
+    ScopeStack _stack;
     TokenLookupMap _tokenLookupMap;
 
-    void UpdateStack(CXCursor token, CXCursor parentToken);
+    void UpdateStack(CXCursor token, CXCursor parentToken, const Declaration::Ptr & object);
 };
 
 } // namespace CPPParser
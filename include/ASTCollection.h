@@ -3,6 +3,7 @@
 #include <map>
 #include <clang-c/Index.h>
 #include "include/Utility.h"
+#include "include/AST.h"
 #include "include/Container.h"
 #include "include/IASTVisitor.h"
 #include "include/Namespace.h"
@@ -10,6 +11,8 @@
 #include "include/Struct.h"
 #include "include/ClassTemplate.h"
 #include "include/Enum.h"
+#include "include/CursorMap.h"
+#include "include/NodeArena.h"
 #include "include/SymbolStack.h"
 
 using namespace Utility;
@@ -17,28 +20,36 @@ using namespace Utility;
 namespace CPPParser
 {
 
-using TokenLookupMap = std::map<CXCursor, Declaration::Ptr>;
+using TokenLookupMap = CursorMap<Declaration::Ptr>;
+using ScopeStack = SymbolStack<CXCursor, Declaration::Ptr, CursorHash>;
 
-class ASTCollection : public Container
+// The arena owner comes first, so the nodes are released before their arena
+class ASTCollection : public NodeArenaOwner, public Container
 {
 public:
     ASTCollection();
+    ASTCollection(const ASTCollection &) = default;
+    ASTCollection & operator = (const ASTCollection & other);
     virtual bool IsValid() const override { return false; }
     void Show(std::ostream & stream, int indent) const;
     void GenerateCode(std::ostream & stream, int indent) const;
 
-    virtual std::string QualifiedDescription() const override { return ""; }
-    virtual std::string QualifiedName() const override { return ""; }
+    virtual std::string BuildQualifiedDescription() const override { return ""; }
+    virtual std::string BuildQualifiedName() const override { return ""; }
     virtual bool TraverseBegin(IASTVisitor & visitor) const override;
     virtual bool TraverseEnd(IASTVisitor & visitor) const override;
     virtual bool Visit(IASTVisitor & visitor) const override;
 
     Declaration::Ptr Find(CXCursor token) const;
-    bool FindNamespaceByName(Declaration::Ptr parent, const std::string & name, Namespace::Ptr & result);
-    bool FindClassByName(Declaration::Ptr parent, const std::string & name, Class::Ptr & result);
-    bool FindStructByName(Declaration::Ptr parent, const std::string & name, Struct::Ptr & result);
-    bool FindClassTemplateByName(Declaration::Ptr parent, const std::string & name, ClassTemplate::Ptr & result);
-    bool FindEnumByName(Declaration::Ptr parent, const std::string & name, Enum::Ptr & result);
+    bool FindNamespaceByName(const Declaration::Ptr & parent, const std::string & name, Namespace::Ptr & result);
+    bool FindClassByName(const Declaration::Ptr & parent, const std::string & name, Class::Ptr & result);
+    bool FindStructByName(const Declaration::Ptr & parent, const std::string & name, Struct::Ptr & result);
+    bool FindClassTemplateByName(const Declaration::Ptr & parent, const std::string & name, ClassTemplate::Ptr & result);
+    bool FindEnumByName(const Declaration::Ptr & parent, const std::string & name, Enum::Ptr & result);
+
+    // Adds a copy of the declarations in the source ordered tree, merging namespaces, classes, structs and class templates
+    // in the same way as building the collection from the cursors directly would.
+    void Merge(const AST & ast);
 
     void AddToMap(CXCursor token, Declaration::Ptr object);
     Declaration::Ptr AddNamespace(CXCursor token, CXCursor parentToken);
@@ -57,14 +68,22 @@ public:
     Declaration::Ptr AddFunctionTemplate(CXCursor token, CXCursor parentToken);
     Declaration::Ptr AddClassTemplate(CXCursor token, CXCursor parentToken);
     void AddTemplateTypeParameter(CXCursor token, CXCursor parentToken);
+    void AddInclude(CXCursor token, CXCursor parentToken);
 
     void ShowInfo();
 
+    const TokenLookupMap & LookupMap() const { return _tokenLookupMap; }
+
 private:
-    SymbolStack<CXCursor> _stack;
+    using CounterpartMap = std::map<const Element *, Element::Ptr>;
+
+    ScopeStack _stack;
     TokenLookupMap _tokenLookupMap;
 
-    void UpdateStack(CXCursor token, CXCursor parentToken);
+    void UpdateStack(CXCursor token, CXCursor parentToken, const Declaration::Ptr & object);
+    void MergeContents(const Container & source, Container & target, CounterpartMap & counterparts, bool & linksSource);
+    void MergeBaseTypes(const Object & source, Object & target, CounterpartMap & counterparts, bool & linksSource);
+    static Element::Ptr Counterpart(const Element * element, const CounterpartMap & counterparts);
 };
 
 } // namespace CPPParser
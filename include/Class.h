@@ -17,11 +17,11 @@ public:
 
     Class() = delete;
     explicit Class(Element::WeakPtr parent, SourceLocation sourceLocation, std::string name, AccessSpecifier accessSpecifier)
-        : Object(std::move(parent), std::move(sourceLocation), std::move(name), accessSpecifier, AccessSpecifier::Private)
+        : Object(ElementKind::Class, std::move(parent), std::move(sourceLocation), std::move(name), accessSpecifier, AccessSpecifier::Private)
     {}
 
-    virtual std::string QualifiedDescription() const override { return "class " + QualifiedName(); }
-    virtual std::string QualifiedName() const override
+    virtual std::string BuildQualifiedDescription() const override { return "class " + QualifiedName(); }
+    virtual std::string BuildQualifiedName() const override
     {
         std::string result;
         if (Parent() != nullptr)
@@ -17,14 +17,14 @@ public:
 
     ClassTemplate() = delete;
     explicit ClassTemplate(Element::WeakPtr parent, SourceLocation sourceLocation, std::string name, AccessSpecifier accessSpecifier)
-        : Object(std::move(parent), std::move(sourceLocation), std::move(name), accessSpecifier, AccessSpecifier::Private)
+        : Object(ElementKind::ClassTemplate, std::move(parent), std::move(sourceLocation), std::move(name), accessSpecifier, AccessSpecifier::Private)
         , _templateParameters()
     {}
 
     const std::vector<std::string> & TemplateParameters() const { return _templateParameters; }
 
-    virtual std::string QualifiedDescription() const override { return "class " + QualifiedName(); }
-    virtual std::string QualifiedName() const override
+    virtual std::string BuildQualifiedDescription() const override { return "class " + QualifiedName(); }
+    virtual std::string BuildQualifiedName() const override
     {
         std::string result = "template<";
         bool firstTemplateParameter = true;
@@ -68,6 +68,7 @@ public:
     void AddTemplateParameter(std::string name)
     {
         _templateParameters.push_back(std::move(name));
+        ResetQualifiedNames();
     }
 
 private:
@@ -13,6 +13,9 @@
 #include <include/ClassTemplate.h>
 #include <include/Namespace.h>
 #include <include/PreprocessorDirectives.h>
+#include <include/Trace.h>
+#include <include/CodeWriter.h>
+#include <include/Stats.h>
 
 using namespace std;
 
@@ -23,85 +26,92 @@ class CodeGenerator : public IASTVisitor
 {
 public:
     explicit CodeGenerator(std::ostream & stream)
-        : _stream(stream)
+        : _writer(stream)
         , _indent()
     {
     }
+    // Counts the code emitted, including what is still buffered, which the writer writes when it is destroyed
+    virtual ~CodeGenerator()
+    {
+        Stats::CountBytes(_writer.Size());
+    }
 
     virtual bool Enter(const AST &) override
     {
-//        TRACE(__func__, "AST");
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(AST)");
         _indent = 0;
         return true;
     }
     virtual bool Leave(const AST &) override
     {
-//        TRACE(__func__, "AST");
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(AST)");
+        _writer.Flush();
         return true;
     }
 
     virtual bool Enter(const ASTCollection &) override
     {
-//        TRACE("ASTCollection");
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(ASTCollection)");
         _indent = 0;
         return true;
     }
     virtual bool Leave(const ASTCollection &) override
     {
-//        TRACE("ASTCollection");
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(ASTCollection)");
+        _writer.Flush();
         return true;
     }
 
     virtual bool Enter(const Typedef & element) override
     {
-//        TRACE2(__func__, "Typedef", element.Name());
-        _stream << Indent(_indent) << "typedef " << element.Type() << " " << element.Name() << ";" << std::endl;
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(Typedef) : " << element.Name());
+        _writer.Indent(_indent) << "typedef " << element.Type() << " " << element.Name() << ";" << EndLine;
         return true;
     }
     virtual bool Leave(const Typedef & element) override
     {
-//        TRACE2(__func__, "Typedef", element.Name());
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(Typedef) : " << element.Name());
         return true;
     }
 
     virtual bool Enter(const EnumConstant & element) override
     {
-//        TRACE2(__func__, "EnumConstant", element.Name());
-        _stream << Indent(_indent) << element.Name() << " = " << element.Value() << "," << std::endl;
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(EnumConstant) : " << element.Name());
+        _writer.Indent(_indent) << element.Name() << " = " << element.Value() << "," << EndLine;
         return true;
     }
     virtual bool Leave(const EnumConstant & element) override
     {
-//        TRACE2(__func__, "EnumConstant", element.Name());
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(EnumConstant) : " << element.Name());
         return true;
     }
 
     virtual bool Enter(const Enum & element) override
     {
-//        TRACE2(__func__, "Enum", element.Name());
-        _stream << Indent(_indent) << "enum "
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(Enum) : " << element.Name());
+        _writer.Indent(_indent) << "enum "
                 << (element.Name().empty() ? "" : element.Name() + " ");
         if (!element.Type().empty())
         {
-            _stream << ": " << element.Type() << " ";
+            _writer << ": " << element.Type() << " ";
         }
-        _stream << "{" << std::endl;
+        _writer << "{" << EndLine;
         ++_indent;
         return true;
     }
     virtual bool Leave(const Enum & element) override
     {
-//        TRACE2(__func__, "Enum", element.Name());
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(Enum) : " << element.Name());
         --_indent;
-        _stream << Indent(_indent) << "}; // enum "
-                << (element.Name().empty() ? "<anonymous>" : element.Name()) << std::endl;
+        _writer.Indent(_indent) << "}; // enum "
+                << (element.Name().empty() ? "<anonymous>" : element.Name()) << EndLine;
         return true;
     }
 
     bool EnterFunctionBase(const FunctionBase & element)
     {
         // TODO: Move validations to IsValid()
-        bool isObjectMember = (dynamic_pointer_cast<Object>(element.Parent()) != nullptr);
+        bool isObjectMember = (element.Parent() != nullptr) && element.Parent()->IsObject();
         assert(isObjectMember ||
                (!element.IsVirtual() && !element.IsConst() && !element.IsDefault() && !element.IsDeleted() &&
                 !element.IsFinal() && !element.IsOverride() && !element.IsPureVirtual()));
@@ -111,40 +121,40 @@ public:
         if (element.IsDefault() || element.IsDeleted())
             assert(!element.IsVirtual());
         assert(element.IsVirtual() || (!element.IsPureVirtual()));
-        _stream << Indent(_indent);
+        _writer.Indent(_indent);
         if (element.IsInline())
-            _stream << "inline ";
+            _writer << "inline ";
         if (element.IsStatic())
-            _stream << "static ";
+            _writer << "static ";
         if (element.IsVirtual())
-            _stream << "virtual ";
+            _writer << "virtual ";
         if (!element.Type().empty())
-            _stream << element.Type() << " ";
-        _stream << element.Name() << "(";
+            _writer << element.Type() << " ";
+        _writer << element.Name() << "(";
         bool firstParameter = true;
         for (auto const & parameter : element.Parameters())
         {
             if (!firstParameter)
             {
-                _stream << ", ";
+                _writer << ", ";
             }
-            _stream << parameter.Type() << " " << parameter.Name();
+            _writer << parameter.Type() << " " << parameter.Name();
             firstParameter = false;
         }
-        _stream << ")";
+        _writer << ")";
         if (element.IsConst())
-            _stream << " const";
+            _writer << " const";
         if (element.IsOverride())
-            _stream << " override";
+            _writer << " override";
         if (element.IsFinal())
-            _stream << " override";
+            _writer << " override";
         if (element.IsPureVirtual())
-            _stream << " = 0";
+            _writer << " = 0";
         if (element.IsDefault())
-            _stream << " = default";
+            _writer << " = default";
         if (element.IsDeleted())
-            _stream << " = delete";
-        _stream << ";" << std::endl;
+            _writer << " = delete";
+        _writer << ";" << EndLine;
         return true;
     }
     bool LeaveFunctionBase(const FunctionBase & element)
@@ -154,128 +164,128 @@ public:
 
     virtual bool Enter(const Constructor & element) override
     {
-//        TRACE2(__func__, "Constructor", element.Name());
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(Constructor) : " << element.Name());
         return EnterFunctionBase(element);
     }
     virtual bool Leave(const Constructor & element) override
     {
-//        TRACE2(__func__, "Constructor", element.Name());
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(Constructor) : " << element.Name());
         return LeaveFunctionBase(element);
     }
 
     virtual bool Enter(const Destructor & element) override
     {
-//        TRACE2(__func__, "Destructor", element.Name());
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(Destructor) : " << element.Name());
         return EnterFunctionBase(element);
     }
     virtual bool Leave(const Destructor & element) override
     {
-//        TRACE2(__func__, "Destructor", element.Name());
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(Destructor) : " << element.Name());
         return LeaveFunctionBase(element);
     }
 
     virtual bool Enter(const Method & element) override
     {
-//        TRACE2(__func__, "Method", element.Name());
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(Method) : " << element.Name());
         return EnterFunctionBase(element);
     }
     virtual bool Leave(const Method & element) override
     {
-//        TRACE2(__func__, "Method", element.Name());
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(Method) : " << element.Name());
         return LeaveFunctionBase(element);
     }
 
     virtual bool Enter(const Function & element) override
     {
-//        TRACE2(__func__, "Function", element.Name());
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(Function) : " << element.Name());
         return EnterFunctionBase(element);
     }
     virtual bool Leave(const Function & element) override
     {
-//        TRACE2(__func__, "Function", element.Name());
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(Function) : " << element.Name());
         return LeaveFunctionBase(element);
     }
 
     virtual bool Enter(const FunctionTemplate & element) override
     {
-//        TRACE2(__func__, "FunctionTemplate", element.Name());
-        _stream << Indent(_indent);
-        _stream << "template<";
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(FunctionTemplate) : " << element.Name());
+        _writer.Indent(_indent);
+        _writer << "template<";
         bool firstTemplateParameter = true;
         for (auto const & parameter : element.TemplateParameters())
         {
             if (!firstTemplateParameter)
             {
-                _stream << ", ";
+                _writer << ", ";
             }
-            _stream << "class " << parameter;
+            _writer << "class " << parameter;
             firstTemplateParameter = false;
         }
 
-        _stream << "> ";
+        _writer << "> ";
         if (element.IsInline())
-            _stream << "inline ";
+            _writer << "inline ";
         if (element.IsStatic())
-            _stream << "static ";
+            _writer << "static ";
         if (element.IsVirtual())
-            _stream << "virtual ";
+            _writer << "virtual ";
         if (!element.Type().empty())
-            _stream << element.Type() << " ";
-        _stream << element.Name() << "(";
+            _writer << element.Type() << " ";
+        _writer << element.Name() << "(";
         bool firstParameter = true;
         for (auto const & parameter : element.Parameters())
         {
             if (!firstParameter)
             {
-                _stream << ", ";
+                _writer << ", ";
             }
-            _stream << parameter.Type() << " " << parameter.Name();
+            _writer << parameter.Type() << " " << parameter.Name();
             firstParameter = false;
         }
-        _stream << ")";
+        _writer << ")";
         if (element.IsConst())
-            _stream << " const";
+            _writer << " const";
         if (element.IsOverride())
-            _stream << " override";
+            _writer << " override";
         if (element.IsFinal())
-            _stream << " override";
+            _writer << " override";
         if (element.IsPureVirtual())
-            _stream << " = 0";
+            _writer << " = 0";
         if (element.IsDefault())
-            _stream << " = default";
+            _writer << " = default";
         if (element.IsDeleted())
-            _stream << " = delete";
-        _stream << ";" << std::endl;
+            _writer << " = delete";
+        _writer << ";" << EndLine;
         return true;
     }
     virtual bool Leave(const FunctionTemplate & element) override
     {
-//        TRACE2(__func__, "FunctionTemplate", element.Name());
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(FunctionTemplate) : " << element.Name());
         return true;
     }
 
     virtual bool Enter(const Variable & element) override
     {
-//        TRACE2(__func__, "Variable", element.Name());
-        _stream << Indent(_indent) << element.Type() << " " << element.Name() << ";" << endl;
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(Variable) : " << element.Name());
+        _writer.Indent(_indent) << element.Type() << " " << element.Name() << ";" << EndLine;
 
         return true;
     }
     virtual bool Leave(const Variable & element) override
     {
-//        TRACE2(__func__, "Variable", element.Name());
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(Variable) : " << element.Name());
         return true;
     }
 
     virtual bool Enter(const DataMember & element) override
     {
-//        TRACE2(__func__, "DataMember", element.Name());
-        _stream << Indent(_indent) << element.Type() << " " << element.Name() << ";" << endl;
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(DataMember) : " << element.Name());
+        _writer.Indent(_indent) << element.Type() << " " << element.Name() << ";" << EndLine;
         return true;
     }
     virtual bool Leave(const DataMember & element) override
     {
-//        TRACE2(__func__, "DataMember", element.Name());
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(DataMember) : " << element.Name());
         return true;
     }
 
@@ -287,13 +297,13 @@ public:
             for (auto const & inheritance : element.BaseTypes())
             {
                 if (firstBase)
-                    _stream << " : ";
+                    _writer << " : ";
                 else
-                    _stream << ", ";
+                    _writer << ", ";
 
                 if (inheritance->IsVirtual())
-                    _stream << "virtual ";
-                _stream << inheritance->Access() << " " << inheritance->Name();
+                    _writer << "virtual ";
+                _writer << inheritance->Access() << " " << inheritance->Name();
                 firstBase = false;
             }
         }
@@ -301,166 +311,166 @@ public:
 
     virtual bool Enter(const Class & element) override
     {
-//        TRACE2(__func__, "Class", element.Name());
-        _stream << Indent(_indent) << "class " << element.Name();
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(Class) : " << element.Name());
+        _writer.Indent(_indent) << "class " << element.Name();
         ObjectInheritance(element);
-        _stream << " {" << std::endl;
+        _writer << " {" << EndLine;
         ++_indent;
         return true;
     }
     virtual bool Leave(const Class & element) override
     {
-//        TRACE2(__func__, "Class", element.Name());
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(Class) : " << element.Name());
         --_indent;
-        _stream << Indent(_indent) << "}; // class " << element.Name() << std::endl;
+        _writer.Indent(_indent) << "}; // class " << element.Name() << EndLine;
         return true;
     }
 
     virtual bool Enter(const Struct & element) override
     {
-//        TRACE2(__func__, "Struct", element.Name());
-        _stream << Indent(_indent) << "struct " << element.Name();
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(Struct) : " << element.Name());
+        _writer.Indent(_indent) << "struct " << element.Name();
         ObjectInheritance(element);
-        _stream << " {" << std::endl;
+        _writer << " {" << EndLine;
         ++_indent;
         return true;
     }
     virtual bool Leave(const Struct & element) override
     {
-//        TRACE2(__func__, "Struct", element.Name());
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(Struct) : " << element.Name());
         --_indent;
-        _stream << Indent(_indent) << "}; // struct " << element.Name() << std::endl;
+        _writer.Indent(_indent) << "}; // struct " << element.Name() << EndLine;
         return true;
     }
 
     virtual bool Enter(const ClassTemplate & element) override
     {
-//        TRACE2(__func__, "ClassTemplate", element.Name());
-        _stream << Indent(_indent);
-        _stream << "template<";
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(ClassTemplate) : " << element.Name());
+        _writer.Indent(_indent);
+        _writer << "template<";
         bool firstTemplateParameter = true;
         for (auto const & parameter : element.TemplateParameters())
         {
             if (!firstTemplateParameter)
             {
-                _stream << ", ";
+                _writer << ", ";
             }
-            _stream << "class " << parameter;
+            _writer << "class " << parameter;
             firstTemplateParameter = false;
         }
 
-        _stream << "> class " << element.Name();;
+        _writer << "> class " << element.Name();;
         ObjectInheritance(element);
-        _stream << " {" << std::endl;
+        _writer << " {" << EndLine;
         ++_indent;
         return true;
     }
 
     virtual bool Leave(const ClassTemplate & element) override
     {
-//        TRACE2(__func__, "ClassTemplate", element.Name());
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(ClassTemplate) : " << element.Name());
         --_indent;
-        _stream << Indent(_indent) << "}; // class " << element.Name() << std::endl;
+        _writer.Indent(_indent) << "}; // class " << element.Name() << EndLine;
         return true;
     }
 
     virtual bool Enter(const Namespace & element) override
     {
-//        TRACE2(__func__, "Namespace", element.Name());
-        _stream << Indent(_indent) << "namespace " << (element.Name().empty() ? "" : element.Name() + " ") << "{" << endl;
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(Namespace) : " << element.Name());
+        _writer.Indent(_indent) << "namespace " << (element.Name().empty() ? "" : element.Name() + " ") << "{" << EndLine;
         ++_indent;
         return true;
     }
     virtual bool Leave(const Namespace & element) override
     {
-//        TRACE2(__func__, "Namespace", element.Name());
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(Namespace) : " << element.Name());
         --_indent;
-        _stream << Indent(_indent) << "} // namespace " << (element.Name().empty() ? "<anonymous>" : element.Name()) << endl;
+        _writer.Indent(_indent) << "} // namespace " << (element.Name().empty() ? "<anonymous>" : element.Name()) << EndLine;
         return true;
     }
 
     virtual bool Enter(const IncludeDirective & element) override
     {
-//        TRACE(__func__, "Include");
-        _stream << Indent(_indent) << "#include "
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(Include)");
+        _writer.Indent(_indent) << "#include "
                 << (element.IncludeType() == IncludeSpecifier::Local ? '"' : '<')
                 << element.Name()
                 << (element.IncludeType() == IncludeSpecifier::Local ? '"' : '>')
-                << endl;
+                << EndLine;
         return true;
     }
     virtual bool Leave(const IncludeDirective & element) override
     {
-//        TRACE(__func__, "Include");
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(Include)");
         return true;
     }
 
     virtual bool Enter(const IfdefDirective & element) override
     {
-//        TRACE(__func__, "Ifdef");
-        _stream << Indent(_indent) << "Ifdef "
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(Ifdef)");
+        _writer.Indent(_indent) << "Ifdef "
                 << element.Name()
-                << endl;
+                << EndLine;
         ++_indent;
         return true;
     }
     virtual bool Leave(const IfdefDirective & element) override
     {
-//        TRACE(__func__, "Ifdef");
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(Ifdef)");
         --_indent;
-        _stream << Indent(_indent) << "Endif"
-                << endl;
+        _writer.Indent(_indent) << "Endif"
+                << EndLine;
         return true;
     }
 
     virtual bool Enter(const IfDirective & element) override
     {
-//        TRACE(__func__, "If");
-        _stream << Indent(_indent) << "If "
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(If)");
+        _writer.Indent(_indent) << "If "
                 << element.Name()
-                << endl;
+                << EndLine;
         ++_indent;
         return true;
     }
     virtual bool Leave(const IfDirective & element) override
     {
-//        TRACE(__func__, "If");
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(If)");
         --_indent;
-        _stream << Indent(_indent) << "Endif"
-                << endl;
+        _writer.Indent(_indent) << "Endif"
+                << EndLine;
         return true;
     }
 
     virtual bool Enter(const DefineDirective & element) override
     {
-//        TRACE(__func__, "Define");
-        _stream << Indent(_indent) << "Define "
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(Define)");
+        _writer.Indent(_indent) << "Define "
                 << element.Name()
-                << endl;
+                << EndLine;
         return true;
     }
     virtual bool Leave(const DefineDirective & element) override
     {
-//        TRACE(__func__, "Define");
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(Define)");
         return true;
     }
 
     virtual bool Enter(const UndefDirective & element) override
     {
-//        TRACE(__func__, "Undef");
-        _stream << Indent(_indent) << "Undef "
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(Undef)");
+        _writer.Indent(_indent) << "Undef "
                 << element.Name()
-                << endl;
+                << EndLine;
         return true;
     }
     virtual bool Leave(const UndefDirective & element) override
     {
-//        TRACE(__func__, "Undef");
+        TRACE_LOG(TraceCodeGen, TraceLevel::Debug, __func__ << "(Undef)");
         return true;
     }
 
 public:
-    std::ostream & _stream;
+    CodeWriter _writer;
     int _indent;
 };
 
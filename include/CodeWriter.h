@@ -0,0 +1,57 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include "include/InternedString.h"
+#include "include/Utility.h"
+
+namespace Utility
+{
+
+// Buffered writer for generated text. Text is collected in a growing buffer and written to the stream in chunks, so
+// producing a line neither flushes the stream nor allocates. Indentation is copied from a fixed table of spaces.
+// The buffer is written out when it grows beyond the chunk size, at the end of every line that starts at indentation
+// level 0, which completes a top level declaration, on Flush(), and when the writer is destroyed.
+class CodeWriter
+{
+public:
+    static const size_t DefaultChunkSize = 64 * 1024;
+    static const int SpacesPerLevel = 4;
+
+    explicit CodeWriter(std::ostream & stream, size_t chunkSize = DefaultChunkSize);
+    ~CodeWriter();
+    CodeWriter(const CodeWriter &) = delete;
+    CodeWriter & operator = (const CodeWriter &) = delete;
+
+    // Starts a line at the indentation level
+    CodeWriter & Indent(int level);
+    CodeWriter & EndLine();
+    void Flush();
+
+    CodeWriter & operator << (const char * value);
+    CodeWriter & operator << (const std::string & value) { _buffer.append(value); return *this; }
+    CodeWriter & operator << (const InternedString & value) { _buffer.append(value.str()); return *this; }
+    CodeWriter & operator << (char value) { _buffer.push_back(value); return *this; }
+    CodeWriter & operator << (int value) { return *this << static_cast<long long>(value); }
+    CodeWriter & operator << (long long value);
+    CodeWriter & operator << (AccessSpecifier value);
+    CodeWriter & operator << (CodeWriter & (* manipulator)(CodeWriter &)) { return manipulator(*this); }
+
+    // Number of characters written so far, including those still buffered
+    size_t Size() const { return _written + _buffer.size(); }
+
+private:
+    std::ostream & _stream;
+    std::string _buffer;
+    size_t _chunkSize;
+    size_t _written;
+    int _lineLevel;
+};
+
+// Ends the line, in place of std::endl, which would flush the stream
+inline CodeWriter & EndLine(CodeWriter & writer)
+{
+    return writer.EndLine();
+}
+
+} // namespace Utility
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <functional>
+#include <unordered_map>
 #include <clang-c/Index.h>
 #include "include/Declaration.h"
 #include "include/IASTVisitor.h"
@@ -21,8 +23,8 @@ public:
     using List = std::vector<Ptr>;
 
     Container() = delete;
-    explicit Container(Element::WeakPtr parent, SourceLocation sourceLocation, std::string name, AccessSpecifier accessSpecifier)
-        : Declaration(std::move(parent), std::move(sourceLocation), std::move(name), accessSpecifier)
+    explicit Container(ElementKind kind, Element::WeakPtr parent, SourceLocation sourceLocation, std::string name, AccessSpecifier accessSpecifier)
+        : Declaration(kind, std::move(parent), std::move(sourceLocation), std::move(name), accessSpecifier)
         , _contents()
         , _namespaces()
         , _classes()
@@ -33,8 +35,13 @@ public:
         , _typedefs()
         , _variables()
         , _functionTemplates()
+        , _nameIndex()
     {}
+    virtual ~Container();
 
+    virtual void ResetQualifiedNames() override;
+
+    const PtrList<Element> & Contents() const { return _contents; }
     const PtrList<Namespace> & Namespaces() const { return _namespaces; }
     const PtrList<Class> & Classes() const { return _classes; }
     const PtrList<Struct> & Structs() const { return _structs; }
@@ -46,7 +53,10 @@ public:
     const PtrList<FunctionTemplate> & FunctionTemplates() const { return _functionTemplates; }
 
     virtual void Add(const std::shared_ptr<Element> & value);
+    // Approximate size of the index used for lookups by name
+    size_t NameIndexMemorySize() const { return HashTableMemory(_nameIndex); }
 
+    // Lookups by name use an index kept up to date by Add, and return the first element of the kind with the name.
     bool FindNamespace(const std::string & name, std::shared_ptr<Namespace> & result);
     bool FindClass(const std::string & name, std::shared_ptr<Class> & result);
     bool FindStruct(const std::string & name, std::shared_ptr<Struct> & result);
@@ -81,6 +91,30 @@ protected:
     PtrList<FunctionTemplate> _functionTemplates;
 
 private:
+    // Refers to the name held by the element, so keys do not copy names. Keys compare by content, so a lookup needs
+    // neither an interned name nor the string pool.
+    struct NameKey
+    {
+        ElementKind kind;
+        const std::string * name;
+
+        bool operator == (const NameKey & other) const { return (kind == other.kind) && (*name == *other.name); }
+    };
+    struct NameKeyHash
+    {
+        size_t operator () (const NameKey & key) const
+        {
+            return std::hash<std::string>()(*key.name) ^ static_cast<size_t>(key.kind);
+        }
+    };
+
+    // Position of the first element of each kind and name in its typed list
+    std::unordered_map<NameKey, size_t, NameKeyHash> _nameIndex;
+
+    template<class T>
+    void AddElement(PtrList<T> & list, const std::shared_ptr<T> & value);
+    template<class T>
+    bool FindElement(ElementKind kind, const PtrList<T> & list, const std::string & name, std::shared_ptr<T> & result) const;
     void AddNamespace(const std::shared_ptr<Namespace> & value);
     void AddClass(const std::shared_ptr<Class> & value);
     void AddStruct(const std::shared_ptr<Struct> & value);
@@ -92,4 +126,10 @@ private:
     void AddClassTemplate(const std::shared_ptr<ClassTemplate> & value);
 };
 
+// The element as a container, decided by its kind, or nullptr when it is not one
+inline Container * AsContainer(Element * element)
+{
+    return ((element != nullptr) && element->IsContainer()) ? static_cast<Container *>(element) : nullptr;
+}
+
 } // namespace CPPParser
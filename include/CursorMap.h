@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <clang-c/Index.h>
+
+namespace CPPParser
+{
+
+// Map from cursor to value, as an open addressing hash table using clang_hashCursor and clang_equalCursors.
+// Entries are kept in insertion order in a single vector, the table only holds their indices, so a lookup touches
+// one small slot array before comparing a cursor, and an insert does not allocate unless the table grows.
+// Entries cannot be removed, except by clearing the whole map.
+template<typename T>
+class CursorMap
+{
+public:
+    using value_type = std::pair<CXCursor, T>;
+    using const_iterator = typename std::vector<value_type>::const_iterator;
+
+    CursorMap()
+        : _entries()
+        , _hashes()
+        , _slots(InitialSize, EmptySlot)
+        , _shift(32 - InitialBits)
+    {}
+
+    size_t Count() const { return _entries.size(); }
+    bool IsEmpty() const { return _entries.empty(); }
+    const_iterator begin() const { return _entries.begin(); }
+    const_iterator end() const { return _entries.end(); }
+    // Approximate size of the entries and the table, without memory owned by the values
+    size_t MemorySize() const
+    {
+        return _entries.capacity() * sizeof(value_type) + _hashes.capacity() * sizeof(unsigned) +
+               _slots.capacity() * sizeof(uint32_t);
+    }
+
+    // Returns the value for the cursor, or nullptr if it is not in the map.
+    const T * Find(CXCursor cursor) const
+    {
+        size_t slot = FindSlot(cursor, clang_hashCursor(cursor));
+        return (_slots[slot] != EmptySlot) ? &_entries[_slots[slot]].second : nullptr;
+    }
+    T * Find(CXCursor cursor)
+    {
+        size_t slot = FindSlot(cursor, clang_hashCursor(cursor));
+        return (_slots[slot] != EmptySlot) ? &_entries[_slots[slot]].second : nullptr;
+    }
+
+    // Adds the value for the cursor, unless the cursor is already in the map. Returns true if the value was added.
+    bool Insert(CXCursor cursor, T value)
+    {
+        unsigned hash = clang_hashCursor(cursor);
+        size_t slot = FindSlot(cursor, hash);
+        if (_slots[slot] != EmptySlot)
+            return false;
+        // Keep the load factor below one half, so probe sequences stay short
+        if (2 * (_entries.size() + 1) > _slots.size())
+        {
+            Grow();
+            slot = FindSlot(cursor, hash);
+        }
+        _slots[slot] = static_cast<uint32_t>(_entries.size());
+        _entries.emplace_back(cursor, std::move(value));
+        _hashes.push_back(hash);
+        return true;
+    }
+
+    void Clear()
+    {
+        _entries.clear();
+        _hashes.clear();
+        _slots.assign(InitialSize, EmptySlot);
+        _shift = 32 - InitialBits;
+    }
+
+private:
+    static const uint32_t EmptySlot = UINT32_MAX;
+    static const unsigned InitialBits = 4;
+    static const size_t InitialSize = size_t {1} << InitialBits;
+
+    std::vector<value_type> _entries;
+    std::vector<unsigned> _hashes;
+    std::vector<uint32_t> _slots;
+    unsigned _shift;
+
+    size_t HomeSlot(unsigned hash) const
+    {
+        // Fibonacci hashing, as the table index uses the high bits of the product
+        return static_cast<uint32_t>(hash * 2654435769u) >> _shift;
+    }
+
+    // Returns the slot holding the cursor, or the empty slot where it would be inserted.
+    size_t FindSlot(CXCursor cursor, unsigned hash) const
+    {
+        size_t mask = _slots.size() - 1;
+        for (size_t slot = HomeSlot(hash); ; slot = (slot + 1) & mask)
+        {
+            uint32_t index = _slots[slot];
+            if ((index == EmptySlot) ||
+                ((_hashes[index] == hash) && (clang_equalCursors(_entries[index].first, cursor) != 0)))
+                return slot;
+        }
+    }
+
+    void Grow()
+    {
+        _slots.assign(2 * _slots.size(), EmptySlot);
+        --_shift;
+        size_t mask = _slots.size() - 1;
+        for (uint32_t index = 0; index < _entries.size(); ++index)
+        {
+            size_t slot = HomeSlot(_hashes[index]);
+            while (_slots[slot] != EmptySlot)
+                slot = (slot + 1) & mask;
+            _slots[slot] = index;
+        }
+    }
+};
+
+template<typename T>
+const uint32_t CursorMap<T>::EmptySlot;
+template<typename T>
+const unsigned CursorMap<T>::InitialBits;
+template<typename T>
+const size_t CursorMap<T>::InitialSize;
+
+} // namespace CPPParser
@@ -18,8 +18,8 @@ public:
     using Ptr = std::shared_ptr<Declaration>;
 
     Declaration() = delete;
-    explicit Declaration(WeakPtr parent, SourceLocation sourceLocation, std::string name, AccessSpecifier accessSpecifier)
-        : Element(std::move(parent), std::move(sourceLocation), std::move(name), accessSpecifier)
+    explicit Declaration(ElementKind kind, WeakPtr parent, SourceLocation sourceLocation, std::string name, AccessSpecifier accessSpecifier)
+        : Element(kind, std::move(parent), std::move(sourceLocation), std::move(name), accessSpecifier)
     {
     }
     virtual ~Declaration() = default;
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <clang-c/Index.h>
+#include "include/Utility.h"
+#include "include/IDeclarationListener.h"
+#include "include/SymbolStack.h"
+
+namespace CPPParser
+{
+
+// Reports the declarations of a translation unit to a listener as their cursors are visited. Only the declarations
+// enclosing the current cursor are kept, so memory use is bounded by the nesting depth instead of the size of the file.
+// As libclang does not report the end of a cursor's children, a declaration is left when a cursor outside of it is
+// handled, or when the stream is finished.
+class DeclarationStream
+{
+public:
+    DeclarationStream() = delete;
+    explicit DeclarationStream(IDeclarationListener & listener);
+    DeclarationStream(const DeclarationStream &) = delete;
+    DeclarationStream & operator = (const DeclarationStream &) = delete;
+
+    void HandleToken(CXCursor token, CXCursor parentToken);
+    // Leaves all declarations that are still open, to be called at the end of the translation unit
+    void Finish();
+
+    static bool IsDeclarationKind(CXCursorKind kind, ElementKind & elementKind);
+
+private:
+    IDeclarationListener & _listener;
+    SymbolStack<CXCursor, DeclarationEvent, CursorHash> _stack;
+
+    void LeaveScopes(CXCursor parentToken);
+    void LeaveTop(size_t count);
+    void Enter(CXCursor token, ElementKind kind);
+};
+
+} // namespace CPPParser
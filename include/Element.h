@@ -1,9 +1,13 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <memory>
 #include <string>
 #include <clang-c/Index.h>
+#include "include/Stats.h"
 #include "include/Utility.h"
 
 using namespace Utility;
@@ -12,41 +16,195 @@ namespace CPPParser
 {
 
 class IASTVisitor;
+class Element;
+
+// Non owning link from an element to its parent. Parents own their children, so the parent outlives every child
+// still in the tree, and the link does not need the reference counting of a weak_ptr. A child kept after its parent
+// is gone has its link cleared by the parent (see Container and Object), so it never refers to a destroyed parent.
+class ElementLink
+{
+public:
+    ElementLink() : _element() {}
+    ElementLink(std::nullptr_t) : _element() {}
+    ElementLink(Element * element) : _element(element) {}
+    template<typename T>
+    ElementLink(const std::shared_ptr<T> & element) : _element(element.get()) {}
+
+    Element * Get() const { return _element; }
+
+private:
+    Element * _element;
+};
+
+// Concrete type of an element, set at construction, so code that needs to know what an element is can switch on it
+// instead of trying dynamic casts in turn.
+enum class ElementKind : uint8_t
+{
+    AST,
+    ASTCollection,
+    Namespace,
+    Class,
+    Struct,
+    ClassTemplate,
+    Enum,
+    Typedef,
+    Variable,
+    DataMember,
+    Constructor,
+    Destructor,
+    Method,
+    Function,
+    FunctionTemplate,
+    IncludeDirective,
+    IfdefDirective,
+    IfDirective,
+    DefineDirective,
+    UndefDirective,
+};
+
+inline const char * ElementKindName(ElementKind kind)
+{
+    switch (kind)
+    {
+        case ElementKind::AST:              return "AST";
+        case ElementKind::ASTCollection:    return "ASTCollection";
+        case ElementKind::Namespace:        return "Namespace";
+        case ElementKind::Class:            return "Class";
+        case ElementKind::Struct:           return "Struct";
+        case ElementKind::ClassTemplate:    return "ClassTemplate";
+        case ElementKind::Enum:             return "Enum";
+        case ElementKind::Typedef:          return "Typedef";
+        case ElementKind::Variable:         return "Variable";
+        case ElementKind::DataMember:       return "DataMember";
+        case ElementKind::Constructor:      return "Constructor";
+        case ElementKind::Destructor:       return "Destructor";
+        case ElementKind::Method:           return "Method";
+        case ElementKind::Function:         return "Function";
+        case ElementKind::FunctionTemplate: return "FunctionTemplate";
+        case ElementKind::IncludeDirective: return "IncludeDirective";
+        case ElementKind::IfdefDirective:   return "IfdefDirective";
+        case ElementKind::IfDirective:      return "IfDirective";
+        case ElementKind::DefineDirective:  return "DefineDirective";
+        case ElementKind::UndefDirective:   return "UndefDirective";
+    }
+    return "";
+}
 
 class Element
-    : public std::enable_shared_from_this<Element>
 {
 public:
-    using WeakPtr = std::weak_ptr<Element>;
+    using WeakPtr = ElementLink;
     using Ptr = std::shared_ptr<Element>;
 
     Element() = delete;
-    explicit Element(WeakPtr parent, SourceLocation sourceLocation, std::string name, AccessSpecifier accessSpecifier)
+    explicit Element(ElementKind kind, WeakPtr parent, SourceLocation sourceLocation, std::string name,
+                     AccessSpecifier accessSpecifier)
         : _name(std::move(name))
-        , _parent(std::move(parent))
+        , _parent(parent.Get())
+        , _kind(kind)
         , _accessSpecifier(accessSpecifier)
         , _sourceLocation(sourceLocation)
+        , _qualifiedDescription(nullptr)
+        , _qualifiedName(nullptr)
+    {
+        Stats::CountNode(kind);
+    }
+    Element(const Element & other)
+        : _name(other._name)
+        , _parent(other._parent)
+        , _kind(other._kind)
+        , _accessSpecifier(other._accessSpecifier)
+        , _sourceLocation(other._sourceLocation)
+        , _qualifiedDescription(nullptr)
+        , _qualifiedName(nullptr)
+    {
+    }
+    Element & operator = (const Element & other)
     {
+        if (&other != this)
+        {
+            _name = other._name;
+            _parent = other._parent;
+            _kind = other._kind;
+            _accessSpecifier = other._accessSpecifier;
+            _sourceLocation = other._sourceLocation;
+            Element::ResetQualifiedNames();
+        }
+        return *this;
+    }
+    virtual ~Element()
+    {
+        delete _qualifiedDescription.load();
+        delete _qualifiedName.load();
     }
-    virtual ~Element() = default;
 
     const std::string & Name() const { return _name; }
-    Ptr Parent() const { return _parent.lock(); }
+    // The parent, or nullptr when the element has none, or it was destroyed while the element was kept
+    Element * Parent() const { return _parent; }
+    ElementKind Kind() const { return _kind; }
+    // Classes, structs and class templates
+    bool IsObject() const
+    {
+        return (_kind == ElementKind::Class) || (_kind == ElementKind::Struct) || (_kind == ElementKind::ClassTemplate);
+    }
+    // Elements holding other elements: the trees, namespaces, objects and conditional directives
+    bool IsContainer() const
+    {
+        return (_kind == ElementKind::AST) || (_kind == ElementKind::ASTCollection) || (_kind == ElementKind::Namespace) ||
+               IsObject() || (_kind == ElementKind::IfdefDirective) || (_kind == ElementKind::IfDirective);
+    }
     AccessSpecifier Access() const { return _accessSpecifier; }
     const SourceLocation & Location() const { return _sourceLocation; }
 
-    virtual std::string QualifiedDescription() const = 0;
-    virtual std::string QualifiedName() const = 0;
+    // Qualified names are built on first use and kept, so asking for the name of a nested element does not rebuild
+    // the names of all its enclosing scopes again. A finished tree can be visited by several threads at once: a name
+    // built by more than one of them is only kept once, and stays valid until the names are reset.
+    const std::string & QualifiedDescription() const
+    {
+        return Keep(_qualifiedDescription, &Element::BuildQualifiedDescription);
+    }
+    const std::string & QualifiedName() const
+    {
+        return Keep(_qualifiedName, &Element::BuildQualifiedName);
+    }
+    virtual std::string BuildQualifiedDescription() const = 0;
+    virtual std::string BuildQualifiedName() const = 0;
     virtual bool TraverseBegin(IASTVisitor & visitor) const = 0;
     virtual bool TraverseEnd(IASTVisitor & visitor) const = 0;
     virtual bool Visit(IASTVisitor & visitor) const = 0;
     virtual bool IsValid() const { return false; }
 
+    // Called when something the qualified names are built from changes, which resets the names of the element and
+    // of all elements below it. Must not be called while other threads use the names of the tree.
+    virtual void ResetQualifiedNames()
+    {
+        delete _qualifiedDescription.exchange(nullptr);
+        delete _qualifiedName.exchange(nullptr);
+    }
+
 private:
-    std::string _name;
-    WeakPtr _parent;
+    // Clears the parent link of its children when destroyed
+    friend class Container;
+
+    InternedString _name;
+    Element * _parent;
+    ElementKind _kind;
     AccessSpecifier _accessSpecifier;
     SourceLocation _sourceLocation;
+    mutable std::atomic<const std::string *> _qualifiedDescription;
+    mutable std::atomic<const std::string *> _qualifiedName;
+
+    const std::string & Keep(std::atomic<const std::string *> & value, std::string (Element::*build)() const) const
+    {
+        const std::string * result = value.load(std::memory_order_acquire);
+        if (result != nullptr)
+            return *result;
+        std::unique_ptr<const std::string> built(new std::string((this->*build)()));
+        if (value.compare_exchange_strong(result, built.get(), std::memory_order_acq_rel, std::memory_order_acquire))
+            return *built.release();
+        // Another thread kept its name first
+        return *result;
+    }
 };
 
 } // namespace CPPParser
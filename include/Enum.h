@@ -30,7 +30,7 @@ public:
     long long Value() const { return _value; }
 
 private:
-    std::string _name;
+    InternedString _name;
     long long _value;
 };
 
@@ -45,15 +45,15 @@ public:
     Enum() = delete;
     explicit Enum(Element::WeakPtr parent, SourceLocation sourceLocation, std::string name, AccessSpecifier accessSpecifier,
                   std::string type)
-        : Declaration(std::move(parent), std::move(sourceLocation), std::move(name), accessSpecifier)
+        : Declaration(ElementKind::Enum, std::move(parent), std::move(sourceLocation), std::move(name), accessSpecifier)
         , _type(std::move(type))
     {}
 
     const std::string & Type() const { return _type; }
     const EnumConstantList & Values() const { return _values; }
 
-    virtual std::string QualifiedDescription() const override { return "enum " + QualifiedName(); }
-    virtual std::string QualifiedName() const override
+    virtual std::string BuildQualifiedDescription() const override { return "enum " + QualifiedName(); }
+    virtual std::string BuildQualifiedName() const override
     {
         std::string result;
         if (Parent() != nullptr)
@@ -98,7 +98,7 @@ public:
     }
 
 private:
-    std::string _type;
+    InternedString _type;
     std::vector<EnumConstant> _values;
 };
 
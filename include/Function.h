@@ -26,8 +26,8 @@ public:
     const std::string & Type() const { return _type; }
 
 private:
-    std::string _name;
-    std::string _type;
+    InternedString _name;
+    InternedString _type;
 };
 
 using ParameterList = std::vector<Parameter>;
@@ -53,10 +53,10 @@ public:
     using List = std::vector<Ptr>;
 
     FunctionBase() = delete;
-    explicit FunctionBase(Element::WeakPtr parent, SourceLocation sourceLocation, std::string name, AccessSpecifier accessSpecifier,
+    explicit FunctionBase(ElementKind kind, Element::WeakPtr parent, SourceLocation sourceLocation, std::string name, AccessSpecifier accessSpecifier,
                           std::string type, ParameterList parameters,
                           FunctionFlags flags)
-        : Declaration(std::move(parent), std::move(sourceLocation), std::move(name), accessSpecifier)
+        : Declaration(kind, std::move(parent), std::move(sourceLocation), std::move(name), accessSpecifier)
           , _type(std::move(type))
           , _parameters(std::move(parameters))
           , _flags(flags)
@@ -66,6 +66,7 @@ public:
     }
     const std::string & Type() const { return _type; }
     const ParameterList & Parameters() const { return _parameters; }
+    FunctionFlags Flags() const { return _flags; }
     bool IsConst() const { return (_flags & FunctionFlags::Const) != 0; }
     bool IsVirtual() const { return (_flags & FunctionFlags::Virtual) != 0; }
     bool IsOverride() const { return (_flags & FunctionFlags::Override) != 0; }
@@ -79,7 +80,7 @@ public:
     virtual bool Visit(IASTVisitor & visitor) const = 0;
 
 private:
-    std::string _type;
+    InternedString _type;
     ParameterList _parameters;
     FunctionFlags _flags;
 };
@@ -94,13 +95,13 @@ public:
     explicit Constructor(Element::WeakPtr parent, SourceLocation sourceLocation, std::string name, AccessSpecifier accessSpecifier,
                          ParameterList parameters,
                          FunctionFlags flags)
-        : FunctionBase(std::move(parent), std::move(sourceLocation), std::move(name), accessSpecifier,
+        : FunctionBase(ElementKind::Constructor, std::move(parent), std::move(sourceLocation), std::move(name), accessSpecifier,
                    "", std::move(parameters), flags)
     {
     }
 
-    virtual std::string QualifiedDescription() const override { return QualifiedName(); }
-    virtual std::string QualifiedName() const override
+    virtual std::string BuildQualifiedDescription() const override { return QualifiedName(); }
+    virtual std::string BuildQualifiedName() const override
     {
         std::string result;
         if (Parent() != nullptr)
@@ -150,13 +151,13 @@ public:
 
     explicit Destructor(Element::WeakPtr parent, SourceLocation sourceLocation, std::string name, AccessSpecifier accessSpecifier,
                         FunctionFlags flags)
-        : FunctionBase(std::move(parent), std::move(sourceLocation), std::move(name), accessSpecifier,
+        : FunctionBase(ElementKind::Destructor, std::move(parent), std::move(sourceLocation), std::move(name), accessSpecifier,
                    "", ParameterList(), flags)
     {
     }
 
-    virtual std::string QualifiedDescription() const override { return QualifiedName(); }
-    virtual std::string QualifiedName() const override
+    virtual std::string BuildQualifiedDescription() const override { return QualifiedName(); }
+    virtual std::string BuildQualifiedName() const override
     {
         std::string result;
         if (Parent() != nullptr)
@@ -195,13 +196,13 @@ public:
     explicit Method(Element::WeakPtr parent, SourceLocation sourceLocation, std::string name, AccessSpecifier accessSpecifier,
                         std::string type, ParameterList parameters,
                         FunctionFlags flags)
-        : FunctionBase(std::move(parent), std::move(sourceLocation), std::move(name), accessSpecifier,
+        : FunctionBase(ElementKind::Method, std::move(parent), std::move(sourceLocation), std::move(name), accessSpecifier,
                    std::move(type), std::move(parameters), flags)
     {
     }
 
-    virtual std::string QualifiedDescription() const override { return QualifiedName(); }
-    virtual std::string QualifiedName() const override
+    virtual std::string BuildQualifiedDescription() const override { return QualifiedName(); }
+    virtual std::string BuildQualifiedName() const override
     {
         std::string result = Type() + " ";
         if (Parent() != nullptr)
@@ -252,13 +253,13 @@ public:
     explicit Function(Element::WeakPtr parent, SourceLocation sourceLocation, std::string name,
                       std::string type, ParameterList parameters,
                       FunctionFlags flags)
-        : FunctionBase(std::move(parent), std::move(sourceLocation), std::move(name), AccessSpecifier::Invalid,
+        : FunctionBase(ElementKind::Function, std::move(parent), std::move(sourceLocation), std::move(name), AccessSpecifier::Invalid,
                        std::move(type), std::move(parameters), flags)
     {
     }
 
-    virtual std::string QualifiedDescription() const override { return QualifiedName(); }
-    virtual std::string QualifiedName() const override
+    virtual std::string BuildQualifiedDescription() const override { return QualifiedName(); }
+    virtual std::string BuildQualifiedName() const override
     {
         std::string result = Type() + " ";
         if (Parent() != nullptr)
@@ -309,7 +310,7 @@ public:
     explicit FunctionTemplate(Element::WeakPtr parent, SourceLocation sourceLocation, std::string name,
                       std::string type, ParameterList parameters,
                       FunctionFlags flags)
-        : FunctionBase(std::move(parent), std::move(sourceLocation), std::move(name), AccessSpecifier::Invalid,
+        : FunctionBase(ElementKind::FunctionTemplate, std::move(parent), std::move(sourceLocation), std::move(name), AccessSpecifier::Invalid,
                        std::move(type), std::move(parameters), flags)
         , _templateParameters()
     {
@@ -317,8 +318,8 @@ public:
 
     const std::vector<std::string> & TemplateParameters() const { return _templateParameters; }
 
-    virtual std::string QualifiedDescription() const override { return QualifiedName(); }
-    virtual std::string QualifiedName() const override
+    virtual std::string BuildQualifiedDescription() const override { return QualifiedName(); }
+    virtual std::string BuildQualifiedName() const override
     {
         std::string result = "template<";
         bool firstTemplateParameter = true;
@@ -372,6 +373,7 @@ public:
     void AddTemplateParameter(std::string name)
     {
         _templateParameters.push_back(std::move(name));
+        ResetQualifiedNames();
     }
 
 private:
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+#include "include/Utility.h"
+#include "include/Element.h"
+#include "include/Enum.h"
+#include "include/Function.h"
+
+namespace CPPParser
+{
+
+// Data of a declaration as it is parsed, the same as is passed to the nodes created by the Add... methods of the trees.
+// Fields that do not apply to the kind of declaration are left empty.
+struct DeclarationEvent
+{
+    DeclarationEvent()
+        : kind()
+        , sourceLocation()
+        , name()
+        , accessSpecifier()
+        , type()
+        , parameters()
+        , flags()
+    {}
+
+    ElementKind kind;
+    SourceLocation sourceLocation;
+    std::string name;
+    AccessSpecifier accessSpecifier;
+    // Result type of functions, type of variables and data members, underlying type of typedefs and enums
+    std::string type;
+    ParameterList parameters;
+    FunctionFlags flags;
+};
+
+// Receives the declarations of a translation unit while it is parsed, as an alternative to building a tree.
+// Every declaration is entered, followed by the declarations and other items it contains, and then left.
+// Enum values, base classes and template parameters belong to the declaration that was entered last.
+// A namespace that is opened more than once is also entered and left more than once.
+class IDeclarationListener
+{
+public:
+    virtual ~IDeclarationListener() = default;
+
+    virtual void Enter(const DeclarationEvent & declaration) = 0;
+    virtual void Leave(const DeclarationEvent & declaration) = 0;
+
+    virtual void EnumValue(const EnumConstant & value) = 0;
+    virtual void BaseClass(const SourceLocation & sourceLocation, const std::string & name,
+                           AccessSpecifier accessSpecifier, bool isVirtual) = 0;
+    virtual void TemplateParameter(const std::string & name) = 0;
+};
+
+} // namespace CPPParser
@@ -16,30 +16,42 @@ public:
 
     Inheritance() = delete;
     explicit Inheritance(Element::WeakPtr parent, SourceLocation sourceLocation, std::string name, AccessSpecifier accessSpecifier,
-                         Element::WeakPtr base, bool isVirtual)
+                         std::weak_ptr<Element> base, bool isVirtual, std::string baseUSR = {})
         : _name(std::move(name))
-        , _parent(std::move(parent))
+        , _parent(parent.Get())
         , _base(std::move(base))
         , _accessSpecifier(accessSpecifier)
         , _isVirtual(isVirtual)
         , _sourceLocation(sourceLocation)
+        , _baseUSR(std::move(baseUSR))
     {
     }
 
     const std::string & Name() const { return _name; }
-    Element::Ptr Parent() const { return _parent.lock(); }
+    // The object inheriting, or nullptr when it was destroyed while the inheritance was kept
+    Element * Parent() const { return _parent; }
     AccessSpecifier Access() const { return _accessSpecifier; }
     Element::Ptr BaseType() const { return _base.lock(); }
+    // Resolves a base type declared outside the tree, see BaseUSR()
+    void SetBaseType(std::weak_ptr<Element> base) { _base = std::move(base); }
     bool IsVirtual() const { return _isVirtual; }
     const SourceLocation & Location() const { return _sourceLocation; }
+    // USR of the base type, which identifies it even when it is not resolved to a declaration
+    const std::string & BaseUSR() const { return _baseUSR; }
 
 private:
-    std::string _name;
-    Element::WeakPtr _parent;
-    Element::WeakPtr _base;
+    // Clears the parent link of its base types when destroyed
+    friend class Object;
+
+    InternedString _name;
+    Element * _parent;
+    // The base type may be declared in another tree, resolved by a ParserPool after all inputs are parsed, so it is
+    // not owned by the tree holding this inheritance and keeps a weak link. Null while unresolved.
+    std::weak_ptr<Element> _base;
     AccessSpecifier _accessSpecifier;
     bool _isVirtual;
     SourceLocation _sourceLocation;
+    InternedString _baseUSR;
 };
 
 } // namespace CPPParser
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+namespace Utility
+{
+
+// Stores every distinct string once. Strings are released with the pool, which is normally shared by the trees of one
+// run: the arena of every tree built while a pool is current keeps it alive (see CPPParser::NodeArena).
+// The pool is safe for use by multiple threads.
+class StringPool
+{
+public:
+    StringPool();
+    StringPool(const StringPool &) = delete;
+    StringPool & operator = (const StringPool &) = delete;
+
+    // Returns the pooled string equal to the value, adding it if needed
+    const std::string * Intern(const std::string & value);
+    // Returns the pooled string equal to the value, or nullptr if the value is not in the pool
+    const std::string * Find(const std::string & value) const;
+
+    // Number of distinct strings and the number of characters held by the pool
+    size_t Count() const;
+    size_t Size() const;
+
+    // Makes the pool the current one of this thread while it exists, and restores the previous one when destroyed
+    class Scope
+    {
+    public:
+        explicit Scope(std::shared_ptr<StringPool> pool);
+        ~Scope();
+        Scope(const Scope &) = delete;
+        Scope & operator = (const Scope &) = delete;
+
+    private:
+        std::shared_ptr<StringPool> _previous;
+    };
+
+    // The pool of the innermost Scope on this thread, or nullptr outside any scope
+    static const std::shared_ptr<StringPool> & Current();
+    // The pool used outside any scope, which is never released
+    static StringPool & Default();
+
+private:
+    // The pool is split in shards by hash, each with its own lock, so parallel parsers rarely wait for each other.
+    // Elements of an unordered_set never move, so the address of a pooled string remains valid.
+    struct Shard
+    {
+        Shard()
+            : lock()
+            , strings()
+            , size()
+        {}
+        mutable std::mutex lock;
+        std::unordered_set<std::string> strings;
+        size_t size;
+    };
+
+    static const size_t ShardCount = 16;
+    Shard _shards[ShardCount];
+
+    Shard & ShardOf(const std::string & value) { return _shards[std::hash<std::string>()(value) % ShardCount]; }
+    const Shard & ShardOf(const std::string & value) const
+    {
+        return _shards[std::hash<std::string>()(value) % ShardCount];
+    }
+};
+
+// Handle to a string kept in a StringPool. Names, type spellings and file names repeat a lot between declarations,
+// so elements hold these handles instead of their own copies. Strings are interned in the current pool of the thread,
+// or the default pool outside any StringPool::Scope. A handle is valid as long as its pool, so a handle held outside
+// a tree must not outlive the trees built with the pool.
+// Equal strings from the same pool share the same storage, so copying a handle only copies a pointer, and comparing
+// equal handles only compares addresses. Handles from different pools compare by content.
+class InternedString
+{
+public:
+    InternedString();
+    InternedString(const std::string & value);
+    InternedString(const char * value);
+
+    const std::string & str() const { return *_value; }
+    operator const std::string & () const { return *_value; }
+    const char * c_str() const { return _value->c_str(); }
+    bool empty() const { return _value->empty(); }
+    size_t length() const { return _value->length(); }
+
+    bool operator == (const InternedString & other) const { return (_value == other._value) || (*_value == *other._value); }
+    bool operator != (const InternedString & other) const { return !(*this == other); }
+
+    // Sets the result to the string equal to the value in the current pool, without adding the value to the pool.
+    // Returns false if the value is not in the pool.
+    static bool Find(const std::string & value, InternedString & result);
+
+    // Number of distinct strings and the number of characters held by the current pool
+    static size_t PoolCount();
+    static size_t PoolSize();
+
+private:
+    const std::string * _value;
+};
+
+inline bool operator == (const InternedString & lhs, const std::string & rhs) { return lhs.str() == rhs; }
+inline bool operator == (const std::string & lhs, const InternedString & rhs) { return lhs == rhs.str(); }
+inline bool operator != (const InternedString & lhs, const std::string & rhs) { return lhs.str() != rhs; }
+inline bool operator != (const std::string & lhs, const InternedString & rhs) { return lhs != rhs.str(); }
+inline bool operator == (const InternedString & lhs, const char * rhs) { return lhs.str() == rhs; }
+inline bool operator == (const char * lhs, const InternedString & rhs) { return lhs == rhs.str(); }
+inline bool operator != (const InternedString & lhs, const char * rhs) { return lhs.str() != rhs; }
+inline bool operator != (const char * lhs, const InternedString & rhs) { return lhs != rhs.str(); }
+
+inline std::ostream & operator << (std::ostream & stream, const InternedString & value)
+{
+    stream << value.str();
+    return stream;
+}
+
+} // namespace Utility
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <clang-c/Index.h>
+#include "include/CursorMap.h"
+
+namespace CPPParser
+{
+
+enum class ElementKind : uint8_t;
+class Container;
+
+// Number of structures of a kind, and their approximate size in bytes
+struct MemoryCount
+{
+    MemoryCount()
+        : count()
+        , bytes()
+    {}
+    void Add(size_t size)
+    {
+        ++count;
+        bytes += size;
+    }
+    MemoryCount & operator += (const MemoryCount & other)
+    {
+        count += other.count;
+        bytes += other.bytes;
+        return *this;
+    }
+
+    uint64_t count;
+    uint64_t bytes;
+};
+
+// Approximate memory held for an input file, per kind of node and per supporting structure.
+// Sizes are estimated from object sizes and container capacities, without allocator overhead, so they are meant for
+// comparing runs and finding the structures that grow, not as exact figures.
+// Names, types and file names are pooled, so each distinct string is counted once per tree, with the first
+// structure that refers to it.
+struct MemoryUsage
+{
+    MemoryUsage()
+        : nodes()
+        , parameters()
+        , fileNames()
+        , strings()
+        , lookupMaps()
+        , symbols()
+        , translationUnits()
+    {}
+    MemoryUsage & operator += (const MemoryUsage & other);
+
+    // Adds the nodes of the tree, including its root
+    void AddTree(const Container & tree);
+    template<typename T>
+    void AddLookupMap(const CursorMap<T> & map)
+    {
+        lookupMaps.count += map.Count();
+        lookupMaps.bytes += map.MemorySize();
+    }
+    // Adds the memory libclang reports for the translation unit
+    void AddTranslationUnit(CXTranslationUnit unit);
+    const MemoryCount & Nodes(ElementKind kind) const;
+    MemoryCount Total() const;
+
+    // Per ElementKind, the nodes with what they own, apart from the counts below
+    std::vector<MemoryCount> nodes;
+    // Parameters of functions, with the distinct names and types they refer to
+    MemoryCount parameters;
+    // Distinct file names of source locations
+    MemoryCount fileNames;
+    // Distinct names and types of the nodes
+    MemoryCount strings;
+    // Entries of the maps from cursor to declaration, used while building the trees
+    MemoryCount lookupMaps;
+    // Entries of the symbol index of the parser
+    MemoryCount symbols;
+    // Translation units, as reported by clang_getCXTUResourceUsage
+    MemoryCount translationUnits;
+};
+
+} // namespace CPPParser
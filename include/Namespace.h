@@ -18,11 +18,11 @@ public:
 
     Namespace() = delete;
     explicit Namespace(Element::WeakPtr parent, SourceLocation sourceLocation, std::string name)
-        : Container(std::move(parent), std::move(sourceLocation), std::move(name), AccessSpecifier::Invalid)
+        : Container(ElementKind::Namespace, std::move(parent), std::move(sourceLocation), std::move(name), AccessSpecifier::Invalid)
     {}
 
-    virtual std::string QualifiedDescription() const override { return "namespace " + QualifiedName(); }
-    virtual std::string QualifiedName() const override
+    virtual std::string BuildQualifiedDescription() const override { return "namespace " + QualifiedName(); }
+    virtual std::string BuildQualifiedName() const override
     {
         std::string result;
         if (Parent() != nullptr)
@@ -52,4 +52,10 @@ public:
     }
 };
 
+// The element as a namespace, decided by its kind, or nullptr when it is not one
+inline Namespace * AsNamespace(Element * element)
+{
+    return ((element != nullptr) && (element->Kind() == ElementKind::Namespace)) ? static_cast<Namespace *>(element) : nullptr;
+}
+
 } // namespace CPPParser
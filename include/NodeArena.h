@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "include/InternedString.h"
+
+namespace CPPParser
+{
+
+// Bump allocator for the nodes of one tree. Memory is taken from large blocks and only released, all at once, when
+// the arena is destroyed, so creating a node costs a pointer increment instead of a heap allocation.
+// Nodes are allocated together with their shared_ptr control block through NodeAllocator. The allocator only points to
+// the arena, as counting references to it from every node would cost an atomic update each time a node is created or
+// released. The arena is owned by its tree instead (see NodeArenaOwner), so a node, or a weak link to it, is only
+// valid as long as a copy of that tree exists.
+// The arena keeps the string pools the names of its nodes are interned in alive in the same way: the pool current
+// when the arena is created, and the pools added with AddStringPool.
+// An arena must not be used by more than one thread at a time.
+class NodeArena
+{
+public:
+    NodeArena();
+    ~NodeArena();
+    NodeArena(const NodeArena &) = delete;
+    NodeArena & operator = (const NodeArena &) = delete;
+
+    void * Allocate(size_t size, size_t alignment);
+
+    void AddStringPool(const std::shared_ptr<Utility::StringPool> & pool);
+    // Adds the string pools of the other arena, for nodes copied from its tree
+    void AddStringPools(const NodeArena & other);
+
+    size_t BytesAllocated() const { return _bytesAllocated; }
+    size_t BlockCount() const { return _blocks.size(); }
+
+    static const size_t BlockSize = 64 * 1024;
+
+private:
+    std::vector<char *> _blocks;
+    char * _current;
+    char * _end;
+    size_t _bytesAllocated;
+    std::vector<std::shared_ptr<Utility::StringPool>> _stringPools;
+
+    char * AddBlock(size_t size);
+    static char * Align(char * address, size_t alignment);
+};
+
+// Standard allocator taking its memory from a NodeArena. Deallocation does nothing, the memory is released with the
+// arena.
+template<typename T>
+class NodeAllocator
+{
+public:
+    using value_type = T;
+
+    explicit NodeAllocator(NodeArena * arena)
+        : _arena(arena)
+    {}
+    template<typename U>
+    NodeAllocator(const NodeAllocator<U> & other)
+        : _arena(other.Arena())
+    {}
+
+    T * allocate(size_t count)
+    {
+        return static_cast<T *>(_arena->Allocate(count * sizeof(T), alignof(T)));
+    }
+    void deallocate(T *, size_t) {}
+
+    NodeArena * Arena() const { return _arena; }
+
+private:
+    NodeArena * _arena;
+};
+
+template<typename T, typename U>
+bool operator == (const NodeAllocator<T> & lhs, const NodeAllocator<U> & rhs) { return lhs.Arena() == rhs.Arena(); }
+template<typename T, typename U>
+bool operator != (const NodeAllocator<T> & lhs, const NodeAllocator<U> & rhs) { return lhs.Arena() != rhs.Arena(); }
+
+// Creates a node in the arena, with its control block next to it.
+template<typename T, typename ... Args>
+std::shared_ptr<T> MakeNode(const std::shared_ptr<NodeArena> & arena, Args && ... args)
+{
+    return std::allocate_shared<T>(NodeAllocator<T>(arena.get()), std::forward<Args>(args)...);
+}
+
+// Base of the trees, owning the arena their nodes are allocated from. It comes before the other base classes of a tree,
+// so the nodes of the tree are released before its arena.
+// Nodes may keep weak links to nodes of other trees, such as base classes resolved across translation units. The
+// arenas of those trees are linked to this one, and are kept alive with it, as releasing a weak link needs the control
+// block of the node it refers to.
+class NodeArenaOwner
+{
+public:
+    NodeArenaOwner();
+
+    // Arena holding the nodes of this tree
+    const std::shared_ptr<NodeArena> & Arena() const { return _arena; }
+    void LinkArena(const std::shared_ptr<NodeArena> & arena);
+    // Links the arena of the other tree, and the arenas linked to it
+    void LinkArenas(const NodeArenaOwner & other);
+
+protected:
+    std::shared_ptr<NodeArena> _arena;
+    std::vector<std::shared_ptr<NodeArena>> _linkedArenas;
+};
+
+} // namespace CPPParser
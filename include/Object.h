@@ -17,9 +17,9 @@ public:
     using List = std::vector<Ptr>;
 
     Object() = delete;
-    explicit Object(Element::WeakPtr parent, SourceLocation sourceLocation, std::string name, AccessSpecifier accessSpecifier,
+    explicit Object(ElementKind kind, Element::WeakPtr parent, SourceLocation sourceLocation, std::string name, AccessSpecifier accessSpecifier,
                     AccessSpecifier defaultInternalAccessSpecifier)
-        : Container(std::move(parent), std::move(sourceLocation), std::move(name), accessSpecifier)
+        : Container(kind, std::move(parent), std::move(sourceLocation), std::move(name), accessSpecifier)
           , _constructors()
           , _destructors()
           , _methods()
@@ -28,6 +28,7 @@ public:
           , _currentAccessSpecifier(defaultInternalAccessSpecifier)
     {
     }
+    virtual ~Object();
 
     const PtrList<Constructor> & Constructors() const { return _constructors; }
     const PtrList<Destructor> & Destructors() const { return _destructors; }
@@ -62,4 +63,10 @@ private:
     void AddDataMember(const DataMember::Ptr & value);
 };
 
+// The element as an object, decided by its kind, or nullptr when it is not one
+inline Object * AsObject(Element * element)
+{
+    return ((element != nullptr) && element->IsObject()) ? static_cast<Object *>(element) : nullptr;
+}
+
 } // namespace CPPParser
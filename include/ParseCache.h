@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "include/AST.h"
+#include "include/Parser.h"
+#include "include/SymbolIndex.h"
+
+namespace CPPParser
+{
+
+// Persistent cache of parse results, stored as one file per input in a cache directory.
+// An entry is found by the input path, the compiler options and the parse flags, and is only used when the
+// content of the input and of every file it included (directly or indirectly) is unchanged since it was stored.
+// On a hit the declaration tree is read back from the entry, and libclang is not used at all.
+// All members may be called from concurrent parsers.
+class ParseCache
+{
+public:
+    ParseCache() = delete;
+    explicit ParseCache(const std::string & directory);
+
+    const std::string & Directory() const { return _directory; }
+
+    // Returns true and fills ast (which must be empty), the type symbols declared in it and the error output of the
+    // original parse, if there is an up to date entry for the input.
+    bool Load(const std::string & path, const OptionsList & options, ParseFlags flags,
+              AST & ast, SymbolIndex & symbols, std::string & errorOutput);
+    // Stores the result of parsing the input, where files are all files read by the parse, including the input itself.
+    // Only the symbols declared in the tree are stored.
+    bool Store(const std::string & path, const OptionsList & options, ParseFlags flags,
+               const std::vector<std::string> & files, const AST & ast, const SymbolIndex & symbols,
+               const std::string & errorOutput);
+
+    // Writes the tree, and the symbols declared in it if given, in the cache entry format.
+    // Returns false if the tree holds an element that cannot be stored.
+    static bool Serialize(const AST & ast, std::ostream & stream, const SymbolIndex * symbols = nullptr);
+    static bool Deserialize(std::istream & stream, AST & ast, SymbolIndex * symbols = nullptr);
+
+private:
+    std::string _directory;
+    std::mutex _fileHashesLock;
+    // Content hashes of files, computed at most once per run, as most inputs share the same (system) headers.
+    std::map<std::string, uint64_t> _fileHashes;
+
+    std::string EntryPath(const std::string & path, const OptionsList & options, ParseFlags flags) const;
+    bool FileHash(const std::string & path, uint64_t & hash);
+};
+
+} // namespace CPPParser
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include <clang-c/Index.h>
+
+namespace CPPParser
+{
+
+using OptionsList = std::vector<std::string>;
+
+class PrecompiledPrefix;
+
+// Parsing state shared by consecutive parses on one thread, which keeps a single CXIndex alive.
+// When reusing translation units, every unit parsed is kept, with a precompiled preamble, and parsing the same file
+// again with the same options reparses the existing unit, which reuses the preamble instead of processing the included
+// headers again. Otherwise only the unit of the last parse is kept.
+// A context must not be used by more than one thread at a time.
+class ParseContext
+{
+public:
+    explicit ParseContext(bool reuseTranslationUnits = false);
+    ~ParseContext();
+    ParseContext(const ParseContext &) = delete;
+    ParseContext & operator = (const ParseContext &) = delete;
+
+    CXIndex Index() const { return _index; }
+
+    // When set to a valid prefix, files are parsed with its precompiled header. A file that fails to parse with it
+    // is parsed again without. The prefix is not owned, and must outlive the parses using it.
+    void SetPrecompiledPrefix(const PrecompiledPrefix * prefix) { _prefix = prefix; }
+    const PrecompiledPrefix * Prefix() const { return _prefix; }
+
+    // Returns the translation unit for the file, or nullptr on failure. The unit remains owned by the context,
+    // and is valid until it is parsed again or replaced as described above, or the context is destroyed.
+    CXTranslationUnit Parse(const std::string & path, const OptionsList & options, unsigned parseOptions);
+
+    size_t ParseCount() const { return _parseCount; }
+    size_t ReparseCount() const { return _reparseCount; }
+
+private:
+    CXIndex _index;
+    bool _reuseTranslationUnits;
+    const PrecompiledPrefix * _prefix;
+    std::map<std::string, CXTranslationUnit> _units;
+    size_t _parseCount;
+    size_t _reparseCount;
+
+    void DisposeTranslationUnits();
+    CXTranslationUnit ParseUnit(const std::string & path, const OptionsList & options, unsigned parseOptions);
+};
+
+} // namespace CPPParser
@@ -16,44 +16,129 @@
 #include "include/ClassTemplate.h"
 #include "include/AST.h"
 #include "include/ASTCollection.h"
+#include "include/ParseContext.h"
+#include "include/SymbolIndex.h"
+#include "include/CursorMap.h"
 #include "include/SymbolStack.h"
+#include "include/IDeclarationListener.h"
+#include "include/SourceFilter.h"
+#include "include/Stats.h"
 
 namespace CPPParser
 {
 
-using TokenLookupMap = std::map<CXCursor, Declaration::Ptr>;
-using TypeLookupMap = std::map<std::string, Declaration::Ptr>;
+using TokenLookupMap = CursorMap<Declaration::Ptr>;
+using ScopeStack = SymbolStack<CXCursor, Declaration::Ptr, CursorHash>;
+
+class ParseCache;
+class DeclarationStream;
+
+enum ParseFlags : uint16_t
+{
+    NoParseFlags = 0x0000,
+    // Let libclang skip the bodies of function definitions, which never contain declarations we model.
+    SkipFunctionBodies = 0x0001,
+    // Build the merged ASTCollection directly from the cursors, instead of the source ordered AST.
+    // GetAST() then returns an empty tree.
+    ASTCollectionOnly = 0x0002,
+    // Keep translation units alive in the ParseContext, so parsing the same file again reuses its precompiled preamble.
+    ReuseTranslationUnits = 0x0004,
+    // Only report declarations to the listener passed to SetDeclarationListener(), without building a tree.
+    // GetAST() and GetASTCollection() then return empty trees.
+    ListenerOnly = 0x0008,
+    // Skip declarations outside the main file, unless they are in one of the paths passed to SetAllowedPaths().
+    // Base classes declared in skipped files cannot be resolved by the parser. They are kept with their USR and without
+    // a base type, and a ParserPool resolves them against the declarations of its other inputs.
+    MainFileOnly = 0x0010,
+    // Skip declarations from system headers.
+    SkipSystemHeaders = 0x0020,
+    // Let libclang keep a detailed preprocessing record, so preprocessing directives are visited.
+    // Without it, macro definitions and expansions are not recorded at all, which saves time and memory.
+    PreprocessorDirectives = 0x0040,
+};
 
-using OptionsList = std::vector<std::string>;
 class Parser
 {
 public:
     Parser() = delete;
-    explicit Parser(const std::string & path);
+    // When a cache is passed, an up to date result is taken from it instead of parsing, and new results are stored in it.
+    // The cache is not used with ASTCollectionOnly, which builds no AST to store.
+    // Parsers that run one after another on the same thread can share a context, otherwise each parser uses its own.
+    // Names are interned in the string pool current when the parser is created, or otherwise a pool of its own.
+    explicit Parser(const std::string & path, ParseFlags flags = ParseFlags::NoParseFlags, ParseCache * cache = nullptr,
+                    ParseContext * context = nullptr);
+    ~Parser();
+
+    // Declarations are reported to the listener while parsing, in addition to building the tree unless parsing with
+    // ListenerOnly. The cache is not used when a listener is set, as a result taken from it is not parsed.
+    void SetDeclarationListener(IDeclarationListener * listener) { _listener = listener; }
+    // Restricts parsing to the main file and the given files and directories, as with MainFileOnly.
+    // The cache is not used with allowed paths, as they are not part of its key.
+    void SetAllowedPaths(const std::vector<std::string> & paths) { _allowedPaths = paths; }
 
     bool Parse(const OptionsList & options);
+    bool FromCache() const { return _fromCache; }
 
     const AST & GetAST() const { return _ast; }
-    const ASTCollection & GetASTCollection() const { return _astCollection; }
+    // The types declared in the translation unit. Base types are only resolved to declarations in the same translation
+    // unit; those declared elsewhere keep their USR, and are resolved by ParserPool once all its inputs are parsed.
+    const SymbolIndex & Symbols() const { return _symbolIndex; }
+    // Unless parsing with ASTCollectionOnly, the collection is derived from the AST on first use.
+    const ASTCollection & GetASTCollection() const;
 
     void Show(std::ostream & stream);
     void TraverseTree(std::ostream & stream);
 
+    // The CXTranslationUnit_Flags to parse with
+    static unsigned TranslationUnitOptions(ParseFlags flags);
+    static bool IsPrunedKind(CXCursorKind kind);
+    static bool IsLeafKind(CXCursorKind kind);
+    bool Accept(CXCursor token) { return (_sourceFilter == nullptr) || _sourceFilter->Accept(token); }
+    // Statistics of the parse in progress, or nullptr when statistics are not enabled
+    ParseStats * Statistics() const { return _stats.get(); }
     void PrintToken(CXCursor token, CXCursor parentToken);
     void HandleToken(CXCursor token, CXCursor parentToken);
 
 private:
     std::string _path;
+    ParseFlags _flags;
+    ParseCache * _cache;
+    ParseContext * _context;
+    bool _fromCache;
     std::string _fileName;
-    ASTCollection _astCollection;
+    // Names of the trees are interned in this pool, which is released with the trees
+    std::shared_ptr<Utility::StringPool> _strings;
+    mutable ASTCollection _astCollection;
+    mutable bool _astCollectionMerged;
     AST _ast;
     CXCursor _token;
     CXCursor _parentToken;
-    SymbolStack<CXCursor> _traversalStack;
+    ScopeStack _traversalStack;
     TokenLookupMap _tokenLookupMapTraversal;
-    TypeLookupMap _typeLookupMap;
+    SymbolIndex _symbolIndex;
+    IDeclarationListener * _listener;
+    std::unique_ptr<DeclarationStream> _declarationStream;
+    std::vector<std::string> _allowedPaths;
+    std::unique_ptr<SourceFilter> _sourceFilter;
+    std::unique_ptr<ParseStats> _stats;
 
-    void AddToMap(Declaration::Ptr object);
+    bool BuildASTCollection() const { return (_flags & ParseFlags::ASTCollectionOnly) != 0; }
+    bool BuildTree() const { return (_listener == nullptr) || ((_flags & ParseFlags::ListenerOnly) == 0); }
+    bool UseCache() const
+    {
+        return (_cache != nullptr) && !BuildASTCollection() && (_listener == nullptr) && _allowedPaths.empty();
+    }
+    bool UseSourceFilter() const
+    {
+        return ((_flags & (ParseFlags::MainFileOnly | ParseFlags::SkipSystemHeaders)) != 0) || !_allowedPaths.empty();
+    }
+    bool ParseFile(const OptionsList & options);
+    bool ParseTranslationUnit(const OptionsList & options, std::vector<std::string> & files);
+    void AddTime(StatsPhase phase, const StatsTimer & timer);
+    void AddMemoryUsage(MemoryUsage & memory) const;
+    void AddToTree(CXCursor token, CXCursor parentToken, CXCursorKind kind);
+    void AddToMap(CXCursor token, Declaration::Ptr object);
+    Declaration::Ptr FindType(CXType type) const;
     void AddNamespace(CXCursor token, CXCursor parentToken);
     void AddClass(CXCursor token, CXCursor parentToken);
     void AddStruct(CXCursor token, CXCursor parentToken);
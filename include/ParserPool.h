@@ -0,0 +1,64 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "include/AST.h"
+#include "include/ParseContext.h"
+#include "include/Parser.h"
+#include "include/PrecompiledPrefix.h"
+#include "include/SymbolIndex.h"
+
+namespace CPPParser
+{
+
+// Parses a set of input files with a number of worker threads, each running its own Parser.
+// Every worker has a ParseContext (and thus a CXIndex) that is kept for the lifetime of the pool, so with
+// ParseFlags::ReuseTranslationUnits, parsing the same files again reparses them with their precompiled preambles.
+// Inputs are then assigned to the workers in a fixed order, so a file goes to the same worker in every Parse() of the
+// same inputs. Otherwise the workers take the next input when they are done, which balances the load better.
+// The resulting trees, as well as the diagnostic output of each parser, are delivered in input order,
+// so the result is the same as parsing the files one after another.
+class ParserPool
+{
+public:
+    ParserPool() = delete;
+    // A job count of 0 selects the number of hardware threads. The cache, if any, is shared by all parsers.
+    explicit ParserPool(size_t jobs, ParseFlags flags = ParseFlags::NoParseFlags, ParseCache * cache = nullptr);
+
+    size_t Jobs() const { return _jobs; }
+
+    // When set, a precompiled header for the include prefix common to all inputs is built before parsing,
+    // and used by every parser. The prefix is not owned, and must outlive the pool.
+    void SetPrecompiledPrefix(PrecompiledPrefix * prefix) { _prefix = prefix; }
+    // Passed to every parser, see Parser::SetAllowedPaths()
+    void SetAllowedPaths(const std::vector<std::string> & paths) { _allowedPaths = paths; }
+
+    bool Parse(const std::vector<std::string> & inputFiles, const OptionsList & options);
+
+    const std::vector<AST> & GetASTs() const { return _asts; }
+    // The types declared by all inputs of the last Parse(). When more than one input declares a type, the declaration
+    // of the first input is used. After parsing, base types that were not declared in the translation unit of their
+    // input are resolved through this index, so the result does not depend on the order in which the parses finish.
+    const SymbolIndex & Symbols() const { return _symbolIndex; }
+    size_t ReparseCount() const;
+
+private:
+    size_t _jobs;
+    ParseFlags _flags;
+    ParseCache * _cache;
+    PrecompiledPrefix * _prefix;
+    std::vector<std::string> _allowedPaths;
+    std::vector<AST> _asts;
+    SymbolIndex _symbolIndex;
+    // Shared by the parsers of one Parse(), so names are interned once per run
+    std::shared_ptr<Utility::StringPool> _strings;
+    std::vector<std::unique_ptr<ParseContext>> _contexts;
+
+    void CreateContexts(size_t count);
+    bool ParseSerial(const std::vector<std::string> & inputFiles, const OptionsList & options);
+    bool ParseParallel(const std::vector<std::string> & inputFiles, const OptionsList & options);
+    void ResolveBaseTypes();
+};
+
+} // namespace CPPParser
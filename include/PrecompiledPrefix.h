@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "include/ParseContext.h"
+
+namespace CPPParser
+{
+
+// Precompiled header for the include directives that all input files start with, such as the "Module.h" include
+// of every interface header. Inputs are parsed with -include-pch, so the prefix is processed only once.
+// The header is stored in a directory, under a name derived from the prefix and the options, together with the
+// files it was built from and their content hashes. It is rebuilt when any of these files changes.
+class PrecompiledPrefix
+{
+public:
+    // Without a directory, the header is built in a temporary directory that is removed again on destruction.
+    explicit PrecompiledPrefix(const std::string & directory = {});
+    ~PrecompiledPrefix();
+    PrecompiledPrefix(const PrecompiledPrefix &) = delete;
+    PrecompiledPrefix & operator = (const PrecompiledPrefix &) = delete;
+
+    // Determines the common include prefix of the inputs, and builds a precompiled header for it, unless an up to date
+    // one exists. Returns false if there is no common prefix, or the header could not be built.
+    // The header has a detailed preprocessing record only if requested, as inputs parsed with a header that has one
+    // get a record as well.
+    bool Build(const std::vector<std::string> & inputFiles, const OptionsList & options,
+               bool preprocessingRecord = false);
+
+    bool IsValid() const { return !_pchPath.empty(); }
+    const std::string & PCHPath() const { return _pchPath; }
+    // The files read to build the precompiled header, which every input parsed with it depends on.
+    const std::vector<std::string> & Files() const { return _files; }
+
+    // Returns the include directives at the start of the file, before anything but comments, #pragma once and an
+    // include guard. Quoted includes found relative to the file are returned with their absolute path.
+    static std::vector<std::string> IncludePrefix(const std::string & path);
+    static std::vector<std::string> CommonPrefix(const std::vector<std::vector<std::string>> & prefixes);
+
+private:
+    std::string _directory;
+    bool _temporary;
+    std::string _pchPath;
+    std::vector<std::string> _files;
+
+    bool LoadManifest(const std::string & manifestPath);
+    bool SaveManifest(const std::string & manifestPath);
+    bool BuildPCH(const std::string & headerPath, const std::string & pchPath, const OptionsList & options,
+                  bool preprocessingRecord);
+};
+
+} // namespace CPPParser
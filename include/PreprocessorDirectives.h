@@ -20,15 +20,15 @@ public:
 
     IncludeDirective() = delete;
     explicit IncludeDirective(WeakPtr parent, SourceLocation sourceLocation, std::string name, IncludeSpecifier includeSpecifier)
-        : Element(std::move(parent), std::move(sourceLocation), std::move(name), AccessSpecifier::Invalid)
+        : Element(ElementKind::IncludeDirective, std::move(parent), std::move(sourceLocation), std::move(name), AccessSpecifier::Invalid)
         , _includeSpecifier(includeSpecifier)
     {
     }
 
     IncludeSpecifier IncludeType() const { return _includeSpecifier; }
 
-    virtual std::string QualifiedDescription() const override { return "include " + QualifiedName(); }
-    virtual std::string QualifiedName() const override
+    virtual std::string BuildQualifiedDescription() const override { return "include " + QualifiedName(); }
+    virtual std::string BuildQualifiedName() const override
     {
         std::string result;
         if (Parent() != nullptr)
@@ -68,12 +68,12 @@ public:
 
     IfdefDirective() = delete;
     explicit IfdefDirective(WeakPtr parent, SourceLocation sourceLocation, std::string name)
-        : Container(std::move(parent), std::move(sourceLocation), std::move(name), AccessSpecifier::Invalid)
+        : Container(ElementKind::IfdefDirective, std::move(parent), std::move(sourceLocation), std::move(name), AccessSpecifier::Invalid)
     {
     }
 
-    virtual std::string QualifiedDescription() const override { return "ifdef " + QualifiedName(); }
-    virtual std::string QualifiedName() const override
+    virtual std::string BuildQualifiedDescription() const override { return "ifdef " + QualifiedName(); }
+    virtual std::string BuildQualifiedName() const override
     {
         std::string result;
         if (Parent() != nullptr)
@@ -112,12 +112,12 @@ public:
 
     IfDirective() = delete;
     explicit IfDirective(WeakPtr parent, SourceLocation sourceLocation, std::string name)
-        : Container(std::move(parent), std::move(sourceLocation), std::move(name), AccessSpecifier::Invalid)
+        : Container(ElementKind::IfDirective, std::move(parent), std::move(sourceLocation), std::move(name), AccessSpecifier::Invalid)
     {
     }
 
-    virtual std::string QualifiedDescription() const override { return "if " + QualifiedName(); }
-    virtual std::string QualifiedName() const override
+    virtual std::string BuildQualifiedDescription() const override { return "if " + QualifiedName(); }
+    virtual std::string BuildQualifiedName() const override
     {
         std::string result;
         if (Parent() != nullptr)
@@ -156,12 +156,12 @@ public:
 
     DefineDirective() = delete;
     explicit DefineDirective(WeakPtr parent, SourceLocation sourceLocation, std::string name)
-        : Element(std::move(parent), std::move(sourceLocation), std::move(name), AccessSpecifier::Invalid)
+        : Element(ElementKind::DefineDirective, std::move(parent), std::move(sourceLocation), std::move(name), AccessSpecifier::Invalid)
     {
     }
 
-    virtual std::string QualifiedDescription() const override { return "ifdef " + QualifiedName(); }
-    virtual std::string QualifiedName() const override
+    virtual std::string BuildQualifiedDescription() const override { return "ifdef " + QualifiedName(); }
+    virtual std::string BuildQualifiedName() const override
     {
         std::string result;
         if (Parent() != nullptr)
@@ -200,12 +200,12 @@ public:
 
     UndefDirective() = delete;
     explicit UndefDirective(WeakPtr parent, SourceLocation sourceLocation, std::string name)
-        : Element(std::move(parent), std::move(sourceLocation), std::move(name), AccessSpecifier::Invalid)
+        : Element(ElementKind::UndefDirective, std::move(parent), std::move(sourceLocation), std::move(name), AccessSpecifier::Invalid)
     {
     }
 
-    virtual std::string QualifiedDescription() const override { return "ifdef " + QualifiedName(); }
-    virtual std::string QualifiedName() const override
+    virtual std::string BuildQualifiedDescription() const override { return "ifdef " + QualifiedName(); }
+    virtual std::string BuildQualifiedName() const override
     {
         std::string result;
         if (Parent() != nullptr)
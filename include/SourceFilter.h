@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <clang-c/Index.h>
+
+namespace CPPParser
+{
+
+// Selects the cursors to visit by the file they are located in, so declarations from irrelevant headers are skipped
+// together with everything below them. Cursors from the main file are always accepted. When restricted to the main
+// file, only cursors from the allowed paths are accepted besides. The decision for a file is kept, so the path of
+// a file is looked up only once. As files are identified by their CXFile, a filter is used for one translation unit.
+class SourceFilter
+{
+public:
+    SourceFilter() = delete;
+    // An allowed path is either a file, or a directory containing the files that are allowed
+    explicit SourceFilter(bool mainFileOnly, bool skipSystemHeaders, const std::vector<std::string> & allowedPaths);
+    SourceFilter(const SourceFilter &) = delete;
+    SourceFilter & operator = (const SourceFilter &) = delete;
+
+    bool Accept(CXCursor cursor);
+
+    static bool MatchesPath(const std::string & path, const std::vector<std::string> & allowedPaths);
+
+private:
+    bool _mainFileOnly;
+    bool _skipSystemHeaders;
+    std::vector<std::string> _allowedPaths;
+    std::unordered_map<CXFile, bool> _files;
+};
+
+} // namespace CPPParser
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <clang-c/Index.h>
+#include "include/MemoryUsage.h"
+
+namespace CPPParser
+{
+
+enum class ElementKind : uint8_t;
+
+// Phases of generating code for an input file
+enum class StatsPhase : uint8_t
+{
+    // Loading the tree from the parse cache, and storing it
+    Cache,
+    // Parsing the translation unit with libclang
+    Parse,
+    // Visiting the cursors of the translation unit, not counting the time spent in tree building
+    Visit,
+    // Adding the declarations to the trees, and merging the ASTCollection from the AST
+    TreeBuild,
+    // Writing the output
+    Output,
+};
+const size_t StatsPhaseCount = 5;
+
+struct PhaseTime
+{
+    PhaseTime()
+        : wallSeconds()
+        , cpuSeconds()
+    {}
+    PhaseTime & operator += (const PhaseTime & other)
+    {
+        wallSeconds += other.wallSeconds;
+        cpuSeconds += other.cpuSeconds;
+        return *this;
+    }
+    PhaseTime & operator -= (const PhaseTime & other)
+    {
+        wallSeconds -= other.wallSeconds;
+        cpuSeconds -= other.cpuSeconds;
+        return *this;
+    }
+
+    double wallSeconds;
+    // CPU time of the thread doing the work
+    double cpuSeconds;
+};
+
+// Measures the wall and CPU time of the calling thread since construction
+class StatsTimer
+{
+public:
+    StatsTimer();
+    PhaseTime Elapsed() const;
+
+private:
+    std::chrono::steady_clock::time_point _wallStart;
+    double _cpuStart;
+
+    static double ThreadCPUSeconds();
+};
+
+// Statistics of one parse, which the parser collects without locking, and adds to Stats when done
+struct ParseStats
+{
+    ParseStats()
+        : phases()
+        , cursorsVisited()
+        , cursorsHandled()
+        , memory()
+    {}
+    void AddTime(StatsPhase phase, const PhaseTime & time) { phases[static_cast<size_t>(phase)] += time; }
+    static void CountCursor(std::vector<uint64_t> & counts, CXCursorKind kind)
+    {
+        size_t index = static_cast<size_t>(kind);
+        if (index >= counts.size())
+            counts.resize(index + 1);
+        ++counts[index];
+    }
+
+    std::array<PhaseTime, StatsPhaseCount> phases;
+    // Counts per CXCursorKind, of all cursors libclang passed to the visitor, and of those passed on to the trees
+    std::vector<uint64_t> cursorsVisited;
+    std::vector<uint64_t> cursorsHandled;
+    // Memory held for the trees of the parse, and for the translation unit parsed
+    MemoryUsage memory;
+};
+
+// Statistics of a run: the time spent per phase and input file, the cursors visited and handled per kind,
+// the nodes created per kind, the memory held per input file, and the number of bytes of code emitted. Collecting is off by default, and is enabled
+// for the whole run, before any parsing starts. The statistics are safe for use by multiple threads.
+class Stats
+{
+public:
+    static void Enable(bool enable);
+    static bool IsEnabled() { return _enabled; }
+    static void Reset();
+
+    static void Add(const std::string & file, const ParseStats & stats);
+    static void AddTime(const std::string & file, StatsPhase phase, const PhaseTime & time);
+    static void CountNode(ElementKind kind)
+    {
+        if (_enabled)
+            AddNode(kind);
+    }
+    static void CountBytes(size_t count)
+    {
+        if (_enabled)
+            AddBytes(count);
+    }
+
+    static PhaseTime Total(StatsPhase phase);
+    static uint64_t Nodes(ElementKind kind);
+    static uint64_t Bytes();
+    static MemoryUsage Memory(const std::string & file);
+    // Peak resident set size of the process
+    static uint64_t PeakResidentBytes();
+
+    // Writes the statistics as a table, or as a JSON object
+    static void Report(std::ostream & stream);
+    static void ReportJSON(std::ostream & stream);
+
+    static const char * PhaseName(StatsPhase phase);
+
+private:
+    struct FileStats
+    {
+        std::string path;
+        std::array<PhaseTime, StatsPhaseCount> phases;
+        MemoryUsage memory;
+    };
+
+    // Read by every parser thread
+    static std::atomic<bool> _enabled;
+    static std::mutex _lock;
+    static std::vector<FileStats> _files;
+    static std::unordered_map<std::string, size_t> _fileIndex;
+    static std::vector<uint64_t> _cursorsVisited;
+    static std::vector<uint64_t> _cursorsHandled;
+
+    static void AddNode(ElementKind kind);
+    static void AddBytes(size_t count);
+    static FileStats & File(const std::string & path);
+};
+
+} // namespace CPPParser
@@ -17,11 +17,11 @@ public:
 
     Struct() = delete;
     explicit Struct(Element::WeakPtr parent, SourceLocation sourceLocation, std::string name, AccessSpecifier accessSpecifier)
-        : Object(std::move(parent), std::move(sourceLocation), std::move(name), accessSpecifier, AccessSpecifier::Public)
+        : Object(ElementKind::Struct, std::move(parent), std::move(sourceLocation), std::move(name), accessSpecifier, AccessSpecifier::Public)
     {}
 
-    virtual std::string QualifiedDescription() const override { return "struct " + QualifiedName(); }
-    virtual std::string QualifiedName() const override
+    virtual std::string BuildQualifiedDescription() const override { return "struct " + QualifiedName(); }
+    virtual std::string BuildQualifiedName() const override
     {
         std::string result;
         if (Parent() != nullptr)
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <clang-c/Index.h>
+#include "include/Declaration.h"
+
+namespace CPPParser
+{
+
+// Declarations of types, keyed by their unified symbol resolution string (USR), which identifies a symbol the same way
+// in every translation unit. Every parser fills an index with the types of its own translation unit, and a ParserPool
+// merges those of all inputs, so a type declared in a header that was skipped for one input can still be resolved.
+// The index is safe for use by multiple threads.
+class SymbolIndex
+{
+public:
+    SymbolIndex();
+    SymbolIndex(const SymbolIndex &) = delete;
+    SymbolIndex & operator = (const SymbolIndex &) = delete;
+
+    // Adds the declaration, unless the symbol is already in the index. Returns true if the declaration was added.
+    bool Add(const std::string & usr, Declaration::Ptr declaration);
+    // Returns the declaration of the symbol, or nullptr if it is unknown.
+    Declaration::Ptr Find(const std::string & usr) const;
+    // Adds the symbols of the other index that are not in this index yet
+    void Merge(const SymbolIndex & other);
+    // Returns a copy of the symbols, in no particular order
+    std::vector<std::pair<std::string, Declaration::Ptr>> Entries() const;
+    size_t Count() const;
+    // Approximate size of the index, including the USR strings, without the declarations
+    size_t MemorySize() const;
+    void Clear();
+    void Show(std::ostream & stream) const;
+
+    static std::string USR(CXCursor token);
+    // Returns the USR of the declaration of the type, with typedefs resolved, or an empty string for builtin types.
+    static std::string USR(CXType type);
+    // Types are the declarations that can be referred to as base class, typedef target or parameter type.
+    static bool IsTypeKind(CXCursorKind kind);
+
+private:
+    mutable std::mutex _lock;
+    std::unordered_map<std::string, Declaration::Ptr> _symbols;
+};
+
+} // namespace CPPParser
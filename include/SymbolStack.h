@@ -1,34 +1,50 @@
 #pragma once
 
-#include <deque>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include <sys/types.h>
 
 namespace CPPParser
 {
 
-template<typename T>
+// Stack of the scopes enclosing the current symbol, with a value, such as the declaration resolved for the symbol,
+// kept alongside each of them. The depth of every symbol on the stack is kept in a hash table, so finding a symbol
+// takes constant time instead of a scan of the stack.
+template<typename T, typename Value, typename Hash = std::hash<T>>
 class SymbolStack
 {
 public:
     SymbolStack()
         : _stack()
+        , _depths()
     {}
 
-    bool AtTop(T element)
+    bool AtTop(T element) const
     {
         return (_stack.size() >= 1) && (Top() == element);
     }
-    void Push(T element)
+    void Push(T element, Value value = Value())
     {
-        _stack.push_back(element);
+        // A symbol pushed again hides the deeper entry, which is found again once this one is popped
+        auto result = _depths.insert({element, _stack.size()});
+        ssize_t hiddenDepth = -1;
+        if (!result.second)
+        {
+            hiddenDepth = static_cast<ssize_t>(result.first->second);
+            result.first->second = _stack.size();
+        }
+        _stack.push_back({element, std::move(value), hiddenDepth});
     }
-    T Top()
+    T Top() const
     {
-        return _stack.at(_stack.size() - 1);
+        return _stack.at(_stack.size() - 1).element;
     }
     T Pop()
     {
         auto result = Top();
-        _stack.pop_back();
+        RemoveTop();
         return result;
     }
     void RemoveTopElements(size_t count)
@@ -36,26 +52,26 @@ public:
         size_t removeCount = std::min(count, _stack.size());
         for (size_t index = 0; index < removeCount; ++index)
         {
-            _stack.pop_back();
+            RemoveTop();
         }
     }
     ssize_t Find(T element) const
     {
-        // Returns 1 for last element, 2 for one but last, etc., and 0 for not found.
-        for (size_t index = 0; index < _stack.size(); ++index)
-        {
-            auto value = _stack[_stack.size() - index - 1];
-            if (element == value)
-            {
-                return index;
-            }
-        }
-        return -1;
+        // Returns 0 for last element, 1 for one but last, etc., and -1 for not found.
+        auto it = _depths.find(element);
+        if (it == _depths.end())
+            return -1;
+        return static_cast<ssize_t>(_stack.size() - it->second - 1);
     }
     T At(size_t index) const
     {
         // Index is 0 for last element, 1 for one but last, etc.
-        return _stack[_stack.size() - index - 1];
+        return _stack[_stack.size() - index - 1].element;
+    }
+    const Value & ValueAt(size_t index) const
+    {
+        // Index as for At()
+        return _stack[_stack.size() - index - 1].value;
     }
     size_t Count() const
     {
@@ -63,7 +79,25 @@ public:
     }
 
 private:
-    std::deque<T> _stack;
+    struct Entry
+    {
+        T element;
+        Value value;
+        ssize_t hiddenDepth;
+    };
+
+    std::vector<Entry> _stack;
+    std::unordered_map<T, size_t, Hash> _depths;
+
+    void RemoveTop()
+    {
+        const Entry & entry = _stack.back();
+        if (entry.hiddenDepth >= 0)
+            _depths[entry.element] = static_cast<size_t>(entry.hiddenDepth);
+        else
+            _depths.erase(entry.element);
+        _stack.pop_back();
+    }
 };
 
 } // namespace CPPParser
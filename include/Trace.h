@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include "include/Utility.h"
+
+namespace Utility
+{
+
+enum class TraceLevel
+{
+    Off,
+    Error,
+    Info,
+    Debug,
+};
+
+enum TraceCategory : uint16_t
+{
+    TraceNone = 0x0000,
+    TraceCursor = 0x0001,
+    TraceTreeBuild = 0x0002,
+    TraceCodeGen = 0x0004,
+    TraceCache = 0x0008,
+    TraceAll = 0x000F,
+};
+
+// Runtime selection of trace output. Settings are global, and should be made before any parsing starts.
+class Trace
+{
+public:
+    static void Enable(TraceCategory categories, TraceLevel level);
+    static void Disable();
+    // Parses a specification like "cursor,tree-build:info". Categories are cursor, tree-build, codegen, cache and all,
+    // levels are error, info and debug (the default).
+    static bool Configure(const std::string & specification);
+
+    static bool IsEnabled(TraceCategory category, TraceLevel level)
+    {
+        return ((_categories & category) != 0) && (level <= _level);
+    }
+
+private:
+    // Read by every parser thread
+    static std::atomic<TraceCategory> _categories;
+    static std::atomic<TraceLevel> _level;
+};
+
+} // namespace Utility
+
+// The message is only evaluated when tracing is enabled for the category and level, so a disabled trace costs one test.
+// Building with PSGENERATOR_NO_TRACE removes all trace statements.
+#if defined(PSGENERATOR_NO_TRACE)
+#define TRACE_ENABLED(category, level) false
+#else
+#define TRACE_ENABLED(category, level) ::Utility::Trace::IsEnabled(category, level)
+#endif
+
+#define TRACE_LOG(category, level, message) \
+    do \
+    { \
+        if (TRACE_ENABLED(category, level)) \
+            ::Utility::LogStream() << message << std::endl; \
+    } while (false)
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace CPPParser
+{
+
+// Timeline of the work done in a run, written in the Chrome trace event format, so it can be opened in a trace viewer
+// such as Perfetto or chrome://tracing. Every span is tagged with the input file it worked on and the thread that did
+// the work. Recording is off by default, and is enabled for the whole run, before any parsing starts.
+// Spans can be recorded by multiple threads.
+class TraceEvents
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static void Enable(bool enable);
+    static bool IsEnabled() { return _enabled; }
+    static void Reset();
+
+    // Names the calling thread in the timeline
+    static void SetThreadName(const std::string & name);
+    static void AddSpan(const char * name, const std::string & file, Clock::time_point start, Clock::time_point end);
+    static size_t Count();
+    static void Write(std::ostream & stream);
+
+private:
+    struct Event
+    {
+        const char * name;
+        std::string file;
+        unsigned threadId;
+        Clock::time_point start;
+        Clock::time_point end;
+    };
+
+    // Read by every parser thread
+    static std::atomic<bool> _enabled;
+    static std::mutex _lock;
+    static Clock::time_point _origin;
+    static std::vector<Event> _events;
+    static std::vector<std::pair<unsigned, std::string>> _threadNames;
+
+    static unsigned ThreadId();
+};
+
+// Records a span from construction to destruction, when trace events are enabled.
+// The file name is referenced, not copied, so it must outlive the span.
+class TraceSpan
+{
+public:
+    TraceSpan(const char * name, const std::string & file)
+        : _name(name)
+        , _file(file)
+        , _start()
+    {
+        if (TraceEvents::IsEnabled())
+            _start = TraceEvents::Clock::now();
+    }
+    explicit TraceSpan(const char * name)
+        : TraceSpan(name, NoFile())
+    {}
+    ~TraceSpan()
+    {
+        if (TraceEvents::IsEnabled())
+            TraceEvents::AddSpan(_name, _file, _start, TraceEvents::Clock::now());
+    }
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan & operator = (const TraceSpan &) = delete;
+
+private:
+    const char * _name;
+    const std::string & _file;
+    TraceEvents::Clock::time_point _start;
+
+    static const std::string & NoFile()
+    {
+        static const std::string noFile;
+        return noFile;
+    }
+};
+
+} // namespace CPPParser
@@ -12,6 +12,8 @@
 #include <include/ClassTemplate.h>
 #include <include/Namespace.h>
 #include <include/PreprocessorDirectives.h>
+#include <include/CodeWriter.h>
+#include <include/Stats.h>
 
 using namespace std;
 
@@ -22,38 +24,43 @@ class TreeInfo : public IASTVisitor
 {
 public:
     explicit TreeInfo(std::ostream & stream)
-        : _stream(stream)
+        : _writer(stream)
         , _indent()
         , _namespaceNesting()
     {
     }
+    // Counted as emitted output, the same way as the code of a CodeGenerator
+    virtual ~TreeInfo()
+    {
+        Stats::CountBytes(_writer.Size());
+    }
 
     bool ParentIsObject(const Declaration & element)
     {
-        return (dynamic_pointer_cast<Object>(element.Parent()) != nullptr);
+        return (element.Parent() != nullptr) && element.Parent()->IsObject();
     }
 
     bool ParentIsNamespace(const Declaration &element)
     {
-        return (dynamic_pointer_cast<Namespace>(element.Parent()) != nullptr);
+        return (element.Parent() != nullptr) && (element.Parent()->Kind() == ElementKind::Namespace);
     }
 
     void EnterGlobalNamespace()
     {
-        _stream << Indent(_indent) << "Namespace <global>" << endl;
+        _writer.Indent(_indent) << "Namespace <global>" << EndLine;
         ++_indent;
     }
     void LeaveGlobalNamespace()
     {
         --_indent;
-        _stream << Indent(_indent) << "Namespace end <global>" << endl;
+        _writer.Indent(_indent) << "Namespace end <global>" << EndLine;
     }
 
     virtual bool Enter(const AST &) override
     {
         _namespaceNesting = 0;
         _indent = 0;
-        _stream << Indent(_indent) << "AST begin" << endl;
+        _writer.Indent(_indent) << "AST begin" << EndLine;
         ++_indent;
         EnterGlobalNamespace();
         return true;
@@ -62,7 +69,8 @@ public:
     {
         LeaveGlobalNamespace();
         --_indent;
-        _stream << Indent(_indent) << "AST end" << endl;
+        _writer.Indent(_indent) << "AST end" << EndLine;
+        _writer.Flush();
         return true;
     }
 
@@ -70,7 +78,7 @@ public:
     {
         _namespaceNesting = 0;
         _indent = 0;
-        _stream << Indent(_indent) << "ASTCollection begin" << endl;
+        _writer.Indent(_indent) << "ASTCollection begin" << EndLine;
         ++_indent;
         EnterGlobalNamespace();
         return true;
@@ -79,13 +87,14 @@ public:
     {
         LeaveGlobalNamespace();
         --_indent;
-        _stream << Indent(_indent) << "ASTCollection end" << endl;
+        _writer.Indent(_indent) << "ASTCollection end" << EndLine;
+        _writer.Flush();
         return true;
     }
 
     virtual bool Enter(const Typedef & element) override
     {
-        _stream << Indent(_indent) << "Typedef " << element.Name() << ": " << element.Type() << endl;
+        _writer.Indent(_indent) << "Typedef " << element.Name() << ": " << element.Type() << EndLine;
         return true;
     }
     virtual bool Leave(const Typedef & element) override
@@ -95,7 +104,7 @@ public:
 
     virtual bool Enter(const EnumConstant & element) override
     {
-        _stream << Indent(_indent) << "EnumConstant " << element.Name() << " = " << element.Value() << endl;
+        _writer.Indent(_indent) << "EnumConstant " << element.Name() << " = " << element.Value() << EndLine;
         return true;
     }
     virtual bool Leave(const EnumConstant & element) override
@@ -105,66 +114,66 @@ public:
 
     virtual bool Enter(const Enum & element) override
     {
-        _stream << Indent(_indent) << "Enum " << (element.Name().empty() ? "<anonymous>" : element.Name());
+        _writer.Indent(_indent) << "Enum " << (element.Name().empty() ? "<anonymous>" : element.Name());
         if (element.Type().empty())
         {
-            _stream << ": <default base>";
+            _writer << ": <default base>";
         }
         else
         {
-            _stream << ": " << element.Type();
+            _writer << ": " << element.Type();
         }
-        _stream << endl;
+        _writer << EndLine;
         ++_indent;
         return true;
     }
     virtual bool Leave(const Enum & element) override
     {
         --_indent;
-        _stream << Indent(_indent) << "Enum end " << (element.Name().empty() ? "<anonymous>" : element.Name()) << endl;
+        _writer.Indent(_indent) << "Enum end " << (element.Name().empty() ? "<anonymous>" : element.Name()) << EndLine;
         return true;
     }
 
     bool EnterFunctionBase(const FunctionBase & element)
     {
-        _stream << element.Name() << ": " << element.Type() << endl;
-        _stream << Indent(_indent + 1) << "Qualifiers:";
+        _writer << element.Name() << ": " << element.Type() << EndLine;
+        _writer.Indent(_indent + 1) << "Qualifiers:";
         if (element.IsInline())
-            _stream << " inline";
+            _writer << " inline";
         if (element.IsStatic())
-            _stream << " static";
+            _writer << " static";
         if (element.IsVirtual())
-            _stream << " virtual";
+            _writer << " virtual";
         if (element.IsConst())
-            _stream << " const";
+            _writer << " const";
         if (element.IsOverride())
-            _stream << " override";
+            _writer << " override";
         if (element.IsFinal())
-            _stream << " final";
+            _writer << " final";
         if (element.IsPureVirtual())
-            _stream << " purevirtual";
+            _writer << " purevirtual";
         if (element.IsDefault())
-            _stream << " default";
+            _writer << " default";
         if (element.IsDeleted())
-            _stream << " delete";
-        _stream << endl;
-        _stream << Indent(_indent + 1) << "Parameters:" << endl;
+            _writer << " delete";
+        _writer << EndLine;
+        _writer.Indent(_indent + 1) << "Parameters:" << EndLine;
 
         for (auto const & parameter : element.Parameters())
         {
-            _stream << Indent(_indent + 2) << parameter.Name() << ": " << parameter.Type() << endl;
+            _writer.Indent(_indent + 2) << parameter.Name() << ": " << parameter.Type() << EndLine;
         }
         return true;
     }
     bool LeaveFunctionBase(const FunctionBase & element)
     {
-        _stream << element.Name() << endl;
+        _writer << element.Name() << EndLine;
         return true;
     }
 
     virtual bool Enter(const Constructor & element) override
     {
-        _stream << Indent(_indent) << "Constructor ";
+        _writer.Indent(_indent) << "Constructor ";
         EnterFunctionBase(element);
         ++_indent;
         return true;
@@ -172,14 +181,14 @@ public:
     virtual bool Leave(const Constructor & element) override
     {
         --_indent;
-        _stream << Indent(_indent) << "Constructor end ";
+        _writer.Indent(_indent) << "Constructor end ";
         LeaveFunctionBase(element);
         return true;
     }
 
     virtual bool Enter(const Destructor & element) override
     {
-        _stream << Indent(_indent) << "Destructor ";
+        _writer.Indent(_indent) << "Destructor ";
         EnterFunctionBase(element);
         ++_indent;
         return true;
@@ -187,14 +196,14 @@ public:
     virtual bool Leave(const Destructor & element) override
     {
         --_indent;
-        _stream << Indent(_indent) << "Destructor end ";
+        _writer.Indent(_indent) << "Destructor end ";
         LeaveFunctionBase(element);
         return true;
     }
 
     virtual bool Enter(const Method & element) override
     {
-        _stream << Indent(_indent) << "Method ";
+        _writer.Indent(_indent) << "Method ";
         EnterFunctionBase(element);
         ++_indent;
         return true;
@@ -202,14 +211,14 @@ public:
     virtual bool Leave(const Method & element) override
     {
         --_indent;
-        _stream << Indent(_indent) << "Method end ";
+        _writer.Indent(_indent) << "Method end ";
         LeaveFunctionBase(element);
         return true;
     }
 
     virtual bool Enter(const Function & element) override
     {
-        _stream << Indent(_indent) << "Function ";
+        _writer.Indent(_indent) << "Function ";
         EnterFunctionBase(element);
         ++_indent;
         return true;
@@ -217,44 +226,44 @@ public:
     virtual bool Leave(const Function & element) override
     {
         --_indent;
-        _stream << Indent(_indent) << "Function end ";
+        _writer.Indent(_indent) << "Function end ";
         LeaveFunctionBase(element);
         return true;
     }
 
     virtual bool Enter(const FunctionTemplate & element) override
     {
-        _stream << Indent(_indent) << "FunctionTemplate ";
-        _stream << element.Name() << ": " << element.Type() << endl;
-        _stream << Indent(_indent + 1) << "Template parameters:" << endl;
+        _writer.Indent(_indent) << "FunctionTemplate ";
+        _writer << element.Name() << ": " << element.Type() << EndLine;
+        _writer.Indent(_indent + 1) << "Template parameters:" << EndLine;
         for (auto const & parameter : element.TemplateParameters())
         {
-            _stream << Indent(_indent + 2) << parameter << endl;
+            _writer.Indent(_indent + 2) << parameter << EndLine;
         }
-        _stream << Indent(_indent + 1) << "Qualifiers:";
+        _writer.Indent(_indent + 1) << "Qualifiers:";
         if (element.IsInline())
-            _stream << " inline";
+            _writer << " inline";
         if (element.IsStatic())
-            _stream << " static";
+            _writer << " static";
         if (element.IsVirtual())
-            _stream << " virtual";
+            _writer << " virtual";
         if (element.IsConst())
-            _stream << " const";
+            _writer << " const";
         if (element.IsOverride())
-            _stream << " override";
+            _writer << " override";
         if (element.IsFinal())
-            _stream << " final";
+            _writer << " final";
         if (element.IsPureVirtual())
-            _stream << " purevirtual";
+            _writer << " purevirtual";
         if (element.IsDefault())
-            _stream << " default";
+            _writer << " default";
         if (element.IsDeleted())
-            _stream << " delete";
-        _stream << endl;
-        _stream << Indent(_indent + 1) << "Parameters:" << endl;
+            _writer << " delete";
+        _writer << EndLine;
+        _writer.Indent(_indent + 1) << "Parameters:" << EndLine;
         for (auto const & parameter : element.Parameters())
         {
-            _stream << Indent(_indent + 2) << parameter.Name() << ": " << parameter.Type() << endl;
+            _writer.Indent(_indent + 2) << parameter.Name() << ": " << parameter.Type() << EndLine;
         }
         ++_indent;
         return true;
@@ -262,14 +271,14 @@ public:
     virtual bool Leave(const FunctionTemplate & element) override
     {
         --_indent;
-        _stream << Indent(_indent) << "FunctionTemplate end ";
-        _stream << element.Name() << endl;
+        _writer.Indent(_indent) << "FunctionTemplate end ";
+        _writer << element.Name() << EndLine;
         return true;
     }
 
     virtual bool Enter(const Variable & element) override
     {
-        _stream << Indent(_indent) << "Variable " << element.Name() << ": " << element.Type() << endl;
+        _writer.Indent(_indent) << "Variable " << element.Name() << ": " << element.Type() << EndLine;
         return true;
     }
     virtual bool Leave(const Variable & element) override
@@ -279,7 +288,7 @@ public:
 
     virtual bool Enter(const DataMember & element) override
     {
-        _stream << Indent(_indent) << "Member variable " << element.Name() << ": " << element.Type() << endl;
+        _writer.Indent(_indent) << "Member variable " << element.Name() << ": " << element.Type() << EndLine;
         return true;
     }
     virtual bool Leave(const DataMember & element) override
@@ -291,20 +300,20 @@ public:
     {
         if (!element.BaseTypes().empty())
         {
-            _stream << Indent(_indent + 1) << "Inheritance: " << endl;
+            _writer.Indent(_indent + 1) << "Inheritance: " << EndLine;
             for (auto const & inheritance : element.BaseTypes())
             {
-                _stream << Indent(_indent + 2) << inheritance->Name() << ": " << inheritance->Access();
+                _writer.Indent(_indent + 2) << inheritance->Name() << ": " << inheritance->Access();
                 if (inheritance->IsVirtual())
-                    _stream << " virtual";
-                _stream << endl;
+                    _writer << " virtual";
+                _writer << EndLine;
             }
         }
     }
 
     virtual bool Enter(const Class & element) override
     {
-        _stream << Indent(_indent) << "Class " << element.Name() << endl;
+        _writer.Indent(_indent) << "Class " << element.Name() << EndLine;
         ObjectInheritance(element);
         ++_indent;
         return true;
@@ -312,13 +321,13 @@ public:
     virtual bool Leave(const Class & element) override
     {
         --_indent;
-        _stream << Indent(_indent) << "Class end " << element.Name() << endl;
+        _writer.Indent(_indent) << "Class end " << element.Name() << EndLine;
         return true;
     }
 
     virtual bool Enter(const Struct & element) override
     {
-        _stream << Indent(_indent) << "Struct " << element.Name() << endl;
+        _writer.Indent(_indent) << "Struct " << element.Name() << EndLine;
         ObjectInheritance(element);
         ++_indent;
         return true;
@@ -326,18 +335,18 @@ public:
     virtual bool Leave(const Struct & element) override
     {
         --_indent;
-        _stream << Indent(_indent) << "Struct end " << element.Name() << endl;
+        _writer.Indent(_indent) << "Struct end " << element.Name() << EndLine;
         return true;
     }
 
     virtual bool Enter(const ClassTemplate & element) override
     {
-        _stream << Indent(_indent) << "ClassTemplate " << element.Name() << endl;
+        _writer.Indent(_indent) << "ClassTemplate " << element.Name() << EndLine;
         ObjectInheritance(element);
-        _stream << Indent(_indent + 1) << "Template parameters:" << endl;
+        _writer.Indent(_indent + 1) << "Template parameters:" << EndLine;
         for (auto const & parameter : element.TemplateParameters())
         {
-            _stream << Indent(_indent + 2) << parameter << endl;
+            _writer.Indent(_indent + 2) << parameter << EndLine;
         }
         ++_indent;
         return true;
@@ -345,7 +354,7 @@ public:
     virtual bool Leave(const ClassTemplate & element) override
     {
         --_indent;
-        _stream << Indent(_indent) << "ClassTemplate end " << element.Name() << endl;
+        _writer.Indent(_indent) << "ClassTemplate end " << element.Name() << EndLine;
         return true;
     }
 
@@ -354,7 +363,7 @@ public:
         if (_namespaceNesting == 0)
             LeaveGlobalNamespace();
         ++_namespaceNesting;
-        _stream << Indent(_indent) << "Namespace " << (element.Name().empty() ? "<anonymous>" : element.Name()) << endl;
+        _writer.Indent(_indent) << "Namespace " << (element.Name().empty() ? "<anonymous>" : element.Name()) << EndLine;
         ++_indent;
         return true;
     }
@@ -362,7 +371,7 @@ public:
     {
         --_namespaceNesting;
         --_indent;
-        _stream << Indent(_indent) << "Namespace end " << (element.Name().empty() ? "<anonymous>" : element.Name()) << endl;
+        _writer.Indent(_indent) << "Namespace end " << (element.Name().empty() ? "<anonymous>" : element.Name()) << EndLine;
         if (_namespaceNesting == 0)
             EnterGlobalNamespace();
         return true;
@@ -370,11 +379,11 @@ public:
 
     virtual bool Enter(const IncludeDirective & element) override
     {
-        _stream << Indent(_indent) << "Include "
+        _writer.Indent(_indent) << "Include "
                 << (element.IncludeType() == IncludeSpecifier::Local ? '"' : '<')
                 << element.Name()
                 << (element.IncludeType() == IncludeSpecifier::Local ? '"' : '>')
-                << endl;
+                << EndLine;
         return true;
     }
     virtual bool Leave(const IncludeDirective & element) override
@@ -384,41 +393,41 @@ public:
 
     virtual bool Enter(const IfdefDirective & element) override
     {
-        _stream << Indent(_indent) << "Ifdef "
+        _writer.Indent(_indent) << "Ifdef "
                 << element.Name()
-                << endl;
+                << EndLine;
         ++_indent;
         return true;
     }
     virtual bool Leave(const IfdefDirective & element) override
     {
         --_indent;
-        _stream << Indent(_indent) << "Endif"
-                << endl;
+        _writer.Indent(_indent) << "Endif"
+                << EndLine;
         return true;
     }
 
     virtual bool Enter(const IfDirective & element) override
     {
-        _stream << Indent(_indent) << "If "
+        _writer.Indent(_indent) << "If "
                 << element.Name()
-                << endl;
+                << EndLine;
         ++_indent;
         return true;
     }
     virtual bool Leave(const IfDirective & element) override
     {
         --_indent;
-        _stream << Indent(_indent) << "Endif"
-                << endl;
+        _writer.Indent(_indent) << "Endif"
+                << EndLine;
         return true;
     }
 
     virtual bool Enter(const DefineDirective & element) override
     {
-        _stream << Indent(_indent) << "Define "
+        _writer.Indent(_indent) << "Define "
                 << element.Name()
-                << endl;
+                << EndLine;
         return true;
     }
     virtual bool Leave(const DefineDirective & element) override
@@ -428,9 +437,9 @@ public:
 
     virtual bool Enter(const UndefDirective & element) override
     {
-        _stream << Indent(_indent) << "Undef "
+        _writer.Indent(_indent) << "Undef "
                 << element.Name()
-                << endl;
+                << EndLine;
         return true;
     }
     virtual bool Leave(const UndefDirective & element) override
@@ -439,7 +448,7 @@ public:
     }
 
 public:
-    std::ostream & _stream;
+    CodeWriter _writer;
     int _indent;
     int _namespaceNesting;
 };
@@ -18,15 +18,15 @@ public:
     Typedef() = delete;
     explicit Typedef(Element::WeakPtr parent, SourceLocation sourceLocation, std::string name, AccessSpecifier accessSpecifier,
                      std::string type)
-        : Declaration(std::move(parent), std::move(sourceLocation), std::move(name), accessSpecifier)
+        : Declaration(ElementKind::Typedef, std::move(parent), std::move(sourceLocation), std::move(name), accessSpecifier)
         , _type(std::move(type))
     {
     }
 
     const std::string & Type() const { return _type; }
 
-    virtual std::string QualifiedDescription() const override { return "typedef " + QualifiedName(); }
-    virtual std::string QualifiedName() const override
+    virtual std::string BuildQualifiedDescription() const override { return "typedef " + QualifiedName(); }
+    virtual std::string BuildQualifiedName() const override
     {
         std::string result = Type() + " ";
         if (Parent() != nullptr)
@@ -55,7 +55,7 @@ public:
     }
 
 private:
-    std::string _type;
+    InternedString _type;
 };
 
 } // namespace CPPParser
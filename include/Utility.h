@@ -1,26 +1,12 @@
 #pragma once
 
+#include <cstdint>
 #include <cstring>
 #include <iostream>
 #include <string>
 #include <vector>
 #include <clang-c/Index.h>
-
-inline void TRACE(const std::string & function, const std::string & text)
-{
-    std::cerr << function << "(" << text << ")" << std::endl;
-}
-
-inline void TRACE2(const std::string & function, const std::string & text, const std::string & name)
-{
-    std::cerr << function << "(" << text << ") : " << name << std::endl;
-}
-
-inline std::ostream & operator << (std::ostream & stream, const CXString & str)
-{
-    stream << clang_getCString(str);
-    return stream;
-}
+#include "include/InternedString.h"
 
 inline bool operator ==(const CXCursor lhs, const CXCursor rhs)
 {
@@ -34,6 +20,11 @@ inline bool operator <(const CXCursor lhs, const CXCursor rhs)
 {
     return memcmp(&lhs, &rhs, sizeof(CXCursor)) < 0;
 }
+// Hash for unordered containers of cursors, equal for cursors that compare equal
+struct CursorHash
+{
+    size_t operator () (const CXCursor cursor) const { return clang_hashCursor(cursor); }
+};
 
 inline bool operator ==(const CXType lhs, const CXType rhs)
 {
@@ -99,22 +90,106 @@ inline std::ostream & operator << (std::ostream & stream, IncludeSpecifier speci
     return stream;
 }
 
+// Inclusion directives with the file name in angle brackets are system includes, the others are local
+inline IncludeSpecifier ConvertIncludeSpecifier(CXCursor token)
+{
+    CXTranslationUnit unit = clang_Cursor_getTranslationUnit(token);
+    CXToken * tokens = nullptr;
+    unsigned count = 0;
+    clang_tokenize(unit, clang_getCursorExtent(token), &tokens, &count);
+    IncludeSpecifier result = IncludeSpecifier::Local;
+    for (unsigned index = 0; index < count; ++index)
+    {
+        if (clang_getTokenKind(tokens[index]) != CXToken_Punctuation)
+            continue;
+        CXString spelling = clang_getTokenSpelling(unit, tokens[index]);
+        bool angled = (std::strcmp(clang_getCString(spelling), "<") == 0);
+        clang_disposeString(spelling);
+        if (angled)
+        {
+            result = IncludeSpecifier::System;
+            break;
+        }
+    }
+    clang_disposeTokens(unit, tokens, count);
+    return result;
+}
+
 namespace Utility
 {
 
-inline std::string ConvertString(const CXString & str)
+// Owns a string returned by libclang, and disposes of it when going out of scope.
+class ClangString
 {
-    return clang_getCString(str);
+public:
+    explicit ClangString(CXString str)
+        : _str(str)
+    {}
+    ~ClangString()
+    {
+        clang_disposeString(_str);
+    }
+    ClangString(const ClangString &) = delete;
+    ClangString & operator = (const ClangString &) = delete;
+
+    const char * c_str() const
+    {
+        const char * result = clang_getCString(_str);
+        return (result != nullptr) ? result : "";
+    }
+    std::string str() const { return c_str(); }
+
+private:
+    CXString _str;
+};
+
+inline std::ostream & operator << (std::ostream & stream, const ClangString & str)
+{
+    stream << str.c_str();
+    return stream;
 }
 
-inline std::string Indent(int indent)
+// Takes ownership of the string, so it must not be used afterwards.
+inline std::string ConvertString(CXString str)
 {
-    return std::string(4 * ((indent < 0) ? 0 : indent), ' ');
+    return ClangString(str).str();
 }
 
+// Diagnostic output of the parser goes through these streams, which default to std::cout and std::cerr.
+// They are per thread, so concurrent parsers can each collect their own output and emit it in a fixed order.
+std::ostream & LogStream();
+std::ostream & ErrorStream();
+void SetLogStream(std::ostream & stream);
+void SetErrorStream(std::ostream & stream);
+void ResetLogStreams();
+
 std::string Trim(const std::string & input);
 void Split(const std::string & input, char delimiter, std::vector<std::string> & output);
 void SplitPath(const std::string & path, std::string & directory, std::string & fileName, std::string & extension);
+// Reads a decimal number, rejecting anything else instead of throwing as std::stoul does
+bool ParseNumber(const std::string & text, unsigned & value);
+// Returns the absolute path without symbolic links, or the path itself if it does not exist.
+std::string RealPath(const std::string & path);
+bool CreateDirectory(const std::string & path);
+
+// 64 bit FNV-1a hashing, for content addressed files. Strings are hashed including their terminator,
+// so that hashing "-DA", "B" gives a different result than hashing "-DAB".
+const uint64_t HashOffsetBasis = 14695981039346656037ULL;
+uint64_t Hash(uint64_t hash, const char * data, size_t size);
+uint64_t Hash(uint64_t hash, const std::string & value);
+bool HashFile(const std::string & path, uint64_t & hash);
+std::string HexString(uint64_t value);
+// Returns the value as a quoted JSON string
+std::string JSONString(const std::string & value);
+// Size of the string object together with the characters it allocated, if they do not fit inside the object
+size_t StringMemory(const std::string & value);
+// Approximate size of the nodes and buckets of an unordered map or set, without memory owned by its values.
+// Each node holds a value, the link to the next node and the cached hash.
+template<typename Map>
+size_t HashTableMemory(const Map & map)
+{
+    return map.size() * (sizeof(typename Map::value_type) + 2 * sizeof(void *)) + map.bucket_count() * sizeof(void *);
+}
 
 struct SourceLocation
 {
@@ -133,9 +208,9 @@ struct SourceLocation
         CXSourceLocation location = clang_getCursorLocation(token);
         CXFile file;
         clang_getSpellingLocation(location, &file, &line, &column, &fileOffset);
-        fileName = ConvertString(clang_getFileName(file));
+        fileName = ClangString(clang_getFileName(file)).c_str();
     }
-    std::string fileName;
+    InternedString fileName;
     unsigned line;
     unsigned column;
     unsigned fileOffset;
@@ -145,6 +220,7 @@ inline std::ostream & operator << (std::ostream & stream, const SourceLocation &
 {
     stream << location.fileName << ":" << location.line << ":" << location.column
            << "-" << location.fileOffset << std::endl;
+    return stream;
 }
 
 } // namespace Utility
\ No newline at end of file
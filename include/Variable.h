@@ -16,9 +16,9 @@ public:
     using List = std::vector<Ptr>;
 
     VariableBase() = delete;
-    explicit VariableBase(Element::WeakPtr parent, SourceLocation sourceLocation, std::string name, AccessSpecifier accessSpecifier,
+    explicit VariableBase(ElementKind kind, Element::WeakPtr parent, SourceLocation sourceLocation, std::string name, AccessSpecifier accessSpecifier,
                           std::string type)
-        : Declaration(std::move(parent), std::move(sourceLocation), std::move(name), accessSpecifier)
+        : Declaration(kind, std::move(parent), std::move(sourceLocation), std::move(name), accessSpecifier)
         , _type(std::move(type))
     {
     }
@@ -26,7 +26,7 @@ public:
     const std::string & Type() const { return _type; }
 
 private:
-    std::string _type;
+    InternedString _type;
 };
 
 class Variable : public VariableBase
@@ -38,12 +38,12 @@ public:
     Variable() = delete;
     explicit Variable(Element::WeakPtr parent, SourceLocation sourceLocation, std::string name, AccessSpecifier accessSpecifier,
                       std::string type)
-        : VariableBase(std::move(parent), std::move(sourceLocation), std::move(name), accessSpecifier, std::move(type))
+        : VariableBase(ElementKind::Variable, std::move(parent), std::move(sourceLocation), std::move(name), accessSpecifier, std::move(type))
     {
     }
 
-    virtual std::string QualifiedDescription() const override { return QualifiedName(); }
-    virtual std::string QualifiedName() const override
+    virtual std::string BuildQualifiedDescription() const override { return QualifiedName(); }
+    virtual std::string BuildQualifiedName() const override
     {
         std::string result = Type() + " ";
         if (Parent() != nullptr)
@@ -81,12 +81,12 @@ public:
     DataMember() = delete;
     explicit DataMember(Element::WeakPtr parent, SourceLocation sourceLocation, std::string name, AccessSpecifier accessSpecifier,
                         std::string type)
-        : VariableBase(std::move(parent), std::move(sourceLocation), std::move(name), accessSpecifier, std::move(type))
+        : VariableBase(ElementKind::DataMember, std::move(parent), std::move(sourceLocation), std::move(name), accessSpecifier, std::move(type))
     {
     }
 
-    virtual std::string QualifiedDescription() const override { return QualifiedName(); }
-    virtual std::string QualifiedName() const override
+    virtual std::string BuildQualifiedDescription() const override { return QualifiedName(); }
+    virtual std::string BuildQualifiedName() const override
     {
         std::string result = Type() + " ";
         if (Parent() != nullptr)
@@ -1,37 +1,168 @@
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <limits>
 #include <include/Parser.h>
+#include <include/ParseCache.h>
+#include <include/ParserPool.h>
+#include <include/PrecompiledPrefix.h>
+#include <include/Stats.h>
+#include <include/Trace.h>
+#include <include/TraceEvents.h>
 
 using namespace std;
 
+static void ShowUsage(const char * program)
+{
+    cerr << "Usage " << program << " [--jobs <count>] [--skip-function-bodies] [--main-file-only] [--skip-system-headers] [--allow-path <path>] [--preprocessor-directives] [--cache <directory>] [--shared-pch] [--trace=<category>,...[:<level>]] [--stats[=<json file>]] [--trace-events=<json file>] <input file> ... <output file>" << endl;
+}
+
+// Reads a positive decimal number, rejecting anything else instead of throwing as std::stoul does
+static bool ParseCount(const std::string & text, size_t & value)
+{
+    if (text.empty() || (text.find_first_not_of("0123456789") != std::string::npos))
+        return false;
+    errno = 0;
+    unsigned long long result = std::strtoull(text.c_str(), nullptr, 10);
+    if ((errno == ERANGE) || (result == 0) || (result > std::numeric_limits<size_t>::max()))
+        return false;
+    value = static_cast<size_t>(result);
+    return true;
+}
+
 int main(int argc, char * argv[])
 {
     if (argc < 3)
     {
-        cerr << "Usage " << argv[0] << " <input file> ... <output file>" << endl;
+        ShowUsage(argv[0]);
         return EXIT_FAILURE;
     }
     CPPParser::OptionsList options = { "-x", "c++" };
     std::vector<std::string> inputFiles;
+    std::vector<std::string> allowedPaths;
+    size_t jobs = 1;
+    std::string cacheDirectory;
+    bool sharedPCH = false;
+    bool stats = false;
+    std::string statsFile;
+    std::string traceEventsFile;
+    CPPParser::ParseFlags flags = CPPParser::ParseFlags::NoParseFlags;
+    const std::string optionJobs = "--jobs";
+    const std::string optionSkipFunctionBodies = "--skip-function-bodies";
+    const std::string optionMainFileOnly = "--main-file-only";
+    const std::string optionSkipSystemHeaders = "--skip-system-headers";
+    const std::string optionAllowPath = "--allow-path";
+    const std::string optionPreprocessorDirectives = "--preprocessor-directives";
+    const std::string optionCache = "--cache";
+    const std::string optionSharedPCH = "--shared-pch";
+    const std::string optionTrace = "--trace=";
+    const std::string optionStats = "--stats";
+    const std::string optionTraceEvents = "--trace-events=";
     for (int i = 1; i < argc - 1; ++i)
     {
-        if (argv[i][0] == '-')
+        std::string argument = argv[i];
+        if ((argument == optionJobs) || (argument.compare(0, optionJobs.length() + 1, optionJobs + "=") == 0))
+        {
+            std::string value;
+            if (argument != optionJobs)
+                value = argument.substr(optionJobs.length() + 1);
+            else if (i + 1 < argc - 1)
+                value = argv[++i];
+            if (!ParseCount(value, jobs))
+            {
+                cerr << "Invalid job count: " << argument << ((argument == optionJobs) ? " " + value : "") << endl;
+                ShowUsage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if ((argument == optionCache) && (i + 1 < argc - 1))
+            cacheDirectory = argv[++i];
+        else if (argument.compare(0, optionCache.length() + 1, optionCache + "=") == 0)
+            cacheDirectory = argument.substr(optionCache.length() + 1);
+        else if (argument == optionSharedPCH)
+            sharedPCH = true;
+        else if (argument == optionSkipFunctionBodies)
+            flags = static_cast<CPPParser::ParseFlags>(flags | CPPParser::ParseFlags::SkipFunctionBodies);
+        else if (argument == optionMainFileOnly)
+            flags = static_cast<CPPParser::ParseFlags>(flags | CPPParser::ParseFlags::MainFileOnly);
+        else if (argument == optionSkipSystemHeaders)
+            flags = static_cast<CPPParser::ParseFlags>(flags | CPPParser::ParseFlags::SkipSystemHeaders);
+        else if (argument == optionPreprocessorDirectives)
+            flags = static_cast<CPPParser::ParseFlags>(flags | CPPParser::ParseFlags::PreprocessorDirectives);
+        else if ((argument == optionAllowPath) && (i + 1 < argc - 1))
+            allowedPaths.emplace_back(argv[++i]);
+        else if (argument.compare(0, optionAllowPath.length() + 1, optionAllowPath + "=") == 0)
+            allowedPaths.emplace_back(argument.substr(optionAllowPath.length() + 1));
+        else if (argument.compare(0, optionTraceEvents.length(), optionTraceEvents) == 0)
+            traceEventsFile = argument.substr(optionTraceEvents.length());
+        else if (argument.compare(0, optionTrace.length(), optionTrace) == 0)
+        {
+            if (!Utility::Trace::Configure(argument.substr(optionTrace.length())))
+            {
+                cerr << "Invalid trace specification: " << argument << endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if (argument == optionStats)
+            stats = true;
+        else if (argument.compare(0, optionStats.length() + 1, optionStats + "=") == 0)
+        {
+            stats = true;
+            statsFile = argument.substr(optionStats.length() + 1);
+        }
+        else if (argv[i][0] == '-')
             options.emplace_back(argv[i]);
         else
             inputFiles.emplace_back(argv[i]);
     }
     std::string outputFile = argv[argc - 1];
-    std::vector<CPPParser::AST> symbolTrees;
-    for (auto const & inputFile : inputFiles)
+    CPPParser::Stats::Enable(stats);
+    CPPParser::TraceEvents::Enable(!traceEventsFile.empty());
+    CPPParser::TraceEvents::SetThreadName("main");
+    std::unique_ptr<CPPParser::ParseCache> cache;
+    if (!cacheDirectory.empty())
+        cache.reset(new CPPParser::ParseCache(cacheDirectory));
+    // The precompiled header is kept with the cache, so later runs can use it as well. Without a cache it is built
+    // in a temporary directory on every run, which only pays off for many inputs including the same large headers.
+    std::unique_ptr<CPPParser::PrecompiledPrefix> prefix;
+    if (sharedPCH && (inputFiles.size() > 1))
+        prefix.reset(new CPPParser::PrecompiledPrefix(cacheDirectory));
+    CPPParser::ParserPool parserPool(jobs, flags, cache.get());
+    parserPool.SetPrecompiledPrefix(prefix.get());
+    parserPool.SetAllowedPaths(allowedPaths);
+    if (!parserPool.Parse(inputFiles, options))
+        return EXIT_FAILURE;
+
+    for (size_t index = 0; index < parserPool.GetASTs().size(); ++index)
+    {
+        CPPParser::TraceSpan span("output", inputFiles[index]);
+        CPPParser::StatsTimer timer;
+        parserPool.GetASTs()[index].Show(cout, 0);
+        if (stats)
+            CPPParser::Stats::AddTime(inputFiles[index], CPPParser::StatsPhase::Output, timer.Elapsed());
+    }
+    if (stats && statsFile.empty())
+        CPPParser::Stats::Report(cerr);
+    else if (stats)
     {
-        CPPParser::Parser parser(inputFile);
-        if (!parser.Parse(options))
+        std::ofstream statsStream(statsFile);
+        CPPParser::Stats::ReportJSON(statsStream);
+        if (!statsStream)
+        {
+            cerr << "Unable to write statistics to " << statsFile << endl;
             return EXIT_FAILURE;
-        symbolTrees.push_back(parser.GetAST());
+        }
     }
-
-    for (auto & ast : symbolTrees)
+    if (!traceEventsFile.empty())
     {
-        ast.Show(cout, 0);
+        std::ofstream traceEventsStream(traceEventsFile);
+        CPPParser::TraceEvents::Write(traceEventsStream);
+        if (!traceEventsStream)
+        {
+            cerr << "Unable to write trace events to " << traceEventsFile << endl;
+            return EXIT_FAILURE;
+        }
     }
     return EXIT_SUCCESS;
 }
\ No newline at end of file
@@ -7,6 +7,8 @@
 #include <include/TreeInfo.h>
 #include <clang-c/Index.h>
 #include "include/Namespace.h"
+#include "include/PreprocessorDirectives.h"
+#include "include/SymbolIndex.h"
 #include "include/CodeGenerator.h"
 
 using namespace std;
@@ -16,12 +18,24 @@ namespace CPPParser
 {
 
 AST::AST()
-    : Container(WeakPtr(), SourceLocation(), "AST", AccessSpecifier::Invalid)
+    : NodeArenaOwner()
+    , Container(ElementKind::AST, WeakPtr(), SourceLocation(), "AST", AccessSpecifier::Invalid)
     , _stack()
     , _tokenLookupMap()
 {
 }
 
+AST & AST::operator = (const AST & other)
+{
+    // The previous arenas are kept until the nodes allocated from them are released
+    NodeArenaOwner previous(*this);
+    Container::operator = (other);
+    NodeArenaOwner::operator = (other);
+    _stack = other._stack;
+    _tokenLookupMap = other._tokenLookupMap;
+    return *this;
+}
+
 bool AST::TraverseBegin(IASTVisitor & visitor) const
 {
     return visitor.Enter(*this);
@@ -58,16 +72,13 @@ void AST::GenerateCode(std::ostream & stream, int indent) const
 
 Declaration::Ptr AST::Find(CXCursor token) const
 {
-    auto it = _tokenLookupMap.find(token);
-    Declaration::Ptr object = nullptr;
-    if (it != _tokenLookupMap.end())
-        object = it->second;
-    return object;
+    const Declaration::Ptr * object = _tokenLookupMap.Find(token);
+    return (object != nullptr) ? *object : nullptr;
 }
 
 void AST::AddToMap(CXCursor token, Declaration::Ptr object)
 {
-    _tokenLookupMap.insert({token, object});
+    _tokenLookupMap.Insert(token, object);
 }
 
 Declaration::Ptr AST::AddNamespace(CXCursor token, CXCursor parentToken)
@@ -76,33 +87,28 @@ Declaration::Ptr AST::AddNamespace(CXCursor token, CXCursor parentToken)
     Declaration::Ptr object;
     std::string name = ConvertString(clang_getCursorSpelling(token));
     ssize_t parentPosition = _stack.Find(parentToken);
+    // The declarations on the stack were resolved when they were pushed, so a re-opened namespace is recognized by the
+    // declaration of the scope that was last entered below the parent, without going back to its cursor
+    Declaration::Ptr candidate;
     if (parentPosition > 0)
     {
         // Our parent is in the stack and not on top
-        CXCursor currentParentsChild = _stack.At(static_cast<size_t>(parentPosition - 1));
-        if ((token.kind == currentParentsChild.kind) &&
-            (name == ConvertString(clang_getCursorSpelling(currentParentsChild))))
-        {
-            // The top of the stack (after correction) is the same kind and has the same name, so this must be the same token
-            object = Find(currentParentsChild);
-        }
+        candidate = _stack.ValueAt(static_cast<size_t>(parentPosition - 1));
     }
     else if ((parentPosition < 0) && (_stack.Count() > 0))
     {
         // Our parent is not on the stack, we may be in the global namespace
-        CXCursor currentTopOfStack = _stack.At(static_cast<size_t>(0));
-        if ((token.kind == currentTopOfStack.kind) &&
-            (name == ConvertString(clang_getCursorSpelling(currentTopOfStack))))
-        {
-            // The top of the stack (after correction) is the same kind and has the same name, so this must be the same token
-            object = Find(currentTopOfStack);
-        }
+        candidate = _stack.ValueAt(static_cast<size_t>(0));
+    }
+    if ((candidate != nullptr) && (candidate->Kind() == ElementKind::Namespace) && (candidate->Name() == name))
+    {
+        // The top of the stack (after correction) is the same kind and has the same name, so this must be the same token
+        object = candidate;
     }
-    UpdateStack(token, parentToken);
     if (object == nullptr)
     {
-        object = make_shared<Namespace>(parent, SourceLocation(token), name);
-        Container::Ptr parentContainer = dynamic_pointer_cast<Container>(object->Parent());
+        object = MakeNode<Namespace>(_arena, parent, SourceLocation(token), name);
+        Container * parentContainer = AsContainer(object->Parent());
         if (parentContainer != nullptr)
         {
             parentContainer->Add(object);
@@ -112,6 +118,7 @@ Declaration::Ptr AST::AddNamespace(CXCursor token, CXCursor parentToken)
             Add(object);
         }
     }
+    UpdateStack(token, parentToken, object);
     AddToMap(token, object);
     return object;
 }
@@ -122,8 +129,8 @@ Declaration::Ptr AST::AddClass(CXCursor token, CXCursor parentToken)
     Class::Ptr object;
     std::string name = ConvertString(clang_getCursorSpelling(token));
     AccessSpecifier accessSpecifier = ConvertAccessSpecifier(clang_getCXXAccessSpecifier(token));
-    object = make_shared<Class>(parent, SourceLocation(token), name, accessSpecifier);
-    Container::Ptr parentContainer = dynamic_pointer_cast<Container>(object->Parent());
+    object = MakeNode<Class>(_arena, parent, SourceLocation(token), name, accessSpecifier);
+    Container * parentContainer = AsContainer(object->Parent());
     if (parentContainer != nullptr)
     {
         parentContainer->Add(object);
@@ -141,8 +148,8 @@ Declaration::Ptr AST::AddStruct(CXCursor token, CXCursor parentToken)
     Struct::Ptr object;
     std::string name = ConvertString(clang_getCursorSpelling(token));
     AccessSpecifier accessSpecifier = ConvertAccessSpecifier(clang_getCXXAccessSpecifier(token));
-    object = make_shared<Struct>(parent, SourceLocation(token), name, accessSpecifier);
-    Container::Ptr parentContainer = dynamic_pointer_cast<Container>(object->Parent());
+    object = MakeNode<Struct>(_arena, parent, SourceLocation(token), name, accessSpecifier);
+    Container * parentContainer = AsContainer(object->Parent());
     if (parentContainer != nullptr)
     {
         parentContainer->Add(object);
@@ -166,11 +173,9 @@ Declaration::Ptr AST::AddConstructor(CXCursor token, CXCursor parentToken)
     for (int i = 0; i < numArguments; ++i)
     {
         CXCursor parameterToken = clang_Cursor_getArgument(token, i);
-        CXString parameterNameStr = clang_getCursorSpelling(parameterToken);
         CXType parameterTypeDecl = clang_getArgType(functionType, i);
-        CXString parameterTypeStr = clang_getTypeSpelling(parameterTypeDecl);
-        std::string parameterName = ConvertString(parameterNameStr);
-        std::string parameterType = ConvertString(parameterTypeStr);
+        std::string parameterName = ConvertString(clang_getCursorSpelling(parameterToken));
+        std::string parameterType = ConvertString(clang_getTypeSpelling(parameterTypeDecl));
 
         parameters.emplace_back(parameterName, parameterType);
     }
@@ -180,15 +185,15 @@ Declaration::Ptr AST::AddConstructor(CXCursor token, CXCursor parentToken)
     flags = static_cast<FunctionFlags>(flags | ((clang_CXXMethod_isPureVirtual(token) != 0) ? (FunctionFlags::PureVirtual | FunctionFlags::Virtual) : 0));
     flags = static_cast<FunctionFlags>(flags | ((clang_CXXMethod_isStatic(token) != 0) ? FunctionFlags::Static : 0));
 
-    auto object = make_shared<Constructor>(parent, SourceLocation(token), name, accessSpecifier, parameters, flags);
-    Object::Ptr parentObject = dynamic_pointer_cast<Object>(object->Parent());
+    auto object = MakeNode<Constructor>(_arena, parent, SourceLocation(token), name, accessSpecifier, parameters, flags);
+    Object * parentObject = AsObject(object->Parent());
     if (parentObject != nullptr)
     {
         parentObject->Add(object);
     }
     else
     {
-        cerr << "Parent is not an object" << endl;
+        ErrorStream() << "Parent is not an object" << endl;
         return nullptr;
     }
     AddToMap(token, object);
@@ -200,9 +205,6 @@ Declaration::Ptr AST::AddDestructor(CXCursor token, CXCursor parentToken)
     Declaration::Ptr parent = Find(parentToken);
     std::string name = ConvertString(clang_getCursorSpelling(token));
     AccessSpecifier accessSpecifier = ConvertAccessSpecifier(clang_getCXXAccessSpecifier(token));
-    CXType functionType = clang_getCursorType(token);
-    CXType resultType = clang_getResultType(functionType);
-    CXString resultTypeStr = clang_getTypeSpelling(resultType);
 
     FunctionFlags flags {};
     flags = static_cast<FunctionFlags>(flags | ((clang_CXXMethod_isConst(token) != 0) ? FunctionFlags::Const : 0));
@@ -210,15 +212,15 @@ Declaration::Ptr AST::AddDestructor(CXCursor token, CXCursor parentToken)
     flags = static_cast<FunctionFlags>(flags | ((clang_CXXMethod_isPureVirtual(token) != 0) ? (FunctionFlags::PureVirtual | FunctionFlags::Virtual) : 0));
     flags = static_cast<FunctionFlags>(flags | ((clang_CXXMethod_isStatic(token) != 0) ? FunctionFlags::Static : 0));
 
-    auto object = make_shared<Destructor>(parent, SourceLocation(token), name, accessSpecifier, flags);
-    Object::Ptr parentObject = dynamic_pointer_cast<Object>(object->Parent());
+    auto object = MakeNode<Destructor>(_arena, parent, SourceLocation(token), name, accessSpecifier, flags);
+    Object * parentObject = AsObject(object->Parent());
     if (parentObject != nullptr)
     {
         parentObject->Add(object);
     }
     else
     {
-        cerr << "Parent is not an object" << endl;
+        ErrorStream() << "Parent is not an object" << endl;
         return nullptr;
     }
     AddToMap(token, object);
@@ -232,19 +234,16 @@ Declaration::Ptr AST::AddMethod(CXCursor token, CXCursor parentToken)
     AccessSpecifier accessSpecifier = ConvertAccessSpecifier(clang_getCXXAccessSpecifier(token));
     CXType functionType = clang_getCursorType(token);
     CXType resultType = clang_getResultType(functionType);
-    CXString resultTypeStr = clang_getTypeSpelling(resultType);
-    std::string type = ConvertString(resultTypeStr);
+    std::string type = ConvertString(clang_getTypeSpelling(resultType));
 
     int numArguments = clang_Cursor_getNumArguments(token);
     ParameterList parameters;
     for (int i = 0; i < numArguments; ++i)
     {
         CXCursor parameterToken = clang_Cursor_getArgument(token, i);
-        CXString parameterNameStr = clang_getCursorSpelling(parameterToken);
         CXType parameterTypeDecl = clang_getArgType(functionType, i);
-        CXString parameterTypeStr = clang_getTypeSpelling(parameterTypeDecl);
-        std::string parameterName = ConvertString(parameterNameStr);
-        std::string parameterType = ConvertString(parameterTypeStr);
+        std::string parameterName = ConvertString(clang_getCursorSpelling(parameterToken));
+        std::string parameterType = ConvertString(clang_getTypeSpelling(parameterTypeDecl));
 
         parameters.emplace_back(parameterName, parameterType);
     }
@@ -254,8 +253,8 @@ Declaration::Ptr AST::AddMethod(CXCursor token, CXCursor parentToken)
     flags = static_cast<FunctionFlags>(flags | ((clang_CXXMethod_isPureVirtual(token) != 0) ? (FunctionFlags::PureVirtual | FunctionFlags::Virtual) : 0));
     flags = static_cast<FunctionFlags>(flags | ((clang_CXXMethod_isStatic(token) != 0) ? FunctionFlags::Static : 0));
 
-    auto object = make_shared<Method>(parent, SourceLocation(token), name, accessSpecifier, type, parameters, flags);
-    Object::Ptr parentObject = dynamic_pointer_cast<Object>(object->Parent());
+    auto object = MakeNode<Method>(_arena, parent, SourceLocation(token), name, accessSpecifier, type, parameters, flags);
+    Object * parentObject = AsObject(object->Parent());
     if (parentObject != nullptr)
     {
         parentObject->Add(object);
@@ -276,8 +275,8 @@ Declaration::Ptr AST::AddDataMember(CXCursor token, CXCursor parentToken)
     AccessSpecifier accessSpecifier = ConvertAccessSpecifier(clang_getCXXAccessSpecifier(token));
     std::string type = ConvertString(clang_getTypeSpelling(clang_getCursorType(token)));
 
-    auto object = make_shared<DataMember>(parent, SourceLocation(token), name, accessSpecifier, type);
-    Object::Ptr parentObject = dynamic_pointer_cast<Object>(object->Parent());
+    auto object = MakeNode<DataMember>(_arena, parent, SourceLocation(token), name, accessSpecifier, type);
+    Object * parentObject = AsObject(object->Parent());
     if (parentObject != nullptr)
     {
         parentObject->Add(object);
@@ -300,12 +299,11 @@ Declaration::Ptr AST::AddEnum(CXCursor token, CXCursor parentToken)
     CXType type = clang_getEnumDeclIntegerType(token);
     if (type.kind != CXType_UInt)
     {
-        CXString strType = clang_getTypeSpelling(type);
-        underlyingType = ConvertString(strType);
+        underlyingType = ConvertString(clang_getTypeSpelling(type));
     }
 
-    auto object = make_shared<Enum>(parent, SourceLocation(token), name, accessSpecifier, underlyingType);
-    Container::Ptr parentContainer = dynamic_pointer_cast<Container>(object->Parent());
+    auto object = MakeNode<Enum>(_arena, parent, SourceLocation(token), name, accessSpecifier, underlyingType);
+    Container * parentContainer = AsContainer(object->Parent());
     if (parentContainer != nullptr)
     {
         parentContainer->Add(object);
@@ -321,14 +319,13 @@ Declaration::Ptr AST::AddEnum(CXCursor token, CXCursor parentToken)
 void AST::AddEnumValue(CXCursor token, CXCursor parentToken)
 {
     Declaration::Ptr parent = Find(parentToken);
-    Enum::Ptr parentEnum = dynamic_pointer_cast<Enum>(parent);
-    if (parentEnum != nullptr)
+    if ((parent != nullptr) && (parent->Kind() == ElementKind::Enum))
     {
-        parentEnum->AddValue(token);
+        static_cast<Enum &>(*parent).AddValue(token);
     }
     else
     {
-        cerr << "Parent is not an enum?" << endl;
+        ErrorStream() << "Parent is not an enum?" << endl;
         return;
     }
 }
@@ -340,8 +337,8 @@ Declaration::Ptr AST::AddTypedef(CXCursor token, CXCursor parentToken)
     AccessSpecifier accessSpecifier = ConvertAccessSpecifier(clang_getCXXAccessSpecifier(token));
     std::string type = ConvertString(clang_getTypeSpelling(clang_getTypedefDeclUnderlyingType(token)));
 
-    auto object = make_shared<Typedef>(parent, SourceLocation(token), name, accessSpecifier, type);
-    Namespace::Ptr parentNamespace = dynamic_pointer_cast<Namespace>(object->Parent());
+    auto object = MakeNode<Typedef>(_arena, parent, SourceLocation(token), name, accessSpecifier, type);
+    Namespace * parentNamespace = AsNamespace(object->Parent());
     if (parentNamespace != nullptr)
     {
         parentNamespace->Add(object);
@@ -362,8 +359,8 @@ Declaration::Ptr AST::AddVariable(CXCursor token, CXCursor parentToken)
     AccessSpecifier accessSpecifier = ConvertAccessSpecifier(clang_getCXXAccessSpecifier(token));
     std::string type = ConvertString(clang_getTypeSpelling(clang_getCursorType(token)));
 
-    auto object = make_shared<Variable>(parent, SourceLocation(token), name, accessSpecifier, type);
-    Namespace::Ptr parentNamespace = dynamic_pointer_cast<Namespace>(object->Parent());
+    auto object = MakeNode<Variable>(_arena, parent, SourceLocation(token), name, accessSpecifier, type);
+    Namespace * parentNamespace = AsNamespace(object->Parent());
     if (parentNamespace != nullptr)
     {
         parentNamespace->Add(object);
@@ -383,19 +380,16 @@ Declaration::Ptr AST::AddFunction(CXCursor token, CXCursor parentToken)
     std::string name = ConvertString(clang_getCursorSpelling(token));
     CXType functionType = clang_getCursorType(token);
     CXType resultType = clang_getResultType(functionType);
-    CXString resultTypeStr = clang_getTypeSpelling(resultType);
-    std::string type = ConvertString(resultTypeStr);
+    std::string type = ConvertString(clang_getTypeSpelling(resultType));
 
     int numArguments = clang_Cursor_getNumArguments(token);
     ParameterList parameters;
     for (int i = 0; i < numArguments; ++i)
     {
         CXCursor parameterToken = clang_Cursor_getArgument(token, i);
-        CXString parameterNameStr = clang_getCursorSpelling(parameterToken);
         CXType parameterTypeDecl = clang_getArgType(functionType, i);
-        CXString parameterTypeStr = clang_getTypeSpelling(parameterTypeDecl);
-        std::string parameterName = ConvertString(parameterNameStr);
-        std::string parameterType = ConvertString(parameterTypeStr);
+        std::string parameterName = ConvertString(clang_getCursorSpelling(parameterToken));
+        std::string parameterType = ConvertString(clang_getTypeSpelling(parameterTypeDecl));
 
         parameters.emplace_back(parameterName, parameterType);
     }
@@ -405,8 +399,8 @@ Declaration::Ptr AST::AddFunction(CXCursor token, CXCursor parentToken)
     flags = static_cast<FunctionFlags>(flags | ((clang_CXXMethod_isPureVirtual(token) != 0) ? (FunctionFlags::PureVirtual | FunctionFlags::Virtual) : 0));
     flags = static_cast<FunctionFlags>(flags | ((clang_CXXMethod_isStatic(token) != 0) ? FunctionFlags::Static : 0));
 
-    auto object = make_shared<Function>(parent, SourceLocation(token), name, type, parameters, flags);
-    Namespace::Ptr parentNamespace = dynamic_pointer_cast<Namespace>(object->Parent());
+    auto object = MakeNode<Function>(_arena, parent, SourceLocation(token), name, type, parameters, flags);
+    Namespace * parentNamespace = AsNamespace(object->Parent());
     if (parentNamespace != nullptr)
     {
         parentNamespace->Add(object);
@@ -429,9 +423,11 @@ void AST::AddBaseClass(CXCursor token, CXCursor parentToken, Declaration::Ptr ba
 
     CXType typeDecl = clang_getCursorType(token);
     CXType baseTypeDecl = clang_getCanonicalType(typeDecl);
+    std::string baseUSR = SymbolIndex::USR(baseTypeDecl);
 
-    auto inheritance = make_shared<Inheritance>(parent, SourceLocation(token), name, accessSpecifier, baseType, isVirtual);
-    Object::Ptr parentObject = dynamic_pointer_cast<Object>(parent);
+    auto inheritance = MakeNode<Inheritance>(_arena, parent, SourceLocation(token), name, accessSpecifier, baseType, isVirtual,
+                                             baseUSR);
+    Object * parentObject = AsObject(parent.get());
     if (parentObject != nullptr)
     {
         parentObject->AddBase(inheritance);
@@ -440,11 +436,11 @@ void AST::AddBaseClass(CXCursor token, CXCursor parentToken, Declaration::Ptr ba
     {
         if (parent == nullptr)
         {
-            cerr << "Type is null. Type not supported yet?" << endl;
+            ErrorStream() << "Type is null. Type not supported yet?" << endl;
         }
         else
         {
-            cerr << "Type is not an object" <<  parent->Name() << endl;
+            ErrorStream() << "Type is not an object" <<  parent->Name() << endl;
         }
         return;
     }
@@ -456,19 +452,16 @@ Declaration::Ptr AST::AddFunctionTemplate(CXCursor token, CXCursor parentToken)
     std::string name = ConvertString(clang_getCursorSpelling(token));
     CXType functionType = clang_getCursorType(token);
     CXType resultType = clang_getResultType(functionType);
-    CXString resultTypeStr = clang_getTypeSpelling(resultType);
-    std::string type = ConvertString(resultTypeStr);
+    std::string type = ConvertString(clang_getTypeSpelling(resultType));
 
     int numArguments = clang_Cursor_getNumArguments(token);
     ParameterList parameters;
     for (int i = 0; i < numArguments; ++i)
     {
         CXCursor parameterToken = clang_Cursor_getArgument(token, i);
-        CXString parameterNameStr = clang_getCursorSpelling(parameterToken);
         CXType parameterTypeDecl = clang_getArgType(functionType, i);
-        CXString parameterTypeStr = clang_getTypeSpelling(parameterTypeDecl);
-        std::string parameterName = ConvertString(parameterNameStr);
-        std::string parameterType = ConvertString(parameterTypeStr);
+        std::string parameterName = ConvertString(clang_getCursorSpelling(parameterToken));
+        std::string parameterType = ConvertString(clang_getTypeSpelling(parameterTypeDecl));
 
         parameters.emplace_back(parameterName, parameterType);
     }
@@ -478,8 +471,8 @@ Declaration::Ptr AST::AddFunctionTemplate(CXCursor token, CXCursor parentToken)
     flags = static_cast<FunctionFlags>(flags | ((clang_CXXMethod_isPureVirtual(token) != 0) ? (FunctionFlags::PureVirtual | FunctionFlags::Virtual) : 0));
     flags = static_cast<FunctionFlags>(flags | ((clang_CXXMethod_isStatic(token) != 0) ? FunctionFlags::Static : 0));
 
-    auto object = make_shared<FunctionTemplate>(parent, SourceLocation(token), name, type, parameters, flags);
-    Namespace::Ptr parentNamespace = dynamic_pointer_cast<Namespace>(object->Parent());
+    auto object = MakeNode<FunctionTemplate>(_arena, parent, SourceLocation(token), name, type, parameters, flags);
+    Namespace * parentNamespace = AsNamespace(object->Parent());
     if (parentNamespace != nullptr)
     {
         parentNamespace->Add(object);
@@ -499,8 +492,8 @@ Declaration::Ptr AST::AddClassTemplate(CXCursor token, CXCursor parentToken)
     ClassTemplate::Ptr object;
     std::string name = ConvertString(clang_getCursorSpelling(token));
     AccessSpecifier accessSpecifier = ConvertAccessSpecifier(clang_getCXXAccessSpecifier(token));
-    object = make_shared<ClassTemplate>(parent, SourceLocation(token), name, accessSpecifier);
-    Container::Ptr parentContainer = dynamic_pointer_cast<Container>(object->Parent());
+    object = MakeNode<ClassTemplate>(_arena, parent, SourceLocation(token), name, accessSpecifier);
+    Container * parentContainer = AsContainer(object->Parent());
     if (parentContainer != nullptr)
     {
         parentContainer->Add(object);
@@ -516,19 +509,35 @@ void AST::AddTemplateTypeParameter(CXCursor token, CXCursor parentToken)
 {
     Declaration::Ptr parent = Find(parentToken);
     std::string name = ConvertString(clang_getCursorSpelling(token));
-    FunctionTemplate::Ptr functionTemplate = dynamic_pointer_cast<FunctionTemplate>(parent);
-    if (functionTemplate != nullptr)
+    if ((parent != nullptr) && (parent->Kind() == ElementKind::FunctionTemplate))
     {
-        functionTemplate->AddTemplateParameter(name);
+        static_cast<FunctionTemplate &>(*parent).AddTemplateParameter(name);
         return;
     }
-    ClassTemplate::Ptr classTemplate = dynamic_pointer_cast<ClassTemplate>(parent);
-    if (classTemplate != nullptr)
+    if ((parent != nullptr) && (parent->Kind() == ElementKind::ClassTemplate))
     {
-        classTemplate->AddTemplateParameter(name);
+        static_cast<ClassTemplate &>(*parent).AddTemplateParameter(name);
         return;
     }
-    cerr << "Panic! No function or class template" << endl;
+    ErrorStream() << "Panic! No function or class template" << endl;
+}
+
+void AST::AddInclude(CXCursor token, CXCursor parentToken)
+{
+    Declaration::Ptr parent = Find(parentToken);
+    // The spelling is the file name as written, without the quotes or angle brackets
+    std::string name = ConvertString(clang_getCursorSpelling(token));
+
+    auto object = MakeNode<IncludeDirective>(_arena, parent, SourceLocation(token), name, ConvertIncludeSpecifier(token));
+    Container * parentContainer = AsContainer(object->Parent());
+    if (parentContainer != nullptr)
+    {
+        parentContainer->Add(object);
+    }
+    else
+    {
+        Add(object);
+    }
 }
 
 void AST::ShowInfo()
@@ -538,12 +547,12 @@ void AST::ShowInfo()
     {
         CXCursor element = _stack.At(_stack.Count() - index - 1);
         CXCursorKind kind = clang_getCursorKind(element);
-        CXString strKind = clang_getCursorKindSpelling(kind);
+        ClangString strKind(clang_getCursorKindSpelling(kind));
         CXType type = clang_getCursorType(element);
-        CXString strType = clang_getTypeSpelling(type);
+        ClangString strType(clang_getTypeSpelling(type));
         CXType underlyingType = clang_getTypedefDeclUnderlyingType(element);
-        CXString strUnderlyingType = clang_getTypeSpelling(underlyingType);
-        CXString strName = clang_getCursorSpelling(element);
+        ClangString strUnderlyingType(clang_getTypeSpelling(underlyingType));
+        ClangString strName(clang_getCursorSpelling(element));
         if (kind < CXCursorKind::CXCursor_FirstInvalid)
         {
             switch (type.kind)
@@ -576,7 +585,7 @@ void AST::ShowInfo()
     }
 }
 
-void AST::UpdateStack(CXCursor token, CXCursor parentToken)
+void AST::UpdateStack(CXCursor token, CXCursor parentToken, const Declaration::Ptr & object)
 {
     ssize_t index = _stack.Find(parentToken);
     if (index > 0)
@@ -590,7 +599,7 @@ void AST::UpdateStack(CXCursor token, CXCursor parentToken)
         // Make sure parent cursor is at top of stack, remove any others
         _stack.RemoveTopElements(_stack.Count());
     }
-    _stack.Push(token);
+    _stack.Push(token, object);
 }
 
 } // namespace CPPParser
@@ -7,7 +7,12 @@
 #include <include/TreeInfo.h>
 #include <clang-c/Index.h>
 #include "include/Namespace.h"
+#include "include/PreprocessorDirectives.h"
+#include "include/SymbolIndex.h"
+#include "include/Typedef.h"
+#include "include/Variable.h"
 #include "include/CodeGenerator.h"
+#include "include/Trace.h"
 
 using namespace std;
 using namespace Utility;
@@ -16,12 +21,24 @@ namespace CPPParser
 {
 
 ASTCollection::ASTCollection()
-    : Container(WeakPtr(), SourceLocation(), "ASTCollection", AccessSpecifier::Invalid)
+    : NodeArenaOwner()
+    , Container(ElementKind::ASTCollection, WeakPtr(), SourceLocation(), "ASTCollection", AccessSpecifier::Invalid)
     , _stack()
     , _tokenLookupMap()
 {
 }
 
+ASTCollection & ASTCollection::operator = (const ASTCollection & other)
+{
+    // The previous arenas are kept until the nodes allocated from them are released
+    NodeArenaOwner previous(*this);
+    Container::operator = (other);
+    NodeArenaOwner::operator = (other);
+    _stack = other._stack;
+    _tokenLookupMap = other._tokenLookupMap;
+    return *this;
+}
+
 bool ASTCollection::TraverseBegin(IASTVisitor & visitor) const
 {
     return visitor.Enter(*this);
@@ -58,71 +75,277 @@ void ASTCollection::GenerateCode(std::ostream & stream, int indent) const
 
 Declaration::Ptr ASTCollection::Find(CXCursor token) const
 {
-    auto it = _tokenLookupMap.find(token);
-    Declaration::Ptr object = nullptr;
-    if (it != _tokenLookupMap.end())
-        object = it->second;
-    return object;
+    const Declaration::Ptr * object = _tokenLookupMap.Find(token);
+    return (object != nullptr) ? *object : nullptr;
 }
 
-bool ASTCollection::FindNamespaceByName(Declaration::Ptr parent, const std::string & name, Namespace::Ptr & result)
+bool ASTCollection::FindNamespaceByName(const Declaration::Ptr & parent, const std::string & name, Namespace::Ptr & result)
 {
     result = {};
     if (parent == nullptr)
         return FindNamespace(name, result);
-    auto parentContainer = dynamic_pointer_cast<Container>(parent);
+    auto parentContainer = AsContainer(parent.get());
     if (parentContainer != nullptr)
         return parentContainer->FindNamespace(name, result);
     return false;
 }
 
-bool ASTCollection::FindClassByName(Declaration::Ptr parent, const std::string & name, Class::Ptr & result)
+bool ASTCollection::FindClassByName(const Declaration::Ptr & parent, const std::string & name, Class::Ptr & result)
 {
     result = {};
     if (parent == nullptr)
         return FindClass(name, result);
-    auto parentContainer = dynamic_pointer_cast<Container>(parent);
+    auto parentContainer = AsContainer(parent.get());
     if (parentContainer != nullptr)
         return parentContainer->FindClass(name, result);
     return false;
 }
 
-bool ASTCollection::FindStructByName(Declaration::Ptr parent, const std::string & name, Struct::Ptr & result)
+bool ASTCollection::FindStructByName(const Declaration::Ptr & parent, const std::string & name, Struct::Ptr & result)
 {
     result = {};
     if (parent == nullptr)
         return FindStruct(name, result);
-    auto parentContainer = dynamic_pointer_cast<Container>(parent);
+    auto parentContainer = AsContainer(parent.get());
     if (parentContainer != nullptr)
         return parentContainer->FindStruct(name, result);
     return false;
 }
 
-bool ASTCollection::FindClassTemplateByName(Declaration::Ptr parent, const std::string & name, ClassTemplate::Ptr & result)
+bool ASTCollection::FindClassTemplateByName(const Declaration::Ptr & parent, const std::string & name, ClassTemplate::Ptr & result)
 {
     result = {};
     if (parent == nullptr)
         return FindClassTemplate(name, result);
-    auto parentContainer = dynamic_pointer_cast<Container>(parent);
+    auto parentContainer = AsContainer(parent.get());
     if (parentContainer != nullptr)
         return parentContainer->FindClassTemplate(name, result);
     return false;
 }
 
-bool ASTCollection::FindEnumByName(Declaration::Ptr parent, const std::string & name, Enum::Ptr & result)
+bool ASTCollection::FindEnumByName(const Declaration::Ptr & parent, const std::string & name, Enum::Ptr & result)
 {
     result = {};
     if (parent == nullptr)
         return FindEnum(name, result);
-    auto parentContainer = dynamic_pointer_cast<Container>(parent);
+    auto parentContainer = AsContainer(parent.get());
     if (parentContainer != nullptr)
         return parentContainer->FindEnum(name, result);
     return false;
 }
 
+void ASTCollection::Merge(const AST & ast)
+{
+    // The copies share the names of the elements of the tree
+    _arena->AddStringPools(*ast.Arena());
+    CounterpartMap counterparts;
+    bool linksSource = false;
+    MergeContents(ast, *this, counterparts, linksSource);
+    // Copies of base classes that were not copied (yet) still refer to the nodes of the source tree, or of the trees
+    // linked to it
+    if (linksSource)
+        LinkArenas(ast);
+}
+
+Element::Ptr ASTCollection::Counterpart(const Element * element, const CounterpartMap & counterparts)
+{
+    if (element == nullptr)
+        return nullptr;
+    auto it = counterparts.find(element);
+    if (it != counterparts.end())
+        return it->second;
+    return nullptr;
+}
+
+void ASTCollection::MergeContents(const Container & source, Container & target, CounterpartMap & counterparts,
+                                  bool & linksSource)
+{
+    for (auto const & element : source.Contents())
+    {
+        // The element was placed by the same rules as the collection uses, so its copy goes into the counterpart of its container
+        Declaration::Ptr parent = static_pointer_cast<Declaration>(Counterpart(element->Parent(), counterparts));
+        Element::Ptr object;
+        switch (element->Kind())
+        {
+            case ElementKind::Namespace:
+            {
+                auto & aNamespace = static_cast<const Namespace &>(*element);
+                Namespace::Ptr copy;
+                if (FindNamespaceByName(parent, aNamespace.Name(), copy))
+                    TRACE_LOG(TraceTreeBuild, TraceLevel::Info, "Namespace already exists.");
+                else
+                {
+                    copy = MakeNode<Namespace>(_arena, parent, aNamespace.Location(), aNamespace.Name());
+                    target.Add(copy);
+                }
+                counterparts[element.get()] = copy;
+                MergeContents(aNamespace, *copy, counterparts, linksSource);
+                continue;
+            }
+            case ElementKind::Class:
+            {
+                auto & aClass = static_cast<const Class &>(*element);
+                Class::Ptr copy;
+                if (FindClassByName(parent, aClass.Name(), copy))
+                    TRACE_LOG(TraceTreeBuild, TraceLevel::Info, "Class already exists.");
+                else
+                {
+                    copy = MakeNode<Class>(_arena, parent, aClass.Location(), aClass.Name(), aClass.Access());
+                    target.Add(copy);
+                }
+                counterparts[element.get()] = copy;
+                MergeBaseTypes(aClass, *copy, counterparts, linksSource);
+                MergeContents(aClass, *copy, counterparts, linksSource);
+                continue;
+            }
+            case ElementKind::Struct:
+            {
+                auto & aStruct = static_cast<const Struct &>(*element);
+                Struct::Ptr copy;
+                if (FindStructByName(parent, aStruct.Name(), copy))
+                    TRACE_LOG(TraceTreeBuild, TraceLevel::Info, "Struct already exists.");
+                else
+                {
+                    copy = MakeNode<Struct>(_arena, parent, aStruct.Location(), aStruct.Name(), aStruct.Access());
+                    target.Add(copy);
+                }
+                counterparts[element.get()] = copy;
+                MergeBaseTypes(aStruct, *copy, counterparts, linksSource);
+                MergeContents(aStruct, *copy, counterparts, linksSource);
+                continue;
+            }
+            case ElementKind::ClassTemplate:
+            {
+                auto & aClassTemplate = static_cast<const ClassTemplate &>(*element);
+                ClassTemplate::Ptr copy;
+                if (FindClassTemplateByName(parent, aClassTemplate.Name(), copy))
+                    TRACE_LOG(TraceTreeBuild, TraceLevel::Info, "Class template already exists.");
+                else
+                {
+                    copy = MakeNode<ClassTemplate>(_arena, parent, aClassTemplate.Location(), aClassTemplate.Name(),
+                                                   aClassTemplate.Access());
+                    target.Add(copy);
+                }
+                // As when building from cursors, the parameters of every declaration are added to the merged template
+                for (auto const & templateParameter : aClassTemplate.TemplateParameters())
+                {
+                    copy->AddTemplateParameter(templateParameter);
+                }
+                counterparts[element.get()] = copy;
+                MergeBaseTypes(aClassTemplate, *copy, counterparts, linksSource);
+                MergeContents(aClassTemplate, *copy, counterparts, linksSource);
+                continue;
+            }
+            case ElementKind::Enum:
+            {
+                auto & aEnum = static_cast<const Enum &>(*element);
+                auto copy = MakeNode<Enum>(_arena, parent, aEnum.Location(), aEnum.Name(), aEnum.Access(), aEnum.Type());
+                for (auto const & value : aEnum.Values())
+                {
+                    copy->AddValue(value.Name(), value.Value());
+                }
+                object = copy;
+                break;
+            }
+            case ElementKind::Constructor:
+            {
+                auto & aConstructor = static_cast<const Constructor &>(*element);
+                object = MakeNode<Constructor>(_arena, parent, aConstructor.Location(), aConstructor.Name(), aConstructor.Access(),
+                                               aConstructor.Parameters(), aConstructor.Flags());
+                break;
+            }
+            case ElementKind::Destructor:
+            {
+                auto & aDestructor = static_cast<const Destructor &>(*element);
+                object = MakeNode<Destructor>(_arena, parent, aDestructor.Location(), aDestructor.Name(), aDestructor.Access(),
+                                              aDestructor.Flags());
+                break;
+            }
+            case ElementKind::Method:
+            {
+                auto & aMethod = static_cast<const Method &>(*element);
+                object = MakeNode<Method>(_arena, parent, aMethod.Location(), aMethod.Name(), aMethod.Access(),
+                                          aMethod.Type(), aMethod.Parameters(), aMethod.Flags());
+                break;
+            }
+            case ElementKind::Function:
+            {
+                auto & aFunction = static_cast<const Function &>(*element);
+                object = MakeNode<Function>(_arena, parent, aFunction.Location(), aFunction.Name(),
+                                            aFunction.Type(), aFunction.Parameters(), aFunction.Flags());
+                break;
+            }
+            case ElementKind::FunctionTemplate:
+            {
+                auto & aFunctionTemplate = static_cast<const FunctionTemplate &>(*element);
+                auto copy = MakeNode<FunctionTemplate>(_arena, parent, aFunctionTemplate.Location(), aFunctionTemplate.Name(),
+                                                       aFunctionTemplate.Type(), aFunctionTemplate.Parameters(),
+                                                       aFunctionTemplate.Flags());
+                for (auto const & templateParameter : aFunctionTemplate.TemplateParameters())
+                {
+                    copy->AddTemplateParameter(templateParameter);
+                }
+                object = copy;
+                break;
+            }
+            case ElementKind::DataMember:
+            {
+                auto & aDataMember = static_cast<const DataMember &>(*element);
+                object = MakeNode<DataMember>(_arena, parent, aDataMember.Location(), aDataMember.Name(), aDataMember.Access(),
+                                              aDataMember.Type());
+                break;
+            }
+            case ElementKind::Variable:
+            {
+                auto & aVariable = static_cast<const Variable &>(*element);
+                object = MakeNode<Variable>(_arena, parent, aVariable.Location(), aVariable.Name(), aVariable.Access(),
+                                            aVariable.Type());
+                break;
+            }
+            case ElementKind::Typedef:
+            {
+                auto & aTypedef = static_cast<const Typedef &>(*element);
+                object = MakeNode<Typedef>(_arena, parent, aTypedef.Location(), aTypedef.Name(), aTypedef.Access(),
+                                           aTypedef.Type());
+                break;
+            }
+            case ElementKind::IncludeDirective:
+            {
+                auto & anInclude = static_cast<const IncludeDirective &>(*element);
+                object = MakeNode<IncludeDirective>(_arena, parent, anInclude.Location(), anInclude.Name(),
+                                                    anInclude.IncludeType());
+                break;
+            }
+            default:
+                ErrorStream() << "Unsupported element " << element->Name() << endl;
+                continue;
+        }
+        target.Add(object);
+        counterparts[element.get()] = object;
+    }
+}
+
+void ASTCollection::MergeBaseTypes(const Object & source, Object & target, CounterpartMap & counterparts,
+                                   bool & linksSource)
+{
+    for (auto const & baseType : source.BaseTypes())
+    {
+        Element::Ptr parent = Counterpart(baseType->Parent(), counterparts);
+        Element::Ptr base = Counterpart(baseType->BaseType().get(), counterparts);
+        if (base == nullptr)
+        {
+            base = baseType->BaseType();
+            if (base != nullptr)
+                linksSource = true;
+        }
+        target.AddBase(MakeNode<Inheritance>(_arena, parent, baseType->Location(), baseType->Name(), baseType->Access(),
+                                                base, baseType->IsVirtual(), baseType->BaseUSR()));
+    }
+}
+
 void ASTCollection::AddToMap(CXCursor token, Declaration::Ptr object)
 {
-    _tokenLookupMap.insert({token, object});
+    _tokenLookupMap.Insert(token, object);
 }
 
 Declaration::Ptr ASTCollection::AddNamespace(CXCursor token, CXCursor parentToken)
@@ -134,15 +357,15 @@ Declaration::Ptr ASTCollection::AddNamespace(CXCursor token, CXCursor parentToke
     if (FindNamespaceByName(parent, name, object))
     {
         // If it already exists, we have a duplicate with a new token, and the same object with the new token
-        cout << "Namespace already exists." << endl;
+        TRACE_LOG(TraceTreeBuild, TraceLevel::Info, "Namespace already exists.");
         addNewObject = false;
     }
     else
     {
-        object = make_shared<Namespace>(parent, SourceLocation(token), name);
+        object = MakeNode<Namespace>(_arena, parent, SourceLocation(token), name);
     }
-    UpdateStack(token, parentToken);
-    Container::Ptr parentContainer = dynamic_pointer_cast<Container>(object->Parent());
+    UpdateStack(token, parentToken, object);
+    Container * parentContainer = AsContainer(object->Parent());
     if (addNewObject)
     {
         if (parentContainer != nullptr)
@@ -168,17 +391,17 @@ Declaration::Ptr ASTCollection::AddClass(CXCursor token, CXCursor parentToken)
     if (FindClassByName(parent, name, object))
     {
         // If it already exists, we have a duplicate with a new token, and the same object with the new token
-        cout << "Class already exists." << endl;
+        TRACE_LOG(TraceTreeBuild, TraceLevel::Info, "Class already exists.");
         addNewObject = false;
     }
     else
     {
-        object = make_shared<Class>(parent, SourceLocation(token), name, accessSpecifier);
+        object = MakeNode<Class>(_arena, parent, SourceLocation(token), name, accessSpecifier);
     }
-    UpdateStack(token, parentToken);
+    UpdateStack(token, parentToken, object);
     if (addNewObject)
     {
-        Container::Ptr parentContainer = dynamic_pointer_cast<Container>(object->Parent());
+        Container * parentContainer = AsContainer(object->Parent());
         if (parentContainer != nullptr)
         {
             parentContainer->Add(object);
@@ -201,17 +424,17 @@ Declaration::Ptr ASTCollection::AddStruct(CXCursor token, CXCursor parentToken)
     if (FindStructByName(parent, name, object))
     {
         // If it already exists, we have a duplicate with a new token, and the same object with the new token
-        cout << "Struct already exists." << endl;
+        TRACE_LOG(TraceTreeBuild, TraceLevel::Info, "Struct already exists.");
         addNewObject = false;
     }
     else
     {
-        object = make_shared<Struct>(parent, SourceLocation(token), name, accessSpecifier);
+        object = MakeNode<Struct>(_arena, parent, SourceLocation(token), name, accessSpecifier);
     }
-    UpdateStack(token, parentToken);
+    UpdateStack(token, parentToken, object);
     if (addNewObject)
     {
-        Container::Ptr parentContainer = dynamic_pointer_cast<Container>(object->Parent());
+        Container * parentContainer = AsContainer(object->Parent());
         if (parentContainer != nullptr)
         {
             parentContainer->Add(object);
@@ -236,11 +459,9 @@ Declaration::Ptr ASTCollection::AddConstructor(CXCursor token, CXCursor parentTo
     for (int i = 0; i < numArguments; ++i)
     {
         CXCursor parameterToken = clang_Cursor_getArgument(token, i);
-        CXString parameterNameStr = clang_getCursorSpelling(parameterToken);
         CXType parameterTypeDecl = clang_getArgType(functionType, i);
-        CXString parameterTypeStr = clang_getTypeSpelling(parameterTypeDecl);
-        std::string parameterName = ConvertString(parameterNameStr);
-        std::string parameterType = ConvertString(parameterTypeStr);
+        std::string parameterName = ConvertString(clang_getCursorSpelling(parameterToken));
+        std::string parameterType = ConvertString(clang_getTypeSpelling(parameterTypeDecl));
 
         parameters.emplace_back(parameterName, parameterType);
     }
@@ -250,16 +471,16 @@ Declaration::Ptr ASTCollection::AddConstructor(CXCursor token, CXCursor parentTo
     flags = static_cast<FunctionFlags>(flags | ((clang_CXXMethod_isPureVirtual(token) != 0) ? (FunctionFlags::PureVirtual | FunctionFlags::Virtual) : 0));
     flags = static_cast<FunctionFlags>(flags | ((clang_CXXMethod_isStatic(token) != 0) ? FunctionFlags::Static : 0));
 
-    auto object = make_shared<Constructor>(parent, SourceLocation(token), name, accessSpecifier, parameters, flags);
-    UpdateStack(token, parentToken);
-    Object::Ptr parentObject = dynamic_pointer_cast<Object>(object->Parent());
+    auto object = MakeNode<Constructor>(_arena, parent, SourceLocation(token), name, accessSpecifier, parameters, flags);
+    UpdateStack(token, parentToken, object);
+    Object * parentObject = AsObject(object->Parent());
     if (parentObject != nullptr)
     {
         parentObject->Add(object);
     }
     else
     {
-        cerr << "Parent is not an object" << endl;
+        ErrorStream() << "Parent is not an object" << endl;
         return nullptr;
     }
     AddToMap(token, object);
@@ -271,9 +492,6 @@ Declaration::Ptr ASTCollection::AddDestructor(CXCursor token, CXCursor parentTok
     Declaration::Ptr parent = Find(parentToken);
     std::string name = ConvertString(clang_getCursorSpelling(token));
     AccessSpecifier accessSpecifier = ConvertAccessSpecifier(clang_getCXXAccessSpecifier(token));
-    CXType functionType = clang_getCursorType(token);
-    CXType resultType = clang_getResultType(functionType);
-    CXString resultTypeStr = clang_getTypeSpelling(resultType);
 
     FunctionFlags flags {};
     flags = static_cast<FunctionFlags>(flags | ((clang_CXXMethod_isConst(token) != 0) ? FunctionFlags::Const : 0));
@@ -281,16 +499,16 @@ Declaration::Ptr ASTCollection::AddDestructor(CXCursor token, CXCursor parentTok
     flags = static_cast<FunctionFlags>(flags | ((clang_CXXMethod_isPureVirtual(token) != 0) ? (FunctionFlags::PureVirtual | FunctionFlags::Virtual) : 0));
     flags = static_cast<FunctionFlags>(flags | ((clang_CXXMethod_isStatic(token) != 0) ? FunctionFlags::Static : 0));
 
-    auto object = make_shared<Destructor>(parent, SourceLocation(token), name, accessSpecifier, flags);
-    UpdateStack(token, parentToken);
-    Object::Ptr parentObject = dynamic_pointer_cast<Object>(object->Parent());
+    auto object = MakeNode<Destructor>(_arena, parent, SourceLocation(token), name, accessSpecifier, flags);
+    UpdateStack(token, parentToken, object);
+    Object * parentObject = AsObject(object->Parent());
     if (parentObject != nullptr)
     {
         parentObject->Add(object);
     }
     else
     {
-        cerr << "Parent is not an object" << endl;
+        ErrorStream() << "Parent is not an object" << endl;
         return nullptr;
     }
     AddToMap(token, object);
@@ -304,19 +522,16 @@ Declaration::Ptr ASTCollection::AddMethod(CXCursor token, CXCursor parentToken)
     AccessSpecifier accessSpecifier = ConvertAccessSpecifier(clang_getCXXAccessSpecifier(token));
     CXType functionType = clang_getCursorType(token);
     CXType resultType = clang_getResultType(functionType);
-    CXString resultTypeStr = clang_getTypeSpelling(resultType);
-    std::string type = ConvertString(resultTypeStr);
+    std::string type = ConvertString(clang_getTypeSpelling(resultType));
 
     int numArguments = clang_Cursor_getNumArguments(token);
     ParameterList parameters;
     for (int i = 0; i < numArguments; ++i)
     {
         CXCursor parameterToken = clang_Cursor_getArgument(token, i);
-        CXString parameterNameStr = clang_getCursorSpelling(parameterToken);
         CXType parameterTypeDecl = clang_getArgType(functionType, i);
-        CXString parameterTypeStr = clang_getTypeSpelling(parameterTypeDecl);
-        std::string parameterName = ConvertString(parameterNameStr);
-        std::string parameterType = ConvertString(parameterTypeStr);
+        std::string parameterName = ConvertString(clang_getCursorSpelling(parameterToken));
+        std::string parameterType = ConvertString(clang_getTypeSpelling(parameterTypeDecl));
 
         parameters.emplace_back(parameterName, parameterType);
     }
@@ -326,9 +541,9 @@ Declaration::Ptr ASTCollection::AddMethod(CXCursor token, CXCursor parentToken)
     flags = static_cast<FunctionFlags>(flags | ((clang_CXXMethod_isPureVirtual(token) != 0) ? (FunctionFlags::PureVirtual | FunctionFlags::Virtual) : 0));
     flags = static_cast<FunctionFlags>(flags | ((clang_CXXMethod_isStatic(token) != 0) ? FunctionFlags::Static : 0));
 
-    auto object = make_shared<Method>(parent, SourceLocation(token), name, accessSpecifier, type, parameters, flags);
-    UpdateStack(token, parentToken);
-    Object::Ptr parentObject = dynamic_pointer_cast<Object>(object->Parent());
+    auto object = MakeNode<Method>(_arena, parent, SourceLocation(token), name, accessSpecifier, type, parameters, flags);
+    UpdateStack(token, parentToken, object);
+    Object * parentObject = AsObject(object->Parent());
     if (parentObject != nullptr)
     {
         parentObject->Add(object);
@@ -349,9 +564,9 @@ Declaration::Ptr ASTCollection::AddDataMember(CXCursor token, CXCursor parentTok
     AccessSpecifier accessSpecifier = ConvertAccessSpecifier(clang_getCXXAccessSpecifier(token));
     std::string type = ConvertString(clang_getTypeSpelling(clang_getCursorType(token)));
 
-    auto object = make_shared<DataMember>(parent, SourceLocation(token), name, accessSpecifier, type);
-    UpdateStack(token, parentToken);
-    Object::Ptr parentObject = dynamic_pointer_cast<Object>(object->Parent());
+    auto object = MakeNode<DataMember>(_arena, parent, SourceLocation(token), name, accessSpecifier, type);
+    UpdateStack(token, parentToken, object);
+    Object * parentObject = AsObject(object->Parent());
     if (parentObject != nullptr)
     {
         parentObject->Add(object);
@@ -374,13 +589,12 @@ Declaration::Ptr ASTCollection::AddEnum(CXCursor token, CXCursor parentToken)
     CXType type = clang_getEnumDeclIntegerType(token);
     if (type.kind != CXType_UInt)
     {
-        CXString strType = clang_getTypeSpelling(type);
-        underlyingType = ConvertString(strType);
+        underlyingType = ConvertString(clang_getTypeSpelling(type));
     }
 
-    auto object = make_shared<Enum>(parent, SourceLocation(token), name, accessSpecifier, underlyingType);
-    UpdateStack(token, parentToken);
-    Container::Ptr parentContainer = dynamic_pointer_cast<Container>(object->Parent());
+    auto object = MakeNode<Enum>(_arena, parent, SourceLocation(token), name, accessSpecifier, underlyingType);
+    UpdateStack(token, parentToken, object);
+    Container * parentContainer = AsContainer(object->Parent());
     if (parentContainer != nullptr)
     {
         parentContainer->Add(object);
@@ -396,14 +610,13 @@ Declaration::Ptr ASTCollection::AddEnum(CXCursor token, CXCursor parentToken)
 void ASTCollection::AddEnumValue(CXCursor token, CXCursor parentToken)
 {
     Declaration::Ptr parent = Find(parentToken);
-    Enum::Ptr parentEnum = dynamic_pointer_cast<Enum>(parent);
-    if (parentEnum != nullptr)
+    if ((parent != nullptr) && (parent->Kind() == ElementKind::Enum))
     {
-        parentEnum->AddValue(token);
+        static_cast<Enum &>(*parent).AddValue(token);
     }
     else
     {
-        cerr << "Parent is not an enum?" << endl;
+        ErrorStream() << "Parent is not an enum?" << endl;
         return;
     }
 }
@@ -415,9 +628,9 @@ Declaration::Ptr ASTCollection::AddTypedef(CXCursor token, CXCursor parentToken)
     AccessSpecifier accessSpecifier = ConvertAccessSpecifier(clang_getCXXAccessSpecifier(token));
     std::string type = ConvertString(clang_getTypeSpelling(clang_getTypedefDeclUnderlyingType(token)));
 
-    auto object = make_shared<Typedef>(parent, SourceLocation(token), name, accessSpecifier, type);
-    UpdateStack(token, parentToken);
-    Namespace::Ptr parentNamespace = dynamic_pointer_cast<Namespace>(object->Parent());
+    auto object = MakeNode<Typedef>(_arena, parent, SourceLocation(token), name, accessSpecifier, type);
+    UpdateStack(token, parentToken, object);
+    Namespace * parentNamespace = AsNamespace(object->Parent());
     if (parentNamespace != nullptr)
     {
         parentNamespace->Add(object);
@@ -438,9 +651,9 @@ Declaration::Ptr ASTCollection::AddVariable(CXCursor token, CXCursor parentToken
     AccessSpecifier accessSpecifier = ConvertAccessSpecifier(clang_getCXXAccessSpecifier(token));
     std::string type = ConvertString(clang_getTypeSpelling(clang_getCursorType(token)));
 
-    auto object = make_shared<Variable>(parent, SourceLocation(token), name, accessSpecifier, type);
-    UpdateStack(token, parentToken);
-    Namespace::Ptr parentNamespace = dynamic_pointer_cast<Namespace>(object->Parent());
+    auto object = MakeNode<Variable>(_arena, parent, SourceLocation(token), name, accessSpecifier, type);
+    UpdateStack(token, parentToken, object);
+    Namespace * parentNamespace = AsNamespace(object->Parent());
     if (parentNamespace != nullptr)
     {
         parentNamespace->Add(object);
@@ -460,19 +673,16 @@ Declaration::Ptr ASTCollection::AddFunction(CXCursor token, CXCursor parentToken
     std::string name = ConvertString(clang_getCursorSpelling(token));
     CXType functionType = clang_getCursorType(token);
     CXType resultType = clang_getResultType(functionType);
-    CXString resultTypeStr = clang_getTypeSpelling(resultType);
-    std::string type = ConvertString(resultTypeStr);
+    std::string type = ConvertString(clang_getTypeSpelling(resultType));
 
     int numArguments = clang_Cursor_getNumArguments(token);
     ParameterList parameters;
     for (int i = 0; i < numArguments; ++i)
     {
         CXCursor parameterToken = clang_Cursor_getArgument(token, i);
-        CXString parameterNameStr = clang_getCursorSpelling(parameterToken);
         CXType parameterTypeDecl = clang_getArgType(functionType, i);
-        CXString parameterTypeStr = clang_getTypeSpelling(parameterTypeDecl);
-        std::string parameterName = ConvertString(parameterNameStr);
-        std::string parameterType = ConvertString(parameterTypeStr);
+        std::string parameterName = ConvertString(clang_getCursorSpelling(parameterToken));
+        std::string parameterType = ConvertString(clang_getTypeSpelling(parameterTypeDecl));
 
         parameters.emplace_back(parameterName, parameterType);
     }
@@ -482,9 +692,9 @@ Declaration::Ptr ASTCollection::AddFunction(CXCursor token, CXCursor parentToken
     flags = static_cast<FunctionFlags>(flags | ((clang_CXXMethod_isPureVirtual(token) != 0) ? (FunctionFlags::PureVirtual | FunctionFlags::Virtual) : 0));
     flags = static_cast<FunctionFlags>(flags | ((clang_CXXMethod_isStatic(token) != 0) ? FunctionFlags::Static : 0));
 
-    auto object = make_shared<Function>(parent, SourceLocation(token), name, type, parameters, flags);
-    UpdateStack(token, parentToken);
-    Namespace::Ptr parentNamespace = dynamic_pointer_cast<Namespace>(object->Parent());
+    auto object = MakeNode<Function>(_arena, parent, SourceLocation(token), name, type, parameters, flags);
+    UpdateStack(token, parentToken, object);
+    Namespace * parentNamespace = AsNamespace(object->Parent());
     if (parentNamespace != nullptr)
     {
         parentNamespace->Add(object);
@@ -507,9 +717,11 @@ void ASTCollection::AddBaseClass(CXCursor token, CXCursor parentToken, Declarati
 
     CXType typeDecl = clang_getCursorType(token);
     CXType baseTypeDecl = clang_getCanonicalType(typeDecl);
+    std::string baseUSR = SymbolIndex::USR(baseTypeDecl);
 
-    auto inheritance = make_shared<Inheritance>(parent, SourceLocation(token), name, accessSpecifier, baseType, isVirtual);
-    Object::Ptr parentObject = dynamic_pointer_cast<Object>(parent);
+    auto inheritance = MakeNode<Inheritance>(_arena, parent, SourceLocation(token), name, accessSpecifier, baseType, isVirtual,
+                                             baseUSR);
+    Object * parentObject = AsObject(parent.get());
     if (parentObject != nullptr)
     {
         parentObject->AddBase(inheritance);
@@ -518,11 +730,11 @@ void ASTCollection::AddBaseClass(CXCursor token, CXCursor parentToken, Declarati
     {
         if (parent == nullptr)
         {
-            cerr << "Type is null. Type not supported yet?" << endl;
+            ErrorStream() << "Type is null. Type not supported yet?" << endl;
         }
         else
         {
-            cerr << "Type is not an object" <<  parent->Name() << endl;
+            ErrorStream() << "Type is not an object" <<  parent->Name() << endl;
         }
         return;
     }
@@ -534,19 +746,16 @@ Declaration::Ptr ASTCollection::AddFunctionTemplate(CXCursor token, CXCursor par
     std::string name = ConvertString(clang_getCursorSpelling(token));
     CXType functionType = clang_getCursorType(token);
     CXType resultType = clang_getResultType(functionType);
-    CXString resultTypeStr = clang_getTypeSpelling(resultType);
-    std::string type = ConvertString(resultTypeStr);
+    std::string type = ConvertString(clang_getTypeSpelling(resultType));
 
     int numArguments = clang_Cursor_getNumArguments(token);
     ParameterList parameters;
     for (int i = 0; i < numArguments; ++i)
     {
         CXCursor parameterToken = clang_Cursor_getArgument(token, i);
-        CXString parameterNameStr = clang_getCursorSpelling(parameterToken);
         CXType parameterTypeDecl = clang_getArgType(functionType, i);
-        CXString parameterTypeStr = clang_getTypeSpelling(parameterTypeDecl);
-        std::string parameterName = ConvertString(parameterNameStr);
-        std::string parameterType = ConvertString(parameterTypeStr);
+        std::string parameterName = ConvertString(clang_getCursorSpelling(parameterToken));
+        std::string parameterType = ConvertString(clang_getTypeSpelling(parameterTypeDecl));
 
         parameters.emplace_back(parameterName, parameterType);
     }
@@ -556,9 +765,9 @@ Declaration::Ptr ASTCollection::AddFunctionTemplate(CXCursor token, CXCursor par
     flags = static_cast<FunctionFlags>(flags | ((clang_CXXMethod_isPureVirtual(token) != 0) ? (FunctionFlags::PureVirtual | FunctionFlags::Virtual) : 0));
     flags = static_cast<FunctionFlags>(flags | ((clang_CXXMethod_isStatic(token) != 0) ? FunctionFlags::Static : 0));
 
-    auto object = make_shared<FunctionTemplate>(parent, SourceLocation(token), name, type, parameters, flags);
-    UpdateStack(token, parentToken);
-    Namespace::Ptr parentNamespace = dynamic_pointer_cast<Namespace>(object->Parent());
+    auto object = MakeNode<FunctionTemplate>(_arena, parent, SourceLocation(token), name, type, parameters, flags);
+    UpdateStack(token, parentToken, object);
+    Namespace * parentNamespace = AsNamespace(object->Parent());
     if (parentNamespace != nullptr)
     {
         parentNamespace->Add(object);
@@ -582,17 +791,17 @@ Declaration::Ptr ASTCollection::AddClassTemplate(CXCursor token, CXCursor parent
     if (FindClassTemplateByName(parent, name, object))
     {
         // If it already exists, we have a duplicate with a new token, and the same object with the new token
-        cout << "Class template already exists." << endl;
+        TRACE_LOG(TraceTreeBuild, TraceLevel::Info, "Class template already exists.");
         addNewObject = false;
     }
     else
     {
-        object = make_shared<ClassTemplate>(parent, SourceLocation(token), name, accessSpecifier);
+        object = MakeNode<ClassTemplate>(_arena, parent, SourceLocation(token), name, accessSpecifier);
     }
-    UpdateStack(token, parentToken);
+    UpdateStack(token, parentToken, object);
     if (addNewObject)
     {
-        Container::Ptr parentContainer = dynamic_pointer_cast<Container>(object->Parent());
+        Container * parentContainer = AsContainer(object->Parent());
         if (parentContainer != nullptr)
         {
             parentContainer->Add(object);
@@ -609,19 +818,35 @@ void ASTCollection::AddTemplateTypeParameter(CXCursor token, CXCursor parentToke
 {
     Declaration::Ptr parent = Find(parentToken);
     std::string name = ConvertString(clang_getCursorSpelling(token));
-    FunctionTemplate::Ptr functionTemplate = dynamic_pointer_cast<FunctionTemplate>(parent);
-    if (functionTemplate != nullptr)
+    if ((parent != nullptr) && (parent->Kind() == ElementKind::FunctionTemplate))
     {
-        functionTemplate->AddTemplateParameter(name);
+        static_cast<FunctionTemplate &>(*parent).AddTemplateParameter(name);
         return;
     }
-    ClassTemplate::Ptr classTemplate = dynamic_pointer_cast<ClassTemplate>(parent);
-    if (classTemplate != nullptr)
+    if ((parent != nullptr) && (parent->Kind() == ElementKind::ClassTemplate))
     {
-        classTemplate->AddTemplateParameter(name);
+        static_cast<ClassTemplate &>(*parent).AddTemplateParameter(name);
         return;
     }
-    cerr << "Panic! No function or class template" << endl;
+    ErrorStream() << "Panic! No function or class template" << endl;
+}
+
+void ASTCollection::AddInclude(CXCursor token, CXCursor parentToken)
+{
+    Declaration::Ptr parent = Find(parentToken);
+    // The spelling is the file name as written, without the quotes or angle brackets
+    std::string name = ConvertString(clang_getCursorSpelling(token));
+
+    auto object = MakeNode<IncludeDirective>(_arena, parent, SourceLocation(token), name, ConvertIncludeSpecifier(token));
+    Container * parentContainer = AsContainer(object->Parent());
+    if (parentContainer != nullptr)
+    {
+        parentContainer->Add(object);
+    }
+    else
+    {
+        Add(object);
+    }
 }
 
 void ASTCollection::ShowInfo()
@@ -631,12 +856,12 @@ void ASTCollection::ShowInfo()
     {
         CXCursor element = _stack.At(_stack.Count() - index - 1);
         CXCursorKind kind = clang_getCursorKind(element);
-        CXString strKind = clang_getCursorKindSpelling(kind);
+        ClangString strKind(clang_getCursorKindSpelling(kind));
         CXType type = clang_getCursorType(element);
-        CXString strType = clang_getTypeSpelling(type);
+        ClangString strType(clang_getTypeSpelling(type));
         CXType underlyingType = clang_getTypedefDeclUnderlyingType(element);
-        CXString strUnderlyingType = clang_getTypeSpelling(underlyingType);
-        CXString strName = clang_getCursorSpelling(element);
+        ClangString strUnderlyingType(clang_getTypeSpelling(underlyingType));
+        ClangString strName(clang_getCursorSpelling(element));
         if (kind < CXCursorKind::CXCursor_FirstInvalid)
         {
             switch (type.kind)
@@ -669,7 +894,7 @@ void ASTCollection::ShowInfo()
     }
 }
 
-void ASTCollection::UpdateStack(CXCursor token, CXCursor parentToken)
+void ASTCollection::UpdateStack(CXCursor token, CXCursor parentToken, const Declaration::Ptr & object)
 {
     ssize_t index = _stack.Find(parentToken);
     if (index > 0)
@@ -683,7 +908,7 @@ void ASTCollection::UpdateStack(CXCursor token, CXCursor parentToken)
         // Make sure parent cursor is at top of stack, remove any others
         _stack.RemoveTopElements(_stack.Count());
     }
-    _stack.Push(token);
+    _stack.Push(token, object);
 }
 
 } // namespace CPPParser
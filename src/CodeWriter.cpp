@@ -0,0 +1,92 @@
+#include "include/CodeWriter.h"
+
+#include <cstdio>
+
+using namespace std;
+
+namespace Utility
+{
+
+const size_t CodeWriter::DefaultChunkSize;
+const int CodeWriter::SpacesPerLevel;
+
+// Indentation for this many levels is copied in one go, deeper levels take more than one copy
+static const int IndentTableLevels = 32;
+static const std::string IndentTable(IndentTableLevels * CodeWriter::SpacesPerLevel, ' ');
+
+CodeWriter::CodeWriter(std::ostream & stream, size_t chunkSize)
+    : _stream(stream)
+    , _buffer()
+    , _chunkSize(chunkSize)
+    , _written()
+    , _lineLevel(-1)
+{
+    _buffer.reserve(_chunkSize + _chunkSize / 4);
+}
+
+CodeWriter::~CodeWriter()
+{
+    Flush();
+}
+
+CodeWriter & CodeWriter::Indent(int level)
+{
+    _lineLevel = (level < 0) ? 0 : level;
+    for (int remaining = _lineLevel; remaining > 0; remaining -= IndentTableLevels)
+    {
+        int levels = (remaining < IndentTableLevels) ? remaining : IndentTableLevels;
+        _buffer.append(IndentTable, 0, static_cast<size_t>(levels * SpacesPerLevel));
+    }
+    return *this;
+}
+
+CodeWriter & CodeWriter::EndLine()
+{
+    _buffer.push_back('\n');
+    if ((_lineLevel == 0) || (_buffer.size() >= _chunkSize))
+        Flush();
+    _lineLevel = -1;
+    return *this;
+}
+
+void CodeWriter::Flush()
+{
+    if (_buffer.empty())
+        return;
+    _stream.write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+    _written += _buffer.size();
+    _buffer.clear();
+}
+
+CodeWriter & CodeWriter::operator << (const char * value)
+{
+    if (value != nullptr)
+        _buffer.append(value);
+    return *this;
+}
+
+CodeWriter & CodeWriter::operator << (long long value)
+{
+    char text[24];
+    int length = snprintf(text, sizeof(text), "%lld", value);
+    _buffer.append(text, static_cast<size_t>(length));
+    return *this;
+}
+
+CodeWriter & CodeWriter::operator << (AccessSpecifier value)
+{
+    switch (value)
+    {
+        case AccessSpecifier::Private:
+            _buffer.append("private"); break;
+        case AccessSpecifier::Protected:
+            _buffer.append("protected"); break;
+        case AccessSpecifier::Public:
+            _buffer.append("public"); break;
+        default:
+            break;
+    }
+    return *this;
+}
+
+} // namespace Utility
@@ -16,167 +16,168 @@ using namespace Utility;
 namespace CPPParser
 {
 
-void Container::Add(const std::shared_ptr<Element> & value)
+Container::~Container()
 {
-    _contents.push_back(value);
-    Namespace::Ptr aNamespace = dynamic_pointer_cast<Namespace>(value);
-    if (aNamespace != nullptr)
-    {
-        AddNamespace(aNamespace);
-        return;
-    }
-    Class::Ptr aClass = dynamic_pointer_cast<Class>(value);
-    if (aClass != nullptr)
-    {
-        AddClass(aClass);
-        return;
-    }
-    Struct::Ptr aStruct = dynamic_pointer_cast<Struct>(value);
-    if (aStruct != nullptr)
-    {
-        AddStruct(aStruct);
-        return;
-    }
-    Enum::Ptr aEnum = dynamic_pointer_cast<Enum>(value);
-    if (aEnum != nullptr)
-    {
-        AddEnum(aEnum);
-        return;
-    }
-    Function::Ptr aFunction = dynamic_pointer_cast<Function>(value);
-    if (aFunction != nullptr)
+    for (auto const & element : _contents)
     {
-        AddFunction(aFunction);
-        return;
+        if (element->_parent == this)
+            element->_parent = nullptr;
     }
-    Typedef::Ptr aTypedef = dynamic_pointer_cast<Typedef>(value);
-    if (aTypedef != nullptr)
-    {
-        AddTypedef(aTypedef);
-        return;
-    }
-    Variable::Ptr aVariable = dynamic_pointer_cast<Variable>(value);
-    if (aVariable != nullptr)
-    {
-        AddVariable(aVariable);
-        return;
-    }
-    FunctionTemplate::Ptr aFunctionTemplate = dynamic_pointer_cast<FunctionTemplate>(value);
-    if (aFunctionTemplate != nullptr)
+}
+
+void Container::ResetQualifiedNames()
+{
+    Declaration::ResetQualifiedNames();
+    // The names of the elements below are built from this one
+    for (auto const & element : _contents)
     {
-        AddFunctionTemplate(aFunctionTemplate);
-        return;
+        element->ResetQualifiedNames();
     }
-    ClassTemplate::Ptr aClassTemplate = dynamic_pointer_cast<ClassTemplate>(value);
-    if (aClassTemplate != nullptr)
+}
+
+void Container::Add(const std::shared_ptr<Element> & value)
+{
+    _contents.push_back(value);
+    switch (value->Kind())
     {
-        AddClassTemplate(aClassTemplate);
-        return;
+        case ElementKind::Namespace:
+            AddNamespace(static_pointer_cast<Namespace>(value));
+            break;
+        case ElementKind::Class:
+            AddClass(static_pointer_cast<Class>(value));
+            break;
+        case ElementKind::Struct:
+            AddStruct(static_pointer_cast<Struct>(value));
+            break;
+        case ElementKind::Enum:
+            AddEnum(static_pointer_cast<Enum>(value));
+            break;
+        case ElementKind::Function:
+            AddFunction(static_pointer_cast<Function>(value));
+            break;
+        case ElementKind::Typedef:
+            AddTypedef(static_pointer_cast<Typedef>(value));
+            break;
+        case ElementKind::Variable:
+            AddVariable(static_pointer_cast<Variable>(value));
+            break;
+        case ElementKind::FunctionTemplate:
+            AddFunctionTemplate(static_pointer_cast<FunctionTemplate>(value));
+            break;
+        case ElementKind::ClassTemplate:
+            AddClassTemplate(static_pointer_cast<ClassTemplate>(value));
+            break;
+        default:
+            break;
     }
 }
 
+template<class T>
+void Container::AddElement(PtrList<T> & list, const std::shared_ptr<T> & value)
+{
+    _nameIndex.insert({NameKey {value->Kind(), &value->Name()}, list.size()});
+    list.push_back(value);
+}
+
+template<class T>
+bool Container::FindElement(ElementKind kind, const PtrList<T> & list, const std::string & name, std::shared_ptr<T> & result) const
+{
+    result = {};
+    auto it = _nameIndex.find(NameKey {kind, &name});
+    if (it == _nameIndex.end())
+        return false;
+    result = list[it->second];
+    return true;
+}
+
 void Container::AddNamespace(const Namespace::Ptr & value)
 {
-    _namespaces.push_back(value);
+    AddElement(_namespaces, value);
 }
 
 void Container::AddClass(const std::shared_ptr<Class> & value)
 {
-    _classes.push_back(value);
+    AddElement(_classes, value);
 }
 
 void Container::AddStruct(const std::shared_ptr<Struct> & value)
 {
-    _structs.push_back(value);
+    AddElement(_structs, value);
 }
 
 void Container::AddEnum(const std::shared_ptr<Enum> & value)
 {
-    _enums.push_back(value);
+    AddElement(_enums, value);
 }
 
 void Container::AddFunction(const std::shared_ptr<Function> & value)
 {
-    _functions.push_back(value);
+    AddElement(_functions, value);
 }
 
 void Container::AddTypedef(const std::shared_ptr<Typedef> & value)
 {
-    _typedefs.push_back(value);
+    AddElement(_typedefs, value);
 }
 
 void Container::AddVariable(const std::shared_ptr<Variable> & value)
 {
-    _variables.push_back(value);
+    AddElement(_variables, value);
 }
 
 void Container::AddFunctionTemplate(const std::shared_ptr<FunctionTemplate> & value)
 {
-    _functionTemplates.push_back(value);
+    AddElement(_functionTemplates, value);
 }
 
 void Container::AddClassTemplate(const std::shared_ptr<ClassTemplate> & value)
 {
-    _classTemplates.push_back(value);
+    AddElement(_classTemplates, value);
 }
 
-template<class T>
-bool FindElement(std::vector<std::shared_ptr<T>> & list, const std::string & name, std::shared_ptr<T> & result)
-{
-    result = {};
-    for (auto const & item : list)
-    {
-        if (item->Name() == name)
-        {
-            result = item;
-            return true;
-        }
-    }
-    return false;
-}
 bool Container::FindNamespace(const std::string & name, std::shared_ptr<Namespace> & result)
 {
-    return FindElement(_namespaces, name, result);
+    return FindElement(ElementKind::Namespace, _namespaces, name, result);
 }
 
 bool Container::FindClass(const std::string & name, std::shared_ptr<Class> & result)
 {
-    return FindElement(_classes, name, result);
+    return FindElement(ElementKind::Class, _classes, name, result);
 }
 
 bool Container::FindStruct(const std::string & name, std::shared_ptr<Struct> & result)
 {
-    return FindElement(_structs, name, result);
+    return FindElement(ElementKind::Struct, _structs, name, result);
 }
 
 bool Container::FindClassTemplate(const std::string & name, std::shared_ptr<ClassTemplate> & result)
 {
-    return FindElement(_classTemplates, name, result);
+    return FindElement(ElementKind::ClassTemplate, _classTemplates, name, result);
 }
 
 bool Container::FindEnum(const std::string & name, std::shared_ptr<Enum> & result)
 {
-    return FindElement(_enums, name, result);
+    return FindElement(ElementKind::Enum, _enums, name, result);
 }
 
 bool Container::FindFunction(const std::string & name, std::shared_ptr<Function> & result)
 {
-    return FindElement(_functions, name, result);
+    return FindElement(ElementKind::Function, _functions, name, result);
 }
 
 bool Container::FindTypedef(const std::string & name, std::shared_ptr<Typedef> & result)
 {
-    return FindElement(_typedefs, name, result);
+    return FindElement(ElementKind::Typedef, _typedefs, name, result);
 }
 
 bool Container::FindVariable(const std::string & name, std::shared_ptr<Variable> & result)
 {
-    return FindElement(_variables, name, result);
+    return FindElement(ElementKind::Variable, _variables, name, result);
 }
 
 bool Container::FindFunctionTemplate(const std::string & name, std::shared_ptr<FunctionTemplate> & result)
 {
-    return FindElement(_functionTemplates, name, result);
+    return FindElement(ElementKind::FunctionTemplate, _functionTemplates, name, result);
 }
 
 } // namespace CPPParser
@@ -0,0 +1,174 @@
+#include "include/DeclarationStream.h"
+
+using namespace std;
+using namespace Utility;
+
+namespace CPPParser
+{
+
+static ParameterList ReadParameters(CXCursor token)
+{
+    CXType functionType = clang_getCursorType(token);
+    int numArguments = clang_Cursor_getNumArguments(token);
+    ParameterList parameters;
+    for (int i = 0; i < numArguments; ++i)
+    {
+        CXCursor parameterToken = clang_Cursor_getArgument(token, i);
+        CXType parameterTypeDecl = clang_getArgType(functionType, i);
+        std::string parameterName = ConvertString(clang_getCursorSpelling(parameterToken));
+        std::string parameterType = ConvertString(clang_getTypeSpelling(parameterTypeDecl));
+
+        parameters.emplace_back(parameterName, parameterType);
+    }
+    return parameters;
+}
+
+static FunctionFlags ReadFunctionFlags(CXCursor token)
+{
+    FunctionFlags flags {};
+    flags = static_cast<FunctionFlags>(flags | ((clang_CXXMethod_isConst(token) != 0) ? FunctionFlags::Const : 0));
+    flags = static_cast<FunctionFlags>(flags | ((clang_CXXMethod_isVirtual(token) != 0) ? FunctionFlags::Virtual : 0));
+    flags = static_cast<FunctionFlags>(flags | ((clang_CXXMethod_isPureVirtual(token) != 0) ? (FunctionFlags::PureVirtual | FunctionFlags::Virtual) : 0));
+    flags = static_cast<FunctionFlags>(flags | ((clang_CXXMethod_isStatic(token) != 0) ? FunctionFlags::Static : 0));
+    return flags;
+}
+
+DeclarationStream::DeclarationStream(IDeclarationListener & listener)
+    : _listener(listener)
+    , _stack()
+{
+}
+
+bool DeclarationStream::IsDeclarationKind(CXCursorKind kind, ElementKind & elementKind)
+{
+    // The cursors for which the trees create a declaration, see Parser::HandleToken()
+    switch (kind)
+    {
+        case CXCursorKind::CXCursor_Namespace:          elementKind = ElementKind::Namespace; break;
+        case CXCursorKind::CXCursor_ClassDecl:          elementKind = ElementKind::Class; break;
+        case CXCursorKind::CXCursor_StructDecl:         elementKind = ElementKind::Struct; break;
+        case CXCursorKind::CXCursor_ClassTemplate:      elementKind = ElementKind::ClassTemplate; break;
+        case CXCursorKind::CXCursor_EnumDecl:           elementKind = ElementKind::Enum; break;
+        case CXCursorKind::CXCursor_TypedefDecl:        elementKind = ElementKind::Typedef; break;
+        case CXCursorKind::CXCursor_VarDecl:            elementKind = ElementKind::Variable; break;
+        case CXCursorKind::CXCursor_FieldDecl:          elementKind = ElementKind::DataMember; break;
+        case CXCursorKind::CXCursor_Constructor:        elementKind = ElementKind::Constructor; break;
+        case CXCursorKind::CXCursor_Destructor:         elementKind = ElementKind::Destructor; break;
+        case CXCursorKind::CXCursor_CXXMethod:          elementKind = ElementKind::Method; break;
+        case CXCursorKind::CXCursor_FunctionDecl:       elementKind = ElementKind::Function; break;
+        case CXCursorKind::CXCursor_FunctionTemplate:   elementKind = ElementKind::FunctionTemplate; break;
+        default:
+            return false;
+    }
+    return true;
+}
+
+void DeclarationStream::HandleToken(CXCursor token, CXCursor parentToken)
+{
+    CXCursorKind kind = clang_getCursorKind(token);
+    ElementKind elementKind;
+    if (IsDeclarationKind(kind, elementKind))
+    {
+        LeaveScopes(parentToken);
+        Enter(token, elementKind);
+        return;
+    }
+    switch (kind)
+    {
+        case CXCursorKind::CXCursor_EnumConstantDecl:
+            LeaveScopes(parentToken);
+            _listener.EnumValue(EnumConstant(token));
+            break;
+        case CXCursorKind::CXCursor_CXXBaseSpecifier:
+            LeaveScopes(parentToken);
+            _listener.BaseClass(SourceLocation(token), ConvertString(clang_getCursorSpelling(token)),
+                                ConvertAccessSpecifier(clang_getCXXAccessSpecifier(token)),
+                                clang_isVirtualBase(token) != 0);
+            break;
+        case CXCursorKind::CXCursor_TemplateTypeParameter:
+            LeaveScopes(parentToken);
+            _listener.TemplateParameter(ConvertString(clang_getCursorSpelling(token)));
+            break;
+        default:
+            break;
+    }
+}
+
+void DeclarationStream::Finish()
+{
+    LeaveTop(_stack.Count());
+}
+
+void DeclarationStream::LeaveScopes(CXCursor parentToken)
+{
+    // Cursors that are not reported, such as a linkage specification, may lie between the parent and the declaration
+    // that encloses it, so look for the nearest enclosing cursor on the stack
+    CXCursor scope = parentToken;
+    ssize_t index = _stack.Find(scope);
+    while ((index < 0) && (clang_Cursor_isNull(scope) == 0) &&
+           (clang_getCursorKind(scope) != CXCursorKind::CXCursor_TranslationUnit))
+    {
+        scope = clang_getCursorLexicalParent(scope);
+        index = _stack.Find(scope);
+    }
+    LeaveTop((index >= 0) ? static_cast<size_t>(index) : _stack.Count());
+}
+
+void DeclarationStream::LeaveTop(size_t count)
+{
+    for (size_t index = 0; (index < count) && (_stack.Count() > 0); ++index)
+    {
+        _listener.Leave(_stack.ValueAt(0));
+        _stack.RemoveTopElements(1);
+    }
+}
+
+void DeclarationStream::Enter(CXCursor token, ElementKind kind)
+{
+    DeclarationEvent declaration;
+    declaration.kind = kind;
+    declaration.sourceLocation = SourceLocation(token);
+    declaration.name = ConvertString(clang_getCursorSpelling(token));
+    if (kind != ElementKind::Namespace)
+        declaration.accessSpecifier = ConvertAccessSpecifier(clang_getCXXAccessSpecifier(token));
+    switch (kind)
+    {
+        case ElementKind::Enum:
+        {
+            CXType type = clang_getEnumDeclIntegerType(token);
+            if (type.kind != CXType_UInt)
+                declaration.type = ConvertString(clang_getTypeSpelling(type));
+            break;
+        }
+        case ElementKind::Typedef:
+            declaration.type = ConvertString(clang_getTypeSpelling(clang_getTypedefDeclUnderlyingType(token)));
+            break;
+        case ElementKind::Variable:
+        case ElementKind::DataMember:
+            declaration.type = ConvertString(clang_getTypeSpelling(clang_getCursorType(token)));
+            break;
+        case ElementKind::Constructor:
+            declaration.parameters = ReadParameters(token);
+            declaration.flags = ReadFunctionFlags(token);
+            break;
+        case ElementKind::Destructor:
+            declaration.flags = ReadFunctionFlags(token);
+            break;
+        case ElementKind::Function:
+        case ElementKind::FunctionTemplate:
+            // Free functions have no access specifier, as in the trees
+            declaration.accessSpecifier = AccessSpecifier::Invalid;
+            // fall through
+        case ElementKind::Method:
+            declaration.type = ConvertString(clang_getTypeSpelling(clang_getResultType(clang_getCursorType(token))));
+            declaration.parameters = ReadParameters(token);
+            declaration.flags = ReadFunctionFlags(token);
+            break;
+        default:
+            break;
+    }
+    _listener.Enter(declaration);
+    _stack.Push(token, std::move(declaration));
+}
+
+} // namespace CPPParser
@@ -0,0 +1,132 @@
+#include "include/InternedString.h"
+
+using namespace std;
+
+namespace Utility
+{
+
+static thread_local std::shared_ptr<StringPool> currentPool;
+
+const size_t StringPool::ShardCount;
+
+StringPool::StringPool()
+    : _shards()
+{
+}
+
+const std::string * StringPool::Intern(const std::string & value)
+{
+    Shard & shard = ShardOf(value);
+    std::lock_guard<std::mutex> lock(shard.lock);
+    auto result = shard.strings.insert(value);
+    if (result.second)
+        shard.size += value.length();
+    return &*result.first;
+}
+
+const std::string * StringPool::Find(const std::string & value) const
+{
+    const Shard & shard = ShardOf(value);
+    std::lock_guard<std::mutex> lock(shard.lock);
+    auto it = shard.strings.find(value);
+    return (it != shard.strings.end()) ? &*it : nullptr;
+}
+
+size_t StringPool::Count() const
+{
+    size_t result = 0;
+    for (auto const & shard : _shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.lock);
+        result += shard.strings.size();
+    }
+    return result;
+}
+
+size_t StringPool::Size() const
+{
+    size_t result = 0;
+    for (auto const & shard : _shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.lock);
+        result += shard.size;
+    }
+    return result;
+}
+
+StringPool::Scope::Scope(std::shared_ptr<StringPool> pool)
+    : _previous(std::move(currentPool))
+{
+    currentPool = std::move(pool);
+}
+
+StringPool::Scope::~Scope()
+{
+    currentPool = std::move(_previous);
+}
+
+const std::shared_ptr<StringPool> & StringPool::Current()
+{
+    return currentPool;
+}
+
+StringPool & StringPool::Default()
+{
+    // Never destroyed, so handles held by static objects stay valid during exit
+    static StringPool * pool = new StringPool();
+    return *pool;
+}
+
+static StringPool & ActivePool()
+{
+    StringPool * pool = StringPool::Current().get();
+    return (pool != nullptr) ? *pool : StringPool::Default();
+}
+
+// The empty string is not kept in any pool, so it stays valid whichever pool is released
+static const std::string * EmptyString()
+{
+    static const std::string * empty = new std::string();
+    return empty;
+}
+
+InternedString::InternedString()
+    : _value(EmptyString())
+{
+}
+
+InternedString::InternedString(const std::string & value)
+    : _value(value.empty() ? EmptyString() : ActivePool().Intern(value))
+{
+}
+
+InternedString::InternedString(const char * value)
+    : _value(((value == nullptr) || (*value == '\0')) ? EmptyString() : ActivePool().Intern(value))
+{
+}
+
+bool InternedString::Find(const std::string & value, InternedString & result)
+{
+    if (value.empty())
+    {
+        result._value = EmptyString();
+        return true;
+    }
+    const std::string * pooled = ActivePool().Find(value);
+    if (pooled == nullptr)
+        return false;
+    result._value = pooled;
+    return true;
+}
+
+size_t InternedString::PoolCount()
+{
+    return ActivePool().Count();
+}
+
+size_t InternedString::PoolSize()
+{
+    return ActivePool().Size();
+}
+
+} // namespace Utility
@@ -0,0 +1,262 @@
+#include "include/MemoryUsage.h"
+
+#include <unordered_set>
+#include "include/AST.h"
+#include "include/ASTCollection.h"
+#include "include/ClassTemplate.h"
+#include "include/Function.h"
+#include "include/NodeArena.h"
+#include "include/PreprocessorDirectives.h"
+#include "include/Typedef.h"
+#include "include/Variable.h"
+
+using namespace std;
+using namespace Utility;
+
+namespace CPPParser
+{
+
+// Nodes are created with MakeNode, which puts the control block next to the node: a virtual table pointer, two reference
+// counts, and the allocator, which points to the arena
+static const size_t ControlBlockSize = sizeof(void *) + 2 * sizeof(int) + sizeof(NodeAllocator<Element>);
+
+// Walks a tree, keeping the strings already counted, so pooled strings are counted once
+class MemoryWalker
+{
+public:
+    explicit MemoryWalker(MemoryUsage & usage)
+        : _usage(usage)
+        , _strings()
+    {}
+
+    void Add(const Element & element)
+    {
+        size_t size = ControlBlockSize + NodeSize(element);
+        AddString(_usage.strings, element.Name());
+        AddString(_usage.fileNames, element.Location().fileName);
+        size_t index = static_cast<size_t>(element.Kind());
+        if (index >= _usage.nodes.size())
+            _usage.nodes.resize(index + 1);
+        _usage.nodes[index].Add(size);
+
+        if (IsContainer(element.Kind()))
+        {
+            for (auto const & child : static_cast<const Container &>(element).Contents())
+            {
+                Add(*child);
+            }
+        }
+    }
+
+private:
+    MemoryUsage & _usage;
+    std::unordered_set<const std::string *> _strings;
+
+    void AddString(MemoryCount & count, const std::string & value)
+    {
+        if (_strings.insert(&value).second)
+            count.Add(StringMemory(value));
+    }
+    // Size of the string, or zero if it was counted before
+    size_t NewStringMemory(const std::string & value)
+    {
+        return _strings.insert(&value).second ? StringMemory(value) : 0;
+    }
+
+    static bool IsContainer(ElementKind kind)
+    {
+        switch (kind)
+        {
+            case ElementKind::AST:
+            case ElementKind::ASTCollection:
+            case ElementKind::Namespace:
+            case ElementKind::Class:
+            case ElementKind::Struct:
+            case ElementKind::ClassTemplate:
+            case ElementKind::IfdefDirective:
+            case ElementKind::IfDirective:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    template<class T>
+    static size_t ListSize(const std::vector<T> & list)
+    {
+        return list.capacity() * sizeof(T);
+    }
+
+    static size_t ContainerSize(const Container & container)
+    {
+        return ListSize(container.Contents()) + ListSize(container.Namespaces()) + ListSize(container.Classes()) +
+               ListSize(container.Structs()) + ListSize(container.ClassTemplates()) + ListSize(container.Enums()) +
+               ListSize(container.Functions()) + ListSize(container.Typedefs()) + ListSize(container.Variables()) +
+               ListSize(container.FunctionTemplates()) + container.NameIndexMemorySize();
+    }
+
+    size_t ObjectSize(const Object & object)
+    {
+        size_t result = ContainerSize(object) + ListSize(object.Constructors()) + ListSize(object.Destructors()) +
+                        ListSize(object.Methods()) + ListSize(object.DataMembers()) + ListSize(object.BaseTypes());
+        for (auto const & baseType : object.BaseTypes())
+        {
+            result += ControlBlockSize + sizeof(Inheritance);
+            AddString(_usage.strings, baseType->Name());
+        }
+        return result;
+    }
+
+    static size_t TemplateParametersSize(const std::vector<std::string> & parameters)
+    {
+        size_t result = parameters.capacity() * sizeof(std::string);
+        for (auto const & parameter : parameters)
+        {
+            result += StringMemory(parameter) - sizeof(std::string);
+        }
+        return result;
+    }
+
+    // Parameters are counted on their own, not with the function holding them
+    void AddFunction(const FunctionBase & function)
+    {
+        AddString(_usage.strings, function.Type());
+        _usage.parameters.count += function.Parameters().size();
+        _usage.parameters.bytes += ListSize(function.Parameters());
+        for (auto const & parameter : function.Parameters())
+        {
+            _usage.parameters.bytes += NewStringMemory(parameter.Name()) + NewStringMemory(parameter.Type());
+        }
+    }
+
+    size_t NodeSize(const Element & element)
+    {
+        switch (element.Kind())
+        {
+            case ElementKind::AST:
+                return sizeof(AST) + ContainerSize(static_cast<const AST &>(element));
+            case ElementKind::ASTCollection:
+                return sizeof(ASTCollection) + ContainerSize(static_cast<const ASTCollection &>(element));
+            case ElementKind::Namespace:
+                return sizeof(Namespace) + ContainerSize(static_cast<const Namespace &>(element));
+            case ElementKind::Class:
+                return sizeof(Class) + ObjectSize(static_cast<const Class &>(element));
+            case ElementKind::Struct:
+                return sizeof(Struct) + ObjectSize(static_cast<const Struct &>(element));
+            case ElementKind::ClassTemplate:
+            {
+                auto const & classTemplate = static_cast<const ClassTemplate &>(element);
+                return sizeof(ClassTemplate) + ObjectSize(classTemplate) +
+                       TemplateParametersSize(classTemplate.TemplateParameters());
+            }
+            case ElementKind::Enum:
+            {
+                auto const & anEnum = static_cast<const Enum &>(element);
+                AddString(_usage.strings, anEnum.Type());
+                for (auto const & value : anEnum.Values())
+                {
+                    AddString(_usage.strings, value.Name());
+                }
+                return sizeof(Enum) + ListSize(anEnum.Values());
+            }
+            case ElementKind::Typedef:
+                AddString(_usage.strings, static_cast<const Typedef &>(element).Type());
+                return sizeof(Typedef);
+            case ElementKind::Variable:
+                AddString(_usage.strings, static_cast<const Variable &>(element).Type());
+                return sizeof(Variable);
+            case ElementKind::DataMember:
+                AddString(_usage.strings, static_cast<const DataMember &>(element).Type());
+                return sizeof(DataMember);
+            case ElementKind::Constructor:
+                AddFunction(static_cast<const Constructor &>(element));
+                return sizeof(Constructor);
+            case ElementKind::Destructor:
+                AddFunction(static_cast<const Destructor &>(element));
+                return sizeof(Destructor);
+            case ElementKind::Method:
+                AddFunction(static_cast<const Method &>(element));
+                return sizeof(Method);
+            case ElementKind::Function:
+                AddFunction(static_cast<const Function &>(element));
+                return sizeof(Function);
+            case ElementKind::FunctionTemplate:
+            {
+                auto const & functionTemplate = static_cast<const FunctionTemplate &>(element);
+                AddFunction(functionTemplate);
+                return sizeof(FunctionTemplate) + TemplateParametersSize(functionTemplate.TemplateParameters());
+            }
+            case ElementKind::IncludeDirective:
+                return sizeof(IncludeDirective);
+            case ElementKind::IfdefDirective:
+                return sizeof(IfdefDirective) + ContainerSize(static_cast<const IfdefDirective &>(element));
+            case ElementKind::IfDirective:
+                return sizeof(IfDirective) + ContainerSize(static_cast<const IfDirective &>(element));
+            case ElementKind::DefineDirective:
+                return sizeof(DefineDirective);
+            case ElementKind::UndefDirective:
+                return sizeof(UndefDirective);
+        }
+        return 0;
+    }
+};
+
+MemoryUsage & MemoryUsage::operator += (const MemoryUsage & other)
+{
+    if (nodes.size() < other.nodes.size())
+        nodes.resize(other.nodes.size());
+    for (size_t index = 0; index < other.nodes.size(); ++index)
+    {
+        nodes[index] += other.nodes[index];
+    }
+    parameters += other.parameters;
+    fileNames += other.fileNames;
+    strings += other.strings;
+    lookupMaps += other.lookupMaps;
+    symbols += other.symbols;
+    translationUnits += other.translationUnits;
+    return *this;
+}
+
+void MemoryUsage::AddTree(const Container & tree)
+{
+    MemoryWalker walker(*this);
+    walker.Add(tree);
+}
+
+void MemoryUsage::AddTranslationUnit(CXTranslationUnit unit)
+{
+    CXTUResourceUsage usage = clang_getCXTUResourceUsage(unit);
+    size_t size = 0;
+    for (unsigned index = 0; index < usage.numEntries; ++index)
+    {
+        size += usage.entries[index].amount;
+    }
+    clang_disposeCXTUResourceUsage(usage);
+    translationUnits.Add(size);
+}
+
+const MemoryCount & MemoryUsage::Nodes(ElementKind kind) const
+{
+    static const MemoryCount none;
+    size_t index = static_cast<size_t>(kind);
+    return (index < nodes.size()) ? nodes[index] : none;
+}
+
+MemoryCount MemoryUsage::Total() const
+{
+    MemoryCount result;
+    for (auto const & count : nodes)
+    {
+        result += count;
+    }
+    result += parameters;
+    result += fileNames;
+    result += strings;
+    result += lookupMaps;
+    result += symbols;
+    result += translationUnits;
+    return result;
+}
+
+} // namespace CPPParser
@@ -0,0 +1,97 @@
+#include "include/NodeArena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+using namespace std;
+
+namespace CPPParser
+{
+
+const size_t NodeArena::BlockSize;
+
+NodeArena::NodeArena()
+    : _blocks()
+    , _current()
+    , _end()
+    , _bytesAllocated()
+    , _stringPools()
+{
+    AddStringPool(Utility::StringPool::Current());
+}
+
+NodeArena::~NodeArena()
+{
+    for (auto block : _blocks)
+        delete [] block;
+}
+
+void NodeArena::AddStringPool(const std::shared_ptr<Utility::StringPool> & pool)
+{
+    if ((pool != nullptr) && (std::find(_stringPools.begin(), _stringPools.end(), pool) == _stringPools.end()))
+        _stringPools.push_back(pool);
+}
+
+void NodeArena::AddStringPools(const NodeArena & other)
+{
+    for (auto const & pool : other._stringPools)
+    {
+        AddStringPool(pool);
+    }
+}
+
+void * NodeArena::Allocate(size_t size, size_t alignment)
+{
+    _bytesAllocated += size;
+    // Allocations that would take more than a quarter of a block get a block of their own, so they do not waste the
+    // remainder of the current one
+    if (size + alignment > BlockSize / 4)
+        return Align(AddBlock(size + alignment), alignment);
+    char * result = Align(_current, alignment);
+    if ((_current == nullptr) || (result + size > _end))
+    {
+        _current = AddBlock(BlockSize);
+        _end = _current + BlockSize;
+        result = Align(_current, alignment);
+    }
+    _current = result + size;
+    return result;
+}
+
+char * NodeArena::Align(char * address, size_t alignment)
+{
+    uintptr_t value = reinterpret_cast<uintptr_t>(address);
+    return reinterpret_cast<char *>((value + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1));
+}
+
+char * NodeArena::AddBlock(size_t size)
+{
+    char * block = new char[size];
+    _blocks.push_back(block);
+    return block;
+}
+
+NodeArenaOwner::NodeArenaOwner()
+    : _arena(make_shared<NodeArena>())
+    , _linkedArenas()
+{
+}
+
+void NodeArenaOwner::LinkArena(const std::shared_ptr<NodeArena> & arena)
+{
+    if ((arena == nullptr) || (arena == _arena))
+        return;
+    if (std::find(_linkedArenas.begin(), _linkedArenas.end(), arena) == _linkedArenas.end())
+        _linkedArenas.push_back(arena);
+}
+
+void NodeArenaOwner::LinkArenas(const NodeArenaOwner & other)
+{
+    LinkArena(other._arena);
+    for (auto const & arena : other._linkedArenas)
+    {
+        LinkArena(arena);
+    }
+}
+
+} // namespace CPPParser
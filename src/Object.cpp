@@ -9,32 +9,34 @@ using namespace Utility;
 namespace CPPParser
 {
 
-void Object::Add(const Element::Ptr & value)
+Object::~Object()
 {
-    Container::Add(value);
-    Constructor::Ptr aConstructor = dynamic_pointer_cast<Constructor>(value);
-    if (aConstructor != nullptr)
-    {
-        AddConstructor(aConstructor);
-        return;
-    }
-    Destructor::Ptr aDestructor = dynamic_pointer_cast<Destructor>(value);
-    if (aDestructor != nullptr)
-    {
-        AddDestructor(aDestructor);
-        return;
-    }
-    Method::Ptr aMethod = dynamic_pointer_cast<Method>(value);
-    if (aMethod != nullptr)
+    for (auto const & baseType : _baseTypes)
     {
-        AddMethod(aMethod);
-        return;
+        if (baseType->_parent == this)
+            baseType->_parent = nullptr;
     }
-    DataMember::Ptr aDataMember = dynamic_pointer_cast<DataMember>(value);
-    if (aDataMember != nullptr)
+}
+
+void Object::Add(const Element::Ptr & value)
+{
+    Container::Add(value);
+    switch (value->Kind())
     {
-        AddDataMember(aDataMember);
-        return;
+        case ElementKind::Constructor:
+            AddConstructor(static_pointer_cast<Constructor>(value));
+            break;
+        case ElementKind::Destructor:
+            AddDestructor(static_pointer_cast<Destructor>(value));
+            break;
+        case ElementKind::Method:
+            AddMethod(static_pointer_cast<Method>(value));
+            break;
+        case ElementKind::DataMember:
+            AddDataMember(static_pointer_cast<DataMember>(value));
+            break;
+        default:
+            break;
     }
 }
 
@@ -0,0 +1,692 @@
+#include "include/ParseCache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+#include "include/PreprocessorDirectives.h"
+#include "include/Trace.h"
+#include "include/Typedef.h"
+#include "include/Variable.h"
+
+using namespace std;
+using namespace Utility;
+
+namespace CPPParser
+{
+
+// Change the format name whenever the entry layout or the extracted model changes, to invalidate existing entries.
+static const std::string CacheFormat = "PSGenerator-parse-cache-4";
+static const std::string EntryExtension = ".pscache";
+
+// Strings are written as <length>:<characters>, so they may hold any character, including white space.
+static void WriteString(std::ostream & stream, const std::string & value)
+{
+    stream << ' ' << value.size() << ':' << value;
+}
+
+static bool ReadString(std::istream & stream, std::string & value)
+{
+    size_t size {};
+    if (!(stream >> size) || (stream.get() != ':'))
+        return false;
+    value.resize(size);
+    return (size == 0) || stream.read(&value[0], static_cast<std::streamsize>(size));
+}
+
+static void WriteLocation(std::ostream & stream, const SourceLocation & location)
+{
+    WriteString(stream, location.fileName);
+    stream << ' ' << location.line << ' ' << location.column << ' ' << location.fileOffset;
+}
+
+static bool ReadLocation(std::istream & stream, SourceLocation & location)
+{
+    std::string fileName;
+    if (!ReadString(stream, fileName))
+        return false;
+    location.fileName = fileName;
+    return static_cast<bool>(stream >> location.line >> location.column >> location.fileOffset);
+}
+
+static bool ReadAccessSpecifier(std::istream & stream, AccessSpecifier & accessSpecifier)
+{
+    int value {};
+    if (!(stream >> value))
+        return false;
+    accessSpecifier = static_cast<AccessSpecifier>(value);
+    return true;
+}
+
+static bool ReadIncludeSpecifier(std::istream & stream, IncludeSpecifier & includeSpecifier)
+{
+    int value {};
+    if (!(stream >> value))
+        return false;
+    includeSpecifier = static_cast<IncludeSpecifier>(value);
+    return true;
+}
+
+static void WriteStrings(std::ostream & stream, const std::vector<std::string> & values)
+{
+    stream << ' ' << values.size();
+    for (auto const & value : values)
+    {
+        WriteString(stream, value);
+    }
+}
+
+static bool ReadStrings(std::istream & stream, std::vector<std::string> & values)
+{
+    size_t count {};
+    if (!(stream >> count))
+        return false;
+    values.resize(count);
+    for (auto & value : values)
+    {
+        if (!ReadString(stream, value))
+            return false;
+    }
+    return true;
+}
+
+// Writes the tree in source order. Every element is preceded by the index of its parent, and base types refer to
+// their declaration by index, where elements are numbered in the order they are written, starting at 0.
+// A base type declared in another tree has index -1, and is kept by its USR, so it can be resolved again after loading.
+// The tree is followed by the type symbols declared in it, as pairs of element index and USR.
+class TreeWriter
+{
+public:
+    explicit TreeWriter(std::ostream & stream)
+        : _stream(stream)
+        , _indices()
+        , _complete(true)
+    {}
+
+    bool Write(const AST & ast, const SymbolIndex * symbols)
+    {
+        Number(ast);
+        WriteContents(ast);
+        WriteSymbols(symbols);
+        return _complete;
+    }
+
+private:
+    std::ostream & _stream;
+    std::map<const Element *, long long> _indices;
+    bool _complete;
+
+    void Number(const Container & container)
+    {
+        for (auto const & element : container.Contents())
+        {
+            long long index = static_cast<long long>(_indices.size());
+            _indices.insert({element.get(), index});
+            const Container * childContainer = dynamic_cast<const Container *>(element.get());
+            if (childContainer != nullptr)
+                Number(*childContainer);
+        }
+    }
+
+    long long Index(const Element * element) const
+    {
+        auto it = _indices.find(element);
+        return (it != _indices.end()) ? it->second : -1;
+    }
+
+    // Symbols of types declared in other trees are left out; they are found in the entries of those trees.
+    // Sorted by index, so the same tree always gives the same entry.
+    void WriteSymbols(const SymbolIndex * symbols)
+    {
+        std::vector<std::pair<long long, std::string>> declared;
+        if (symbols != nullptr)
+        {
+            for (auto const & symbol : symbols->Entries())
+            {
+                long long index = Index(symbol.second.get());
+                if (index >= 0)
+                    declared.emplace_back(index, symbol.first);
+            }
+        }
+        std::sort(declared.begin(), declared.end());
+        _stream << declared.size();
+        for (auto const & symbol : declared)
+        {
+            _stream << ' ' << symbol.first;
+            WriteString(_stream, symbol.second);
+        }
+        _stream << endl;
+    }
+
+    void WriteContents(const Container & container)
+    {
+        _stream << ' ' << container.Contents().size() << endl;
+        for (auto const & element : container.Contents())
+        {
+            WriteElement(*element);
+        }
+    }
+
+    void WriteCommon(const char * tag, const Element & element)
+    {
+        _stream << tag << ' ' << Index(element.Parent());
+        WriteString(_stream, element.Name());
+        _stream << ' ' << static_cast<int>(element.Access());
+        WriteLocation(_stream, element.Location());
+    }
+
+    void WriteObject(const Object & object)
+    {
+        _stream << ' ' << object.BaseTypes().size();
+        for (auto const & base : object.BaseTypes())
+        {
+            WriteString(_stream, base->Name());
+            _stream << ' ' << static_cast<int>(base->Access());
+            WriteLocation(_stream, base->Location());
+            _stream << ' ' << Index(base->BaseType().get()) << ' ' << base->IsVirtual();
+            WriteString(_stream, base->BaseUSR());
+        }
+        WriteContents(object);
+    }
+
+    void WriteFunction(const FunctionBase & function)
+    {
+        WriteString(_stream, function.Type());
+        _stream << ' ' << function.Flags() << ' ' << function.Parameters().size();
+        for (auto const & parameter : function.Parameters())
+        {
+            WriteString(_stream, parameter.Name());
+            WriteString(_stream, parameter.Type());
+        }
+    }
+
+    void WriteElement(const Element & element)
+    {
+        if (auto aNamespace = dynamic_cast<const Namespace *>(&element))
+        {
+            WriteCommon("namespace", element);
+            WriteContents(*aNamespace);
+        }
+        else if (auto aClass = dynamic_cast<const Class *>(&element))
+        {
+            WriteCommon("class", element);
+            WriteObject(*aClass);
+        }
+        else if (auto aStruct = dynamic_cast<const Struct *>(&element))
+        {
+            WriteCommon("struct", element);
+            WriteObject(*aStruct);
+        }
+        else if (auto aClassTemplate = dynamic_cast<const ClassTemplate *>(&element))
+        {
+            WriteCommon("classtemplate", element);
+            WriteStrings(_stream, aClassTemplate->TemplateParameters());
+            WriteObject(*aClassTemplate);
+        }
+        else if (auto aEnum = dynamic_cast<const Enum *>(&element))
+        {
+            WriteCommon("enum", element);
+            WriteString(_stream, aEnum->Type());
+            _stream << ' ' << aEnum->Values().size();
+            for (auto const & value : aEnum->Values())
+            {
+                WriteString(_stream, value.Name());
+                _stream << ' ' << value.Value();
+            }
+            _stream << endl;
+        }
+        else if (auto aTypedef = dynamic_cast<const Typedef *>(&element))
+        {
+            WriteCommon("typedef", element);
+            WriteString(_stream, aTypedef->Type());
+            _stream << endl;
+        }
+        else if (auto aVariable = dynamic_cast<const Variable *>(&element))
+        {
+            WriteCommon("variable", element);
+            WriteString(_stream, aVariable->Type());
+            _stream << endl;
+        }
+        else if (auto aDataMember = dynamic_cast<const DataMember *>(&element))
+        {
+            WriteCommon("datamember", element);
+            WriteString(_stream, aDataMember->Type());
+            _stream << endl;
+        }
+        else if (auto aFunctionTemplate = dynamic_cast<const FunctionTemplate *>(&element))
+        {
+            WriteCommon("functiontemplate", element);
+            WriteFunction(*aFunctionTemplate);
+            WriteStrings(_stream, aFunctionTemplate->TemplateParameters());
+            _stream << endl;
+        }
+        else if (auto aFunction = dynamic_cast<const Function *>(&element))
+        {
+            WriteCommon("function", element);
+            WriteFunction(*aFunction);
+            _stream << endl;
+        }
+        else if (auto aMethod = dynamic_cast<const Method *>(&element))
+        {
+            WriteCommon("method", element);
+            WriteFunction(*aMethod);
+            _stream << endl;
+        }
+        else if (auto aConstructor = dynamic_cast<const Constructor *>(&element))
+        {
+            WriteCommon("constructor", element);
+            WriteFunction(*aConstructor);
+            _stream << endl;
+        }
+        else if (auto aDestructor = dynamic_cast<const Destructor *>(&element))
+        {
+            WriteCommon("destructor", element);
+            WriteFunction(*aDestructor);
+            _stream << endl;
+        }
+        else if (auto anInclude = dynamic_cast<const IncludeDirective *>(&element))
+        {
+            WriteCommon("include", element);
+            _stream << ' ' << static_cast<int>(anInclude->IncludeType()) << endl;
+        }
+        else
+        {
+            _stream << "unsupported" << endl;
+            _complete = false;
+        }
+    }
+};
+
+class TreeReader
+{
+public:
+    explicit TreeReader(std::istream & stream)
+        : _stream(stream)
+        , _elements()
+        , _pendingBases()
+        , _arena()
+    {}
+
+    bool Read(AST & ast, SymbolIndex * symbols)
+    {
+        _arena = ast.Arena();
+        if (!ReadContents(ast) || !ReadSymbols(symbols))
+            return false;
+        // Base types may be declared after the type deriving from them was read, so they are resolved last.
+        for (auto const & pending : _pendingBases)
+        {
+            Element::Ptr baseType;
+            if (pending.baseIndex >= static_cast<long long>(_elements.size()))
+                return false;
+            if (pending.baseIndex >= 0)
+                baseType = _elements[static_cast<size_t>(pending.baseIndex)];
+            pending.object->AddBase(MakeNode<Inheritance>(_arena, pending.object, pending.location, pending.name,
+                                                            pending.accessSpecifier, baseType, pending.isVirtual,
+                                                            pending.baseUSR));
+        }
+        return true;
+    }
+
+private:
+    struct PendingBase
+    {
+        Object::Ptr object;
+        std::string name;
+        AccessSpecifier accessSpecifier;
+        SourceLocation location;
+        long long baseIndex;
+        bool isVirtual;
+        std::string baseUSR;
+    };
+
+    std::istream & _stream;
+    std::vector<Element::Ptr> _elements;
+    std::vector<PendingBase> _pendingBases;
+    std::shared_ptr<NodeArena> _arena;
+
+    bool ReadSymbols(SymbolIndex * symbols)
+    {
+        size_t count {};
+        if (!(_stream >> count))
+            return false;
+        for (size_t index = 0; index < count; ++index)
+        {
+            long long elementIndex {};
+            std::string usr;
+            if (!(_stream >> elementIndex) || !ReadString(_stream, usr) ||
+                (elementIndex < 0) || (elementIndex >= static_cast<long long>(_elements.size())))
+                return false;
+            auto declaration = dynamic_pointer_cast<Declaration>(_elements[static_cast<size_t>(elementIndex)]);
+            if ((symbols != nullptr) && (declaration != nullptr))
+                symbols->Add(usr, declaration);
+        }
+        return true;
+    }
+
+    bool ReadContents(Container & container)
+    {
+        size_t count {};
+        if (!(_stream >> count))
+            return false;
+        for (size_t index = 0; index < count; ++index)
+        {
+            if (!ReadElement(container))
+                return false;
+        }
+        return true;
+    }
+
+    bool ReadObject(const Object::Ptr & object)
+    {
+        size_t count {};
+        if (!(_stream >> count))
+            return false;
+        for (size_t index = 0; index < count; ++index)
+        {
+            PendingBase pending {};
+            pending.object = object;
+            if (!ReadString(_stream, pending.name) ||
+                !ReadAccessSpecifier(_stream, pending.accessSpecifier) ||
+                !ReadLocation(_stream, pending.location) ||
+                !(_stream >> pending.baseIndex >> pending.isVirtual) ||
+                !ReadString(_stream, pending.baseUSR))
+                return false;
+            _pendingBases.push_back(pending);
+        }
+        return ReadContents(*object);
+    }
+
+    bool ReadFunction(std::string & type, FunctionFlags & flags, ParameterList & parameters)
+    {
+        uint16_t flagsValue {};
+        size_t count {};
+        if (!ReadString(_stream, type) || !(_stream >> flagsValue >> count))
+            return false;
+        flags = static_cast<FunctionFlags>(flagsValue);
+        for (size_t index = 0; index < count; ++index)
+        {
+            std::string name;
+            std::string parameterType;
+            if (!ReadString(_stream, name) || !ReadString(_stream, parameterType))
+                return false;
+            parameters.emplace_back(name, parameterType);
+        }
+        return true;
+    }
+
+    bool ReadElement(Container & container)
+    {
+        std::string tag;
+        long long parentIndex {};
+        std::string name;
+        AccessSpecifier accessSpecifier {};
+        SourceLocation location;
+        if (!(_stream >> tag >> parentIndex) ||
+            !ReadString(_stream, name) ||
+            !ReadAccessSpecifier(_stream, accessSpecifier) ||
+            !ReadLocation(_stream, location))
+            return false;
+        // Parents are always created, and thus written, before their children.
+        if (parentIndex >= static_cast<long long>(_elements.size()))
+            return false;
+        Element::Ptr parent;
+        if (parentIndex >= 0)
+            parent = _elements[static_cast<size_t>(parentIndex)];
+
+        std::string type;
+        FunctionFlags flags {};
+        ParameterList parameters;
+        std::vector<std::string> templateParameters;
+        if (tag == "namespace")
+        {
+            auto object = MakeNode<Namespace>(_arena, parent, location, name);
+            Add(container, object);
+            return ReadContents(*object);
+        }
+        if (tag == "class")
+        {
+            auto object = MakeNode<Class>(_arena, parent, location, name, accessSpecifier);
+            Add(container, object);
+            return ReadObject(object);
+        }
+        if (tag == "struct")
+        {
+            auto object = MakeNode<Struct>(_arena, parent, location, name, accessSpecifier);
+            Add(container, object);
+            return ReadObject(object);
+        }
+        if (tag == "classtemplate")
+        {
+            if (!ReadStrings(_stream, templateParameters))
+                return false;
+            auto object = MakeNode<ClassTemplate>(_arena, parent, location, name, accessSpecifier);
+            for (auto const & parameter : templateParameters)
+            {
+                object->AddTemplateParameter(parameter);
+            }
+            Add(container, object);
+            return ReadObject(object);
+        }
+        if (tag == "enum")
+        {
+            size_t count {};
+            if (!ReadString(_stream, type) || !(_stream >> count))
+                return false;
+            auto object = MakeNode<Enum>(_arena, parent, location, name, accessSpecifier, type);
+            for (size_t index = 0; index < count; ++index)
+            {
+                std::string valueName;
+                long long value {};
+                if (!ReadString(_stream, valueName) || !(_stream >> value))
+                    return false;
+                object->AddValue(valueName, value);
+            }
+            Add(container, object);
+            return true;
+        }
+        if (tag == "typedef")
+        {
+            if (!ReadString(_stream, type))
+                return false;
+            Add(container, MakeNode<Typedef>(_arena, parent, location, name, accessSpecifier, type));
+            return true;
+        }
+        if (tag == "variable")
+        {
+            if (!ReadString(_stream, type))
+                return false;
+            Add(container, MakeNode<Variable>(_arena, parent, location, name, accessSpecifier, type));
+            return true;
+        }
+        if (tag == "datamember")
+        {
+            if (!ReadString(_stream, type))
+                return false;
+            Add(container, MakeNode<DataMember>(_arena, parent, location, name, accessSpecifier, type));
+            return true;
+        }
+        if (tag == "functiontemplate")
+        {
+            if (!ReadFunction(type, flags, parameters) || !ReadStrings(_stream, templateParameters))
+                return false;
+            auto object = MakeNode<FunctionTemplate>(_arena, parent, location, name, type, parameters, flags);
+            for (auto const & parameter : templateParameters)
+            {
+                object->AddTemplateParameter(parameter);
+            }
+            Add(container, object);
+            return true;
+        }
+        if (tag == "include")
+        {
+            IncludeSpecifier includeSpecifier {};
+            if (!ReadIncludeSpecifier(_stream, includeSpecifier))
+                return false;
+            Add(container, MakeNode<IncludeDirective>(_arena, parent, location, name, includeSpecifier));
+            return true;
+        }
+        if (!ReadFunction(type, flags, parameters))
+            return false;
+        if (tag == "function")
+            Add(container, MakeNode<Function>(_arena, parent, location, name, type, parameters, flags));
+        else if (tag == "method")
+            Add(container, MakeNode<Method>(_arena, parent, location, name, accessSpecifier, type, parameters, flags));
+        else if (tag == "constructor")
+            Add(container, MakeNode<Constructor>(_arena, parent, location, name, accessSpecifier, parameters, flags));
+        else if (tag == "destructor")
+            Add(container, MakeNode<Destructor>(_arena, parent, location, name, accessSpecifier, flags));
+        else
+            return false;
+        return true;
+    }
+
+    void Add(Container & container, const Element::Ptr & element)
+    {
+        _elements.push_back(element);
+        container.Add(element);
+    }
+};
+
+ParseCache::ParseCache(const std::string & directory)
+    : _directory(directory)
+    , _fileHashesLock()
+    , _fileHashes()
+{
+    while ((_directory.length() > 1) && (_directory[_directory.length() - 1] == '/'))
+        _directory.pop_back();
+}
+
+bool ParseCache::Load(const std::string & path, const OptionsList & options, ParseFlags flags,
+                      AST & ast, SymbolIndex & symbols, std::string & errorOutput)
+{
+    std::string entryPath = EntryPath(path, options, flags);
+    std::ifstream stream(entryPath);
+    std::string format;
+    if (!stream || !std::getline(stream, format) || (format != CacheFormat))
+    {
+        TRACE_LOG(TraceCache, TraceLevel::Info, "Parse cache miss: " << path);
+        return false;
+    }
+    size_t fileCount {};
+    if (!(stream >> fileCount))
+        return false;
+    for (size_t index = 0; index < fileCount; ++index)
+    {
+        uint64_t storedHash {};
+        std::string fileName;
+        uint64_t hash {};
+        if (!(stream >> storedHash) || !ReadString(stream, fileName))
+            return false;
+        if (!FileHash(fileName, hash) || (hash != storedHash))
+        {
+            TRACE_LOG(TraceCache, TraceLevel::Info, "Parse cache outdated: " << path << " (" << fileName << " changed)");
+            return false;
+        }
+    }
+    // Read into a separate index, so an invalid entry leaves no symbols behind
+    SymbolIndex entrySymbols;
+    if (!ReadString(stream, errorOutput) || !Deserialize(stream, ast, &entrySymbols))
+    {
+        ErrorStream() << "Invalid parse cache entry " << entryPath << " ignored" << endl;
+        return false;
+    }
+    symbols.Merge(entrySymbols);
+    TRACE_LOG(TraceCache, TraceLevel::Info, "Parse cache hit: " << path);
+    return true;
+}
+
+bool ParseCache::Store(const std::string & path, const OptionsList & options, ParseFlags flags,
+                       const std::vector<std::string> & files, const AST & ast, const SymbolIndex & symbols,
+                       const std::string & errorOutput)
+{
+    std::ostringstream stream;
+    stream << CacheFormat << endl << files.size() << endl;
+    for (auto const & fileName : files)
+    {
+        uint64_t hash {};
+        if (!FileHash(fileName, hash))
+            return false;
+        stream << hash;
+        WriteString(stream, fileName);
+        stream << endl;
+    }
+    WriteString(stream, errorOutput);
+    if (!Serialize(ast, stream, &symbols))
+    {
+        TRACE_LOG(TraceCache, TraceLevel::Info, "Parse result of " << path << " cannot be cached");
+        return false;
+    }
+
+    // Write to a temporary file first, so concurrent runs never see a partially written entry.
+    std::string entryPath = EntryPath(path, options, flags);
+    std::string temporaryPath = entryPath + "." + std::to_string(getpid()) + "-" +
+                                std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    if (!CreateDirectory(_directory))
+    {
+        ErrorStream() << "Cannot create parse cache directory " << _directory << endl;
+        return false;
+    }
+    {
+        std::ofstream file(temporaryPath);
+        if (!file || !(file << stream.str()))
+        {
+            ErrorStream() << "Cannot write parse cache entry " << temporaryPath << endl;
+            remove(temporaryPath.c_str());
+            return false;
+        }
+    }
+    if (rename(temporaryPath.c_str(), entryPath.c_str()) != 0)
+    {
+        remove(temporaryPath.c_str());
+        return false;
+    }
+    TRACE_LOG(TraceCache, TraceLevel::Info, "Parse cache stored: " << path);
+    return true;
+}
+
+bool ParseCache::Serialize(const AST & ast, std::ostream & stream, const SymbolIndex * symbols)
+{
+    TreeWriter writer(stream);
+    return writer.Write(ast, symbols);
+}
+
+bool ParseCache::Deserialize(std::istream & stream, AST & ast, SymbolIndex * symbols)
+{
+    TreeReader reader(stream);
+    return reader.Read(ast, symbols);
+}
+
+std::string ParseCache::EntryPath(const std::string & path, const OptionsList & options, ParseFlags flags) const
+{
+    uint64_t hash = Hash(HashOffsetBasis, CacheFormat);
+    hash = Hash(hash, RealPath(path));
+    for (auto const & option : options)
+    {
+        hash = Hash(hash, option);
+    }
+    hash = Hash(hash, std::to_string(flags));
+    return _directory + "/" + HexString(hash) + EntryExtension;
+}
+
+bool ParseCache::FileHash(const std::string & path, uint64_t & hash)
+{
+    {
+        std::lock_guard<std::mutex> lock(_fileHashesLock);
+        auto it = _fileHashes.find(path);
+        if (it != _fileHashes.end())
+        {
+            hash = it->second;
+            return true;
+        }
+    }
+    if (!HashFile(path, hash))
+        return false;
+    std::lock_guard<std::mutex> lock(_fileHashesLock);
+    _fileHashes.insert({path, hash});
+    return true;
+}
+
+} // namespace CPPParser
@@ -0,0 +1,147 @@
+#include "include/ParseContext.h"
+
+#include <algorithm>
+#include "include/PrecompiledPrefix.h"
+#include "include/Trace.h"
+
+using namespace std;
+using namespace Utility;
+
+namespace CPPParser
+{
+
+// Returns the highest severity of the diagnostics of the unit
+static CXDiagnosticSeverity Severity(CXTranslationUnit unit)
+{
+    CXDiagnosticSeverity result = CXDiagnostic_Ignored;
+    for (unsigned i = 0; (result != CXDiagnostic_Fatal) && (i < clang_getNumDiagnostics(unit)); ++i)
+    {
+        CXDiagnostic diagnostic = clang_getDiagnostic(unit, i);
+        result = std::max(result, clang_getDiagnosticSeverity(diagnostic));
+        clang_disposeDiagnostic(diagnostic);
+    }
+    return result;
+}
+
+ParseContext::ParseContext(bool reuseTranslationUnits)
+    : _index(clang_createIndex(0, 0))
+    , _reuseTranslationUnits(reuseTranslationUnits)
+    , _prefix()
+    , _units()
+    , _parseCount()
+    , _reparseCount()
+{
+}
+
+ParseContext::~ParseContext()
+{
+    DisposeTranslationUnits();
+    clang_disposeIndex(_index);
+}
+
+CXTranslationUnit ParseContext::Parse(const std::string & path, const OptionsList & options, unsigned parseOptions)
+{
+    std::string key;
+    if (_reuseTranslationUnits)
+    {
+        parseOptions |= CXTranslationUnit_Flags::CXTranslationUnit_PrecompiledPreamble |
+                        CXTranslationUnit_Flags::CXTranslationUnit_CreatePreambleOnFirstParse;
+        key = path + '\0' + std::to_string(parseOptions);
+        if ((_prefix != nullptr) && _prefix->IsValid())
+            key += '\0' + _prefix->PCHPath();
+        for (auto const & option : options)
+        {
+            key += '\0' + option;
+        }
+        auto it = _units.find(key);
+        if (it != _units.end())
+        {
+            // Reparsing reads the files from disk again, so changes since the last parse are picked up.
+            TRACE_LOG(TraceTreeBuild, TraceLevel::Info, "Reparse " << path);
+            if (clang_reparseTranslationUnit(it->second, 0, nullptr, clang_defaultReparseOptions(it->second)) == 0)
+            {
+                ++_reparseCount;
+                return it->second;
+            }
+            // After a failed reparse the unit can only be disposed of
+            clang_disposeTranslationUnit(it->second);
+            _units.erase(it);
+        }
+    }
+    else
+    {
+        DisposeTranslationUnits();
+    }
+
+    CXTranslationUnit unit = nullptr;
+    if ((_prefix != nullptr) && _prefix->IsValid())
+    {
+        OptionsList prefixOptions = options;
+        prefixOptions.push_back("-include-pch");
+        prefixOptions.push_back(_prefix->PCHPath());
+        unit = ParseUnit(path, prefixOptions, parseOptions);
+        // A fatal error, such as a precompiled header that does not match the options, stops the parse halfway.
+        // Errors the file has by itself are reported by the parse without the header.
+        CXDiagnosticSeverity severity = (unit != nullptr) ? Severity(unit) : CXDiagnostic_Fatal;
+        if (severity == CXDiagnostic_Fatal)
+        {
+            if (unit != nullptr)
+                clang_disposeTranslationUnit(unit);
+            unit = nullptr;
+        }
+        else if (severity == CXDiagnostic_Error)
+        {
+            // The header may hide declarations the file depends on, for instance through a macro that is defined
+            // differently before the include. Only keep the result with the header if the file has the errors without.
+            CXTranslationUnit plainUnit = ParseUnit(path, options, parseOptions);
+            if ((plainUnit != nullptr) && (Severity(plainUnit) < CXDiagnostic_Error))
+            {
+                clang_disposeTranslationUnit(unit);
+                unit = plainUnit;
+                TRACE_LOG(TraceTreeBuild, TraceLevel::Info, "Parsed " << path << " without precompiled header");
+            }
+            else if (plainUnit != nullptr)
+                clang_disposeTranslationUnit(plainUnit);
+        }
+        if (unit == nullptr)
+            TRACE_LOG(TraceTreeBuild, TraceLevel::Info, "Parse " << path << " without precompiled header");
+    }
+    if (unit == nullptr)
+        unit = ParseUnit(path, options, parseOptions);
+    if (unit == nullptr)
+        return nullptr;
+    ++_parseCount;
+    _units.insert({key, unit});
+    return unit;
+}
+
+void ParseContext::DisposeTranslationUnits()
+{
+    for (auto const & unit : _units)
+    {
+        clang_disposeTranslationUnit(unit.second);
+    }
+    _units.clear();
+}
+
+CXTranslationUnit ParseContext::ParseUnit(const std::string & path, const OptionsList & options, unsigned parseOptions)
+{
+    std::vector<const char *> args;
+    for (auto const & option : options)
+    {
+        args.push_back(option.c_str());
+    }
+    CXTranslationUnit unit = nullptr;
+    CXErrorCode errorCode = clang_parseTranslationUnit2(
+        _index,
+        path.c_str(),
+        args.data(), static_cast<int>(args.size()),
+        nullptr, 0,
+        parseOptions,
+        &unit);
+    if ((errorCode != CXErrorCode::CXError_Success) || (unit == nullptr))
+        return nullptr;
+    return unit;
+}
+
+} // namespace CPPParser
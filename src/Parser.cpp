@@ -2,10 +2,17 @@
 
 #include <fstream>
 #include <iomanip>
+#include <sstream>
 #include <clang-c/Index.h>
 #include <include/TreeInfo.h>
 #include <include/CodeGenerator.h>
+#include "include/DeclarationStream.h"
+#include "include/ParseCache.h"
+#include "include/Stats.h"
+#include "include/TraceEvents.h"
+#include "include/PrecompiledPrefix.h"
 #include "include/Utility.h"
+#include "include/Trace.h"
 #include "include/Typedef.h"
 #include "include/Variable.h"
 
@@ -18,50 +25,141 @@ namespace CPPParser
 CXChildVisitResult printVisitor(CXCursor cursor, CXCursor parent, CXClientData client_data)
 {
     Parser * parser = reinterpret_cast<Parser *>(client_data);
+    ParseStats * stats = parser->Statistics();
 
+    CXCursorKind kind = clang_getCursorKind(cursor);
+    if (stats != nullptr)
+        ParseStats::CountCursor(stats->cursorsVisited, kind);
+    if (Parser::IsPrunedKind(kind) || !parser->Accept(cursor))
+        return CXChildVisit_Continue;
+
+    if (stats != nullptr)
+        ParseStats::CountCursor(stats->cursorsHandled, kind);
     parser->HandleToken(cursor, parent);
 
-    return CXChildVisit_Recurse;
+    return Parser::IsLeafKind(kind) ? CXChildVisit_Continue : CXChildVisit_Recurse;
+}
+
+void inclusionVisitor(CXFile includedFile, CXSourceLocation *, unsigned, CXClientData clientData)
+{
+    std::vector<std::string> * files = reinterpret_cast<std::vector<std::string> *>(clientData);
+    files->push_back(ConvertString(clang_getFileName(includedFile)));
 }
 
-Parser::Parser(const std::string & path)
+Parser::Parser(const std::string & path, ParseFlags flags, ParseCache * cache, ParseContext * context)
     : _path(path)
+    , _flags(flags)
+    , _cache(cache)
+    , _context(context)
+    , _fromCache()
     , _fileName()
+    , _strings(StringPool::Current())
     , _astCollection()
+    , _astCollectionMerged()
     , _ast()
     , _token()
     , _parentToken()
     , _traversalStack()
     , _tokenLookupMapTraversal()
-    , _typeLookupMap()
+    , _symbolIndex()
+    , _listener()
+    , _declarationStream()
+    , _allowedPaths()
+    , _sourceFilter()
+    , _stats()
 {
+    if (_strings == nullptr)
+        _strings = make_shared<StringPool>();
+    _ast.Arena()->AddStringPool(_strings);
+    _astCollection.Arena()->AddStringPool(_strings);
+}
 
+Parser::~Parser()
+{
 }
 
 bool Parser::Parse(const OptionsList & options)
+{
+    TraceSpan span("Parser::Parse", _path);
+    StringPool::Scope strings(_strings);
+    if (Stats::IsEnabled())
+        _stats.reset(new ParseStats());
+    bool result = ParseFile(options);
+    if (_stats != nullptr)
+    {
+        AddMemoryUsage(_stats->memory);
+        Stats::Add(_path, *_stats);
+        _stats.reset();
+    }
+    return result;
+}
+
+bool Parser::ParseFile(const OptionsList & options)
 {
     std::string directory;
     std::string extension;
     Utility::SplitPath(_path, directory, _fileName, extension);
 
-    const char ** args = new const char * [options.size()];
-    for (size_t index = 0; index < options.size(); ++index)
+    _fromCache = false;
+    std::vector<std::string> files;
+    if (!UseCache())
+        return ParseTranslationUnit(options, files);
+
+    AST ast;
+    std::string errorOutput;
+    bool loaded = false;
+    {
+        TraceSpan loadSpan("cache load", _path);
+        StatsTimer cacheTimer;
+        loaded = _cache->Load(_path, options, _flags, ast, _symbolIndex, errorOutput);
+        AddTime(StatsPhase::Cache, cacheTimer);
+    }
+    if (loaded)
+    {
+        ErrorStream() << errorOutput;
+        _ast = ast;
+        _fromCache = true;
+        return true;
+    }
+
+    // Capture the error output, so it can be replayed when the result is taken from the cache.
+    std::ostream & errorStream = ErrorStream();
+    std::ostringstream capturedErrors;
+    SetErrorStream(capturedErrors);
+    bool result = ParseTranslationUnit(options, files);
+    SetErrorStream(errorStream);
+    errorStream << capturedErrors.str();
+    if (result)
+    {
+        TraceSpan storeSpan("cache store", _path);
+        StatsTimer storeTimer;
+        _cache->Store(_path, options, _flags, files, _ast, _symbolIndex, capturedErrors.str());
+        AddTime(StatsPhase::Cache, storeTimer);
+    }
+    return result;
+}
+
+bool Parser::ParseTranslationUnit(const OptionsList & options, std::vector<std::string> & files)
+{
+    unsigned parseOptions = TranslationUnitOptions(_flags);
+    std::unique_ptr<ParseContext> ownContext;
+    ParseContext * context = _context;
+    if (context == nullptr)
+    {
+        ownContext.reset(new ParseContext(false));
+        context = ownContext.get();
+    }
+    CXTranslationUnit unit = nullptr;
     {
-        args[index] = options[index].c_str();
+        TraceSpan parseSpan("libclang parse", _path);
+        StatsTimer parseTimer;
+        unit = context->Parse(_path, options, parseOptions);
+        AddTime(StatsPhase::Parse, parseTimer);
     }
-    CXIndex index = clang_createIndex(0, 0);
-    CXTranslationUnit unit;
-    CXErrorCode errorCode = clang_parseTranslationUnit2(
-        index,
-        _path.c_str(),
-        args, static_cast<int>(options.size()),
-        nullptr, 0,
-        CXTranslationUnit_Flags::CXTranslationUnit_DetailedPreprocessingRecord,
-        &unit);
-
-    if ((errorCode != CXErrorCode::CXError_Success) || (unit == nullptr))
+
+    if (unit == nullptr)
     {
-        cerr << "Unable to parse translation unit. Quitting." << endl;
+        ErrorStream() << "Unable to parse translation unit. Quitting." << endl;
         return false;
     }
     if (clang_getNumDiagnostics(unit) > 0)
@@ -69,20 +167,93 @@ bool Parser::Parse(const OptionsList & options)
         for (size_t i = 0; i < clang_getNumDiagnostics(unit); ++i)
         {
             CXDiagnostic diagnostic = clang_getDiagnostic(unit, i);
-            cerr << ConvertString(clang_getDiagnosticSpelling(diagnostic)) << endl;
+            ErrorStream() << ConvertString(clang_getDiagnosticSpelling(diagnostic)) << endl;
+            clang_disposeDiagnostic(diagnostic);
         }
     }
 
-    delete [] args;
+    if (_listener != nullptr)
+        _declarationStream.reset(new DeclarationStream(*_listener));
+    if (UseSourceFilter())
+    {
+        _sourceFilter.reset(new SourceFilter((_flags & ParseFlags::MainFileOnly) != 0,
+                                             (_flags & ParseFlags::SkipSystemHeaders) != 0, _allowedPaths));
+    }
     CXCursor cursor = clang_getTranslationUnitCursor(unit);
-    clang_visitChildren(cursor, printVisitor, this);
-
-    clang_disposeTranslationUnit(unit);
-    clang_disposeIndex(index);
+    StatsTimer visitTimer;
+    {
+        // The trees are built from the cursors as they are visited, so this span covers both
+        TraceSpan visitSpan("traverse and build tree", _path);
+        clang_visitChildren(cursor, printVisitor, this);
+    }
+    if (_stats != nullptr)
+    {
+        // The declarations added to the trees during the visit are reported on their own
+        PhaseTime visitTime = visitTimer.Elapsed();
+        visitTime -= _stats->phases[static_cast<size_t>(StatsPhase::TreeBuild)];
+        _stats->AddTime(StatsPhase::Visit, visitTime);
+        _stats->memory.AddTranslationUnit(unit);
+    }
+    _sourceFilter.reset();
+    if (_declarationStream != nullptr)
+    {
+        _declarationStream->Finish();
+        _declarationStream.reset();
+    }
+    if (UseCache())
+    {
+        clang_getInclusions(unit, inclusionVisitor, &files);
+        // Headers read from a precompiled header are not reported as inclusions, but the tree depends on them
+        if (context->Prefix() != nullptr)
+            files.insert(files.end(), context->Prefix()->Files().begin(), context->Prefix()->Files().end());
+    }
 
     return true;
 }
 
+void Parser::AddMemoryUsage(MemoryUsage & memory) const
+{
+    memory.AddTree(_ast);
+    memory.AddTree(_astCollection);
+    memory.AddLookupMap(_ast.LookupMap());
+    memory.AddLookupMap(_astCollection.LookupMap());
+    memory.AddLookupMap(_tokenLookupMapTraversal);
+    memory.symbols.count += _symbolIndex.Count();
+    memory.symbols.bytes += _symbolIndex.MemorySize();
+}
+
+void Parser::AddTime(StatsPhase phase, const StatsTimer & timer)
+{
+    if (_stats != nullptr)
+        _stats->AddTime(phase, timer.Elapsed());
+}
+
+unsigned Parser::TranslationUnitOptions(ParseFlags flags)
+{
+    unsigned parseOptions = CXTranslationUnit_Flags::CXTranslationUnit_None;
+    if ((flags & ParseFlags::PreprocessorDirectives) != 0)
+        parseOptions |= CXTranslationUnit_Flags::CXTranslationUnit_DetailedPreprocessingRecord;
+    if ((flags & ParseFlags::SkipFunctionBodies) != 0)
+        parseOptions |= CXTranslationUnit_Flags::CXTranslationUnit_SkipFunctionBodies;
+    return parseOptions;
+}
+
+bool Parser::IsPrunedKind(CXCursorKind kind)
+{
+    // Statements (including function bodies), expressions and attributes can never hold a declaration we model,
+    // so neither the cursor itself nor anything below it needs to be visited.
+    return (clang_isStatement(kind) != 0) ||
+           (clang_isExpression(kind) != 0) ||
+           (clang_isAttribute(kind) != 0);
+}
+
+bool Parser::IsLeafKind(CXCursorKind kind)
+{
+    // References (e.g. base class specifiers) and preprocessing cursors are handled, but have no children of interest.
+    return (clang_isReference(kind) != 0) ||
+           (clang_isPreprocessing(kind) != 0);
+}
+
 void Parser::PrintToken(CXCursor token, CXCursor parentToken)
 {
     CXType type = clang_getCursorType(token);
@@ -96,8 +267,8 @@ void Parser::PrintToken(CXCursor token, CXCursor parentToken)
     AccessSpecifier accessSpecifier = ConvertAccessSpecifier(clang_getCXXAccessSpecifier(token));
     if (kind != CXCursorKind::CXCursor_MacroDefinition)
     {
-        std::cout << strKind << " name: " << strName  << " type: " << strType << " access: " << accessSpecifier
-                  << " parent: " << strKindParent << " name: " << strNameParent << std::endl << flush;
+        LogStream() << strKind << " name: " << strName  << " type: " << strType << " access: " << accessSpecifier
+                    << " parent: " << strKindParent << " name: " << strNameParent << std::endl;
     }
 
 }
@@ -107,11 +278,29 @@ void Parser::HandleToken(CXCursor token, CXCursor parentToken)
     _token = token;
     _parentToken = parentToken;
 
-    Declaration::Ptr parent = _astCollection.Find(parentToken);
-
     CXCursorKind kind = clang_getCursorKind(token);
-    PrintToken(token, parentToken);
+    if (TRACE_ENABLED(TraceCursor, TraceLevel::Debug))
+        PrintToken(token, parentToken);
+
+    if (_declarationStream != nullptr)
+        _declarationStream->HandleToken(token, parentToken);
+    if (!BuildTree())
+        return;
+
+    // Only declarations are timed, timing every cursor would cost more than handling most of them
+    ElementKind elementKind {};
+    if ((_stats != nullptr) && DeclarationStream::IsDeclarationKind(kind, elementKind))
+    {
+        StatsTimer timer;
+        AddToTree(token, parentToken, kind);
+        AddTime(StatsPhase::TreeBuild, timer);
+    }
+    else
+        AddToTree(token, parentToken, kind);
+}
 
+void Parser::AddToTree(CXCursor token, CXCursor parentToken, CXCursorKind kind)
+{
     switch (kind)
     {
         case CXCursorKind::CXCursor_UnexposedDecl:          /*AddStruct(parent, token);*/ break;
@@ -149,7 +338,7 @@ void Parser::HandleToken(CXCursor token, CXCursor parentToken)
         case CXCursorKind::CXCursor_NamespaceAlias:         break;
         case CXCursorKind::CXCursor_UsingDirective:         break;
         case CXCursorKind::CXCursor_UsingDeclaration:       break;
-        case CXCursorKind::CXCursor_TypeAliasDecl:          break;
+        case CXCursorKind::CXCursor_TypeAliasDecl:          AddTypedef(token, parentToken); break;
         case CXCursorKind::CXCursor_ObjCSynthesizeDecl:     break;
         case CXCursorKind::CXCursor_ObjCDynamicDecl:        break;
         case CXCursorKind::CXCursor_CXXAccessSpecifier:     AddAccessSpecifier(token, parentToken); break;
@@ -316,10 +505,25 @@ void Parser::HandleToken(CXCursor token, CXCursor parentToken)
     }
 }
 
+const ASTCollection & Parser::GetASTCollection() const
+{
+    if (!BuildASTCollection() && !_astCollectionMerged)
+    {
+        TraceSpan span("build ASTCollection", _path);
+        StringPool::Scope strings(_strings);
+        StatsTimer mergeTimer;
+        _astCollection.Merge(_ast);
+        if (Stats::IsEnabled())
+            Stats::AddTime(_path, StatsPhase::TreeBuild, mergeTimer.Elapsed());
+        _astCollectionMerged = true;
+    }
+    return _astCollection;
+}
+
 void Parser::Show(std::ostream & stream)
 {
     stream << "AST" << endl << endl;
-    _astCollection.Show(stream, 0);
+    GetASTCollection().Show(stream, 0);
 }
 
 void Parser::TraverseTree(std::ostream & stream)
@@ -328,211 +532,188 @@ void Parser::TraverseTree(std::ostream & stream)
     _ast.Visit(codeGenerator);
 }
 
-void Parser::AddToMap(Declaration::Ptr object)
+void Parser::AddToMap(CXCursor token, Declaration::Ptr object)
 {
-    std::string qualifiedName = object->QualifiedName();
-    if (!qualifiedName.empty())
-        _typeLookupMap.insert({qualifiedName, object});
-//    ShowTypeMap();
+    if ((object == nullptr) || !SymbolIndex::IsTypeKind(clang_getCursorKind(token)))
+        return;
+    std::string usr = SymbolIndex::USR(token);
+    _symbolIndex.Add(usr, object);
+    TRACE_LOG(TraceTreeBuild, TraceLevel::Debug, "Symbol index: " << usr);
 }
 
-void Parser::AddNamespace(CXCursor token, CXCursor parentToken)
+Declaration::Ptr Parser::FindType(CXType type) const
 {
-    Declaration::Ptr object = _astCollection.AddNamespace(token, parentToken);
-    AddToMap(object);
-//    _astCollection.ShowInfo();
+    std::string usr = SymbolIndex::USR(type);
+    if (usr.empty())
+        return nullptr;
+    return _symbolIndex.Find(usr);
+}
 
-    object = _ast.AddNamespace(token, parentToken);
-//    _ast.ShowInfo();
+void Parser::AddNamespace(CXCursor token, CXCursor parentToken)
+{
+    if (BuildASTCollection())
+        AddToMap(token, _astCollection.AddNamespace(token, parentToken));
+    else
+        AddToMap(token, _ast.AddNamespace(token, parentToken));
 }
 
 void Parser::AddClass(CXCursor token, CXCursor parentToken)
 {
-    Declaration::Ptr object = _astCollection.AddClass(token, parentToken);
-    AddToMap(object);
-//    _astCollection.ShowInfo();
-
-    object = _ast.AddClass(token, parentToken);
-//    _ast.ShowInfo();
+    if (BuildASTCollection())
+        AddToMap(token, _astCollection.AddClass(token, parentToken));
+    else
+        AddToMap(token, _ast.AddClass(token, parentToken));
 }
 
 void Parser::AddStruct(CXCursor token, CXCursor parentToken)
 {
-    Declaration::Ptr object = _astCollection.AddStruct(token, parentToken);
-    AddToMap(object);
-//    _astCollection.ShowInfo();
-
-    object = _ast.AddStruct(token, parentToken);
-//    _ast.ShowInfo();
+    if (BuildASTCollection())
+        AddToMap(token, _astCollection.AddStruct(token, parentToken));
+    else
+        AddToMap(token, _ast.AddStruct(token, parentToken));
 }
 
 void Parser::AddConstructor(CXCursor token, CXCursor parentToken)
 {
-    Declaration::Ptr object = _astCollection.AddConstructor(token, parentToken);
-    AddToMap(object);
-//    _astCollection.ShowInfo();
-
-    object = _ast.AddConstructor(token, parentToken);
-//    _ast.ShowInfo();
+    if (BuildASTCollection())
+        AddToMap(token, _astCollection.AddConstructor(token, parentToken));
+    else
+        AddToMap(token, _ast.AddConstructor(token, parentToken));
 }
 
 void Parser::AddDestructor(CXCursor token, CXCursor parentToken)
 {
-    Declaration::Ptr object = _astCollection.AddDestructor(token, parentToken);
-    AddToMap(object);
-//    _astCollection.ShowInfo();
-
-    object = _ast.AddDestructor(token, parentToken);
-//    _ast.ShowInfo();
+    if (BuildASTCollection())
+        AddToMap(token, _astCollection.AddDestructor(token, parentToken));
+    else
+        AddToMap(token, _ast.AddDestructor(token, parentToken));
 }
 
 void Parser::AddMethod(CXCursor token, CXCursor parentToken)
 {
-    Declaration::Ptr object = _astCollection.AddMethod(token, parentToken);
-    AddToMap(object);
-//    _astCollection.ShowInfo();
-
-    object = _ast.AddMethod(token, parentToken);
-//    _ast.ShowInfo();
+    if (BuildASTCollection())
+        AddToMap(token, _astCollection.AddMethod(token, parentToken));
+    else
+        AddToMap(token, _ast.AddMethod(token, parentToken));
 }
 
 void Parser::AddDataMember(CXCursor token, CXCursor parentToken)
 {
-    Declaration::Ptr object = _astCollection.AddDataMember(token, parentToken);
-    AddToMap(object);
-//    _astCollection.ShowInfo();
-
-    object = _ast.AddDataMember(token, parentToken);
-//    _ast.ShowInfo();
+    if (BuildASTCollection())
+        AddToMap(token, _astCollection.AddDataMember(token, parentToken));
+    else
+        AddToMap(token, _ast.AddDataMember(token, parentToken));
 }
 
 void Parser::AddEnum(CXCursor token, CXCursor parentToken)
 {
-    Declaration::Ptr object = _astCollection.AddEnum(token, parentToken);
-    AddToMap(object);
-//    _astCollection.ShowInfo();
-
-    object = _ast.AddEnum(token, parentToken);
-//    _ast.ShowInfo();
+    if (BuildASTCollection())
+        AddToMap(token, _astCollection.AddEnum(token, parentToken));
+    else
+        AddToMap(token, _ast.AddEnum(token, parentToken));
 }
 
 void Parser::AddEnumValue(CXCursor token, CXCursor parentToken)
 {
-    _astCollection.AddEnumValue(token, parentToken);
-//    _astCollection.ShowInfo();
-
-    _ast.AddEnumValue(token, parentToken);
-//    _ast.ShowInfo();
+    if (BuildASTCollection())
+        _astCollection.AddEnumValue(token, parentToken);
+    else
+        _ast.AddEnumValue(token, parentToken);
 }
 
 void Parser::AddTypedef(CXCursor token, CXCursor parentToken)
 {
-    Declaration::Ptr object = _astCollection.AddTypedef(token, parentToken);
-    AddToMap(object);
-//    _astCollection.ShowInfo();
-
-    _ast.AddTypedef(token, parentToken);
-//    _ast.ShowInfo();
+    if (BuildASTCollection())
+        AddToMap(token, _astCollection.AddTypedef(token, parentToken));
+    else
+        AddToMap(token, _ast.AddTypedef(token, parentToken));
 }
 
 void Parser::AddVariable(CXCursor token, CXCursor parentToken)
 {
-    Declaration::Ptr object = _astCollection.AddVariable(token, parentToken);
-    AddToMap(object);
-//    _astCollection.ShowInfo();
-
-    _ast.AddVariable(token, parentToken);
-//    _ast.ShowInfo();
+    if (BuildASTCollection())
+        AddToMap(token, _astCollection.AddVariable(token, parentToken));
+    else
+        AddToMap(token, _ast.AddVariable(token, parentToken));
 }
 
 void Parser::AddFunction(CXCursor token, CXCursor parentToken)
 {
-    Declaration::Ptr object = _astCollection.AddFunction(token, parentToken);
-    AddToMap(object);
-//    _astCollection.ShowInfo();
-
-    _ast.AddFunction(token, parentToken);
-//    _ast.ShowInfo();
+    if (BuildASTCollection())
+        AddToMap(token, _astCollection.AddFunction(token, parentToken));
+    else
+        AddToMap(token, _ast.AddFunction(token, parentToken));
 }
 
 void Parser::AddBaseClass(CXCursor token, CXCursor parentToken)
 {
     CXType typeDecl = clang_getCursorType(token);
-    CXType baseTypeDecl = clang_getCanonicalType(typeDecl);
-    std::string baseTypeName = ConvertString(clang_getTypeSpelling(baseTypeDecl));
-    auto it = _typeLookupMap.find(baseTypeName);
-    Declaration::Ptr baseType = nullptr;
-    if (it != _typeLookupMap.end())
-        baseType = it->second;
-    else
+    Declaration::Ptr baseType = FindType(typeDecl);
+    // An unresolved base is still recorded by its name and USR, so a ParserPool can resolve it after all inputs
+    // are parsed
+    if ((baseType == nullptr) && UseSourceFilter())
+    {
+        // Expected when the base class is declared in a file that was skipped
+        TRACE_LOG(TraceTreeBuild, TraceLevel::Info, "Unresolved base type: " << ConvertString(clang_getTypeSpelling(typeDecl)));
+    }
+    else if (baseType == nullptr)
     {
         std::string strType = ConvertString(clang_getTypeSpelling(typeDecl));
-        std::string strType2 = ConvertString(clang_getTypeSpelling(baseTypeDecl));
-        cerr << "Undefined base type: " <<  strType << "," << strType2 << endl;
-        return;
+        std::string strType2 = ConvertString(clang_getTypeSpelling(clang_getCanonicalType(typeDecl)));
+        ErrorStream() << "Undefined base type: " <<  strType << "," << strType2 << endl;
     }
-    _astCollection.AddBaseClass(token, parentToken, baseType);
-    _ast.AddBaseClass(token, parentToken, baseType);
+    if (BuildASTCollection())
+        _astCollection.AddBaseClass(token, parentToken, baseType);
+    else
+        _ast.AddBaseClass(token, parentToken, baseType);
 }
 
 void Parser::AddFunctionTemplate(CXCursor token, CXCursor parentToken)
 {
-    Declaration::Ptr object = _astCollection.AddFunctionTemplate(token, parentToken);
-    AddToMap(object);
-//    _astCollection.ShowInfo();
-
-    _ast.AddFunctionTemplate(token, parentToken);
-//    _ast.ShowInfo();
+    if (BuildASTCollection())
+        AddToMap(token, _astCollection.AddFunctionTemplate(token, parentToken));
+    else
+        AddToMap(token, _ast.AddFunctionTemplate(token, parentToken));
 }
 
 void Parser::AddClassTemplate(CXCursor token, CXCursor parentToken)
 {
-    Declaration::Ptr object = _astCollection.AddClassTemplate(token, parentToken);
-    AddToMap(object);
-//    _astCollection.ShowInfo();
-
-    _ast.AddClassTemplate(token, parentToken);
-//    _ast.ShowInfo();
+    if (BuildASTCollection())
+        AddToMap(token, _astCollection.AddClassTemplate(token, parentToken));
+    else
+        AddToMap(token, _ast.AddClassTemplate(token, parentToken));
 }
 
 void Parser::AddTemplateTypeParameter(CXCursor token, CXCursor parentToken)
 {
-    _astCollection.AddTemplateTypeParameter(token, parentToken);
-    _ast.AddTemplateTypeParameter(token, parentToken);
+    if (BuildASTCollection())
+        _astCollection.AddTemplateTypeParameter(token, parentToken);
+    else
+        _ast.AddTemplateTypeParameter(token, parentToken);
 }
 
 void Parser::AddAccessSpecifier(CXCursor token, CXCursor parentToken)
 {
-    Declaration::Ptr parent = _astCollection.Find(parentToken);
+    Declaration::Ptr parent = BuildASTCollection() ? _astCollection.Find(parentToken) : _ast.Find(parentToken);
     Object::Ptr object = dynamic_pointer_cast<Object>(parent);
     if (object != nullptr)
         object->SetAccessSpecifier(ConvertAccessSpecifier(clang_getCXXAccessSpecifier(token)));
-    parent = _ast.Find(parentToken);
-    object = dynamic_pointer_cast<Object>(parent);
-    if (object != nullptr)
-        object->SetAccessSpecifier(ConvertAccessSpecifier(clang_getCXXAccessSpecifier(token)));
 }
 
 void Parser::AddInclude(CXCursor token, CXCursor parentToken)
 {
-
+    // Inclusion directives are visited with or without a detailed preprocessing record, but only kept when asked for
+    if ((_flags & ParseFlags::PreprocessorDirectives) == 0)
+        return;
+    if (BuildASTCollection())
+        _astCollection.AddInclude(token, parentToken);
+    else
+        _ast.AddInclude(token, parentToken);
 }
 
 void Parser::ShowTypeMap()
 {
-    cout << "Type map:" << endl;
-    for (auto element : _typeLookupMap)
-    {
-        std::string token = element.first;
-        std::string parentToken;
-        if (element.second->Parent() != nullptr)
-            parentToken = element.second->Parent()->Name() + "::";
-        cout << parentToken << element.second->Name() << " : " << token << endl;
-//        cout << token << " : ";
-//        TreeInfo treeInfo(cout);
-//        element.second->TraverseBegin(treeInfo);
-//        element.second->TraverseEnd(treeInfo);
-    }
+    _symbolIndex.Show(cout);
 }
 
 //void Parser::ShowTraversalStack()
@@ -542,12 +723,12 @@ void Parser::ShowTypeMap()
 //    {
 //        CXCursor element = _stack.At(index);
 //        CXCursorKind kind = clang_getCursorKind(element);
-//        CXString strKind = clang_getCursorKindSpelling(kind);
+//        ClangString strKind(clang_getCursorKindSpelling(kind));
 //        CXType type = clang_getCursorType(element);
-//        CXString strType = clang_getTypeSpelling(type);
+//        ClangString strType(clang_getTypeSpelling(type));
 //        CXType underlyingType = clang_getTypedefDeclUnderlyingType(element);
-//        CXString strUnderlyingType = clang_getTypeSpelling(underlyingType);
-//        CXString strName = clang_getCursorSpelling(element);
+//        ClangString strUnderlyingType(clang_getTypeSpelling(underlyingType));
+//        ClangString strName(clang_getCursorSpelling(element));
 //        if (kind < CXCursorKind::CXCursor_FirstInvalid)
 //        {
 //            switch (type.kind)
@@ -0,0 +1,214 @@
+#include "include/ParserPool.h"
+
+#include <atomic>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include "include/Object.h"
+#include "include/TraceEvents.h"
+#include "include/Utility.h"
+
+using namespace std;
+using namespace Utility;
+
+namespace CPPParser
+{
+
+struct ParseResult
+{
+    ParseResult()
+        : ok()
+        , ast()
+        , symbols()
+        , log()
+        , errors()
+    {}
+    bool ok;
+    std::unique_ptr<AST> ast;
+    SymbolIndex symbols;
+    std::ostringstream log;
+    std::ostringstream errors;
+};
+
+ParserPool::ParserPool(size_t jobs, ParseFlags flags, ParseCache * cache)
+    : _jobs(jobs)
+    , _flags(flags)
+    , _cache(cache)
+    , _prefix()
+    , _allowedPaths()
+    , _asts()
+    , _symbolIndex()
+    , _strings()
+    , _contexts()
+{
+    if (_jobs == 0)
+        _jobs = std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+bool ParserPool::Parse(const std::vector<std::string> & inputFiles, const OptionsList & options)
+{
+    // The index refers to the nodes of the trees, so it is released first
+    _symbolIndex.Clear();
+    _asts.clear();
+    // The pool of the previous run is released with its trees
+    _strings = make_shared<StringPool>();
+    if (_prefix != nullptr)
+    {
+        TraceSpan span("build precompiled prefix");
+        _prefix->Build(inputFiles, options, (_flags & ParseFlags::PreprocessorDirectives) != 0);
+    }
+    bool ok = ((_jobs <= 1) || (inputFiles.size() <= 1)) ? ParseSerial(inputFiles, options)
+                                                        : ParseParallel(inputFiles, options);
+    if (ok)
+        ResolveBaseTypes();
+    return ok;
+}
+
+size_t ParserPool::ReparseCount() const
+{
+    size_t result = 0;
+    for (auto const & context : _contexts)
+    {
+        result += context->ReparseCount();
+    }
+    return result;
+}
+
+void ParserPool::CreateContexts(size_t count)
+{
+    while (_contexts.size() < count)
+    {
+        _contexts.emplace_back(new ParseContext((_flags & ParseFlags::ReuseTranslationUnits) != 0));
+    }
+    for (auto const & context : _contexts)
+    {
+        context->SetPrecompiledPrefix(((_prefix != nullptr) && _prefix->IsValid()) ? _prefix : nullptr);
+    }
+}
+
+bool ParserPool::ParseSerial(const std::vector<std::string> & inputFiles, const OptionsList & options)
+{
+    CreateContexts(1);
+    StringPool::Scope strings(_strings);
+    for (auto const & inputFile : inputFiles)
+    {
+        Parser parser(inputFile, _flags, _cache, _contexts[0].get());
+        parser.SetAllowedPaths(_allowedPaths);
+        if (!parser.Parse(options))
+            return false;
+        _asts.push_back(parser.GetAST());
+        _symbolIndex.Merge(parser.Symbols());
+    }
+    return true;
+}
+
+bool ParserPool::ParseParallel(const std::vector<std::string> & inputFiles, const OptionsList & options)
+{
+    std::vector<ParseResult> results(inputFiles.size());
+    std::atomic<size_t> nextInput(0);
+
+    size_t threadCount = std::min(_jobs, inputFiles.size());
+    CreateContexts(threadCount);
+    // A translation unit can only be reused by the worker whose context holds it
+    bool fixedOrder = (_flags & ParseFlags::ReuseTranslationUnits) != 0;
+
+    auto worker = [&](size_t workerIndex)
+    {
+        TraceEvents::SetThreadName("worker " + std::to_string(workerIndex));
+        StringPool::Scope strings(_strings);
+        auto next = [&](size_t index) { return fixedOrder ? index + threadCount : nextInput++; };
+        for (size_t index = fixedOrder ? workerIndex : nextInput++; index < inputFiles.size(); index = next(index))
+        {
+            ParseResult & result = results[index];
+            SetLogStream(result.log);
+            SetErrorStream(result.errors);
+            Parser parser(inputFiles[index], _flags, _cache, _contexts[workerIndex].get());
+            parser.SetAllowedPaths(_allowedPaths);
+            result.ok = parser.Parse(options);
+            if (result.ok)
+            {
+                result.ast.reset(new AST(parser.GetAST()));
+                result.symbols.Merge(parser.Symbols());
+            }
+        }
+        ResetLogStreams();
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t index = 0; index < threadCount; ++index)
+    {
+        threads.emplace_back(worker, index);
+    }
+    for (auto & thread : threads)
+    {
+        thread.join();
+    }
+
+    // Replay the output in input order, and stop at the first failure, as a serial run would.
+    for (auto & result : results)
+    {
+        LogStream() << result.log.str() << flush;
+        ErrorStream() << result.errors.str() << flush;
+        if (!result.ok)
+            return false;
+        _asts.push_back(*result.ast);
+        _symbolIndex.Merge(result.symbols);
+    }
+    return true;
+}
+
+using TreeMap = std::unordered_map<const Element *, const AST *>;
+
+// The tree holding the element, found through its top level element
+static const AST * FindTree(const Element * element, const TreeMap & trees)
+{
+    while (element->Parent() != nullptr)
+        element = element->Parent();
+    auto it = trees.find(element);
+    return (it != trees.end()) ? it->second : nullptr;
+}
+
+static void ResolveBaseTypes(const Container & container, const SymbolIndex & symbols, const TreeMap & trees, AST & ast)
+{
+    for (auto const & element : container.Contents())
+    {
+        if (element->IsObject())
+        {
+            for (auto const & base : static_cast<const Object &>(*element).BaseTypes())
+            {
+                if ((base->BaseType() != nullptr) || base->BaseUSR().empty())
+                    continue;
+                auto baseType = symbols.Find(base->BaseUSR());
+                if (baseType == nullptr)
+                    continue;
+                // The base class is kept by a weak link, which needs the arena of the tree it is declared in
+                auto tree = FindTree(baseType.get(), trees);
+                if (tree != nullptr)
+                    ast.LinkArena(tree->Arena());
+                base->SetBaseType(baseType);
+            }
+        }
+        if (element->IsObject() || (element->Kind() == ElementKind::Namespace))
+            ResolveBaseTypes(static_cast<const Container &>(*element), symbols, trees, ast);
+    }
+}
+
+void ParserPool::ResolveBaseTypes()
+{
+    TraceSpan span("resolve base types");
+    TreeMap trees;
+    for (auto const & ast : _asts)
+    {
+        for (auto const & element : ast.Contents())
+        {
+            trees[element.get()] = &ast;
+        }
+    }
+    for (auto & ast : _asts)
+    {
+        CPPParser::ResolveBaseTypes(ast, _symbolIndex, trees, ast);
+    }
+}
+
+} // namespace CPPParser
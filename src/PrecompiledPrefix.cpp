@@ -0,0 +1,310 @@
+#include "include/PrecompiledPrefix.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <dirent.h>
+#include <unistd.h>
+#include "include/Trace.h"
+#include "include/Utility.h"
+
+using namespace std;
+using namespace Utility;
+
+namespace CPPParser
+{
+
+// Change the format name whenever the way the prefix header is built changes, to invalidate existing headers.
+static const std::string PrefixFormat = "PSGenerator-prefix-1";
+
+static void inclusionVisitor(CXFile includedFile, CXSourceLocation *, unsigned, CXClientData clientData)
+{
+    std::vector<std::string> * files = reinterpret_cast<std::vector<std::string> *>(clientData);
+    files->push_back(ConvertString(clang_getFileName(includedFile)));
+}
+
+// Removes comments from the line, where inComment tracks block comments that span lines. Tabs become spaces.
+static std::string StripComments(const std::string & line, bool & inComment)
+{
+    std::string result;
+    for (size_t index = 0; index < line.length(); ++index)
+    {
+        if (inComment)
+        {
+            if (line.compare(index, 2, "*/") == 0)
+            {
+                inComment = false;
+                ++index;
+            }
+            continue;
+        }
+        if (line.compare(index, 2, "/*") == 0)
+        {
+            inComment = true;
+            ++index;
+            continue;
+        }
+        if (line.compare(index, 2, "//") == 0)
+            break;
+        result += (line[index] == '\t') ? ' ' : line[index];
+    }
+    return result;
+}
+
+static bool FileExists(const std::string & path)
+{
+    return std::ifstream(path).good();
+}
+
+PrecompiledPrefix::PrecompiledPrefix(const std::string & directory)
+    : _directory(directory)
+    , _temporary(directory.empty())
+    , _pchPath()
+    , _files()
+{
+    if (_temporary)
+    {
+        char directoryTemplate[] = "/tmp/PSGenerator.XXXXXX";
+        if (mkdtemp(directoryTemplate) != nullptr)
+            _directory = directoryTemplate;
+    }
+    while ((_directory.length() > 1) && (_directory[_directory.length() - 1] == '/'))
+        _directory.pop_back();
+}
+
+PrecompiledPrefix::~PrecompiledPrefix()
+{
+    if (!_temporary || _directory.empty())
+        return;
+    DIR * directory = opendir(_directory.c_str());
+    if (directory != nullptr)
+    {
+        for (dirent * entry = readdir(directory); entry != nullptr; entry = readdir(directory))
+        {
+            std::string name = entry->d_name;
+            if ((name != ".") && (name != ".."))
+                remove((_directory + "/" + name).c_str());
+        }
+        closedir(directory);
+    }
+    rmdir(_directory.c_str());
+}
+
+bool PrecompiledPrefix::Build(const std::vector<std::string> & inputFiles, const OptionsList & options,
+                              bool preprocessingRecord)
+{
+    _pchPath.clear();
+    _files.clear();
+    if ((inputFiles.size() < 2) || _directory.empty())
+        return false;
+
+    std::vector<std::vector<std::string>> prefixes;
+    for (auto const & inputFile : inputFiles)
+    {
+        prefixes.push_back(IncludePrefix(inputFile));
+    }
+    std::vector<std::string> prefix = CommonPrefix(prefixes);
+    if (prefix.empty())
+    {
+        TRACE_LOG(TraceCache, TraceLevel::Info, "No common include prefix, not using a precompiled header");
+        return false;
+    }
+
+    uint64_t hash = Hash(HashOffsetBasis, PrefixFormat);
+    for (auto const & line : prefix)
+    {
+        hash = Hash(hash, line);
+    }
+    for (auto const & option : options)
+    {
+        hash = Hash(hash, option);
+    }
+    if (preprocessingRecord)
+        hash = Hash(hash, "detailed-preprocessing-record");
+    std::string basePath = _directory + "/prefix-" + HexString(hash);
+    std::string headerPath = basePath + ".h";
+    std::string pchPath = basePath + ".pch";
+    std::string manifestPath = basePath + ".files";
+    if (FileExists(pchPath) && LoadManifest(manifestPath))
+    {
+        TRACE_LOG(TraceCache, TraceLevel::Info, "Using precompiled header " << pchPath);
+        _pchPath = pchPath;
+        return true;
+    }
+
+    _files.clear();
+    if (!CreateDirectory(_directory))
+        return false;
+    {
+        std::ofstream header(headerPath);
+        for (auto const & line : prefix)
+        {
+            header << line << endl;
+        }
+        if (!header)
+            return false;
+    }
+    if (!BuildPCH(headerPath, pchPath, options, preprocessingRecord) || !SaveManifest(manifestPath))
+    {
+        _files.clear();
+        return false;
+    }
+    TRACE_LOG(TraceCache, TraceLevel::Info, "Built precompiled header " << pchPath << " for " << prefix.size() << " includes");
+    _pchPath = pchPath;
+    return true;
+}
+
+std::vector<std::string> PrecompiledPrefix::IncludePrefix(const std::string & path)
+{
+    std::vector<std::string> result;
+    std::string directory;
+    std::string fileName;
+    std::string extension;
+    SplitPath(path, directory, fileName, extension);
+
+    std::ifstream file(path);
+    std::string line;
+    std::string guard;
+    bool inComment = false;
+    while (std::getline(file, line))
+    {
+        line = Trim(StripComments(line, inComment));
+        if (line.empty())
+            continue;
+        if (line[0] != '#')
+            break;
+        std::string directive = Trim(line.substr(1));
+        if (directive == "pragma once")
+            continue;
+        if ((directive.compare(0, 7, "ifndef ") == 0) && guard.empty() && result.empty())
+        {
+            guard = Trim(directive.substr(7));
+            continue;
+        }
+        if (!guard.empty() && (directive.compare(0, 7, "define ") == 0) && (Trim(directive.substr(7)) == guard))
+            continue;
+        if (directive.compare(0, 7, "include") != 0)
+            break;
+
+        std::string target = Trim(directive.substr(7));
+        size_t end = std::string::npos;
+        if (!target.empty() && (target[0] == '"'))
+            end = target.find('"', 1);
+        else if (!target.empty() && (target[0] == '<'))
+            end = target.find('>', 1);
+        if (end == std::string::npos)
+            break;
+        target = target.substr(0, end + 1);
+        if (target[0] == '"')
+        {
+            // The same quoted name may refer to different files for inputs in different directories
+            std::string name = target.substr(1, end - 1);
+            std::string localPath = directory.empty() ? name : directory + "/" + name;
+            if (FileExists(localPath))
+                target = "\"" + RealPath(localPath) + "\"";
+        }
+        result.push_back("#include " + target);
+    }
+    return result;
+}
+
+std::vector<std::string> PrecompiledPrefix::CommonPrefix(const std::vector<std::vector<std::string>> & prefixes)
+{
+    if (prefixes.empty())
+        return {};
+    std::vector<std::string> result = prefixes[0];
+    for (auto const & prefix : prefixes)
+    {
+        size_t length = 0;
+        while ((length < result.size()) && (length < prefix.size()) && (result[length] == prefix[length]))
+            ++length;
+        result.resize(length);
+    }
+    return result;
+}
+
+bool PrecompiledPrefix::LoadManifest(const std::string & manifestPath)
+{
+    std::ifstream manifest(manifestPath);
+    if (!manifest)
+        return false;
+    uint64_t storedHash {};
+    std::string fileName;
+    while (manifest >> storedHash >> std::ws && std::getline(manifest, fileName))
+    {
+        uint64_t hash {};
+        if (!HashFile(fileName, hash) || (hash != storedHash))
+        {
+            TRACE_LOG(TraceCache, TraceLevel::Info, "Precompiled header outdated (" << fileName << " changed)");
+            _files.clear();
+            return false;
+        }
+        _files.push_back(fileName);
+    }
+    return !_files.empty();
+}
+
+bool PrecompiledPrefix::SaveManifest(const std::string & manifestPath)
+{
+    std::ofstream manifest(manifestPath);
+    for (auto const & fileName : _files)
+    {
+        uint64_t hash {};
+        if (!HashFile(fileName, hash))
+            return false;
+        manifest << hash << " " << fileName << endl;
+    }
+    return static_cast<bool>(manifest);
+}
+
+bool PrecompiledPrefix::BuildPCH(const std::string & headerPath, const std::string & pchPath, const OptionsList & options,
+                                 bool preprocessingRecord)
+{
+    std::vector<const char *> args;
+    for (auto const & option : options)
+    {
+        args.push_back(option.c_str());
+    }
+    CXIndex index = clang_createIndex(0, 0);
+    unsigned parseOptions = CXTranslationUnit_Flags::CXTranslationUnit_Incomplete |
+                            CXTranslationUnit_Flags::CXTranslationUnit_ForSerialization;
+    if (preprocessingRecord)
+        parseOptions |= CXTranslationUnit_Flags::CXTranslationUnit_DetailedPreprocessingRecord;
+    CXTranslationUnit unit = nullptr;
+    CXErrorCode errorCode = clang_parseTranslationUnit2(
+        index,
+        headerPath.c_str(),
+        args.data(), static_cast<int>(args.size()),
+        nullptr, 0,
+        parseOptions,
+        &unit);
+    bool ok = (errorCode == CXErrorCode::CXError_Success) && (unit != nullptr);
+    for (unsigned i = 0; ok && (i < clang_getNumDiagnostics(unit)); ++i)
+    {
+        CXDiagnostic diagnostic = clang_getDiagnostic(unit, i);
+        if (clang_getDiagnosticSeverity(diagnostic) >= CXDiagnostic_Error)
+        {
+            // The inputs will report the same error when parsed without the precompiled header
+            TRACE_LOG(TraceCache, TraceLevel::Info, "Precompiled header not built: "
+                      << ConvertString(clang_getDiagnosticSpelling(diagnostic)));
+            ok = false;
+        }
+        clang_disposeDiagnostic(diagnostic);
+    }
+    if (ok)
+    {
+        clang_getInclusions(unit, inclusionVisitor, &_files);
+        // Save to a temporary file first, so concurrent runs never see a partially written header.
+        std::string temporaryPath = pchPath + "." + std::to_string(getpid());
+        ok = (clang_saveTranslationUnit(unit, temporaryPath.c_str(), clang_defaultSaveOptions(unit)) == CXSaveError_None) &&
+             (rename(temporaryPath.c_str(), pchPath.c_str()) == 0);
+        if (!ok)
+            remove(temporaryPath.c_str());
+    }
+    if (unit != nullptr)
+        clang_disposeTranslationUnit(unit);
+    clang_disposeIndex(index);
+    return ok;
+}
+
+} // namespace CPPParser
@@ -0,0 +1,61 @@
+#include "include/SourceFilter.h"
+
+#include "include/Utility.h"
+
+using namespace std;
+using namespace Utility;
+
+namespace CPPParser
+{
+
+SourceFilter::SourceFilter(bool mainFileOnly, bool skipSystemHeaders, const std::vector<std::string> & allowedPaths)
+    : _mainFileOnly(mainFileOnly || !allowedPaths.empty())
+    , _skipSystemHeaders(skipSystemHeaders)
+    , _allowedPaths()
+    , _files()
+{
+    // File names reported by libclang are made absolute the same way before matching
+    for (auto const & path : allowedPaths)
+    {
+        _allowedPaths.push_back(RealPath(path));
+    }
+}
+
+bool SourceFilter::Accept(CXCursor cursor)
+{
+    CXSourceLocation location = clang_getCursorLocation(cursor);
+    if (clang_Location_isFromMainFile(location) != 0)
+        return true;
+    if (_skipSystemHeaders && (clang_Location_isInSystemHeader(location) != 0))
+        return false;
+    if (!_mainFileOnly)
+        return true;
+
+    CXFile file;
+    clang_getExpansionLocation(location, &file, nullptr, nullptr, nullptr);
+    // Without a file, the cursor is builtin, such as a predefined macro
+    if (file == nullptr)
+        return false;
+    auto it = _files.find(file);
+    if (it != _files.end())
+        return it->second;
+    bool accept = MatchesPath(RealPath(ConvertString(clang_getFileName(file))), _allowedPaths);
+    _files.insert({file, accept});
+    return accept;
+}
+
+bool SourceFilter::MatchesPath(const std::string & path, const std::vector<std::string> & allowedPaths)
+{
+    for (auto const & allowedPath : allowedPaths)
+    {
+        if (allowedPath.empty() || (path.compare(0, allowedPath.length(), allowedPath) != 0))
+            continue;
+        // The path itself, or a path below it, but not a path that only starts with the same characters
+        if ((path.length() == allowedPath.length()) || (allowedPath.back() == '/') ||
+            (path[allowedPath.length()] == '/'))
+            return true;
+    }
+    return false;
+}
+
+} // namespace CPPParser
@@ -0,0 +1,350 @@
+#include "include/Stats.h"
+
+#include <atomic>
+#include <iomanip>
+#include <sstream>
+#include <sys/resource.h>
+#include <time.h>
+#include "include/Element.h"
+#include "include/Utility.h"
+
+using namespace std;
+using namespace Utility;
+
+namespace CPPParser
+{
+
+// Node counts are updated from every parser thread, so they are kept apart from the data guarded by the lock
+static const size_t MaxElementKinds = 256;
+static std::atomic<uint64_t> nodeCounts[MaxElementKinds];
+static std::atomic<uint64_t> byteCount;
+
+std::atomic<bool> Stats::_enabled(false);
+std::mutex Stats::_lock;
+std::vector<Stats::FileStats> Stats::_files;
+std::unordered_map<std::string, size_t> Stats::_fileIndex;
+std::vector<uint64_t> Stats::_cursorsVisited;
+std::vector<uint64_t> Stats::_cursorsHandled;
+
+StatsTimer::StatsTimer()
+    : _wallStart(std::chrono::steady_clock::now())
+    , _cpuStart(ThreadCPUSeconds())
+{
+}
+
+PhaseTime StatsTimer::Elapsed() const
+{
+    PhaseTime result;
+    result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - _wallStart).count();
+    result.cpuSeconds = ThreadCPUSeconds() - _cpuStart;
+    return result;
+}
+
+double StatsTimer::ThreadCPUSeconds()
+{
+    timespec time {};
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0)
+        return 0.0;
+    return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_nsec) / 1e9;
+}
+
+void Stats::Enable(bool enable)
+{
+    _enabled = enable;
+}
+
+void Stats::Reset()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    _files.clear();
+    _fileIndex.clear();
+    _cursorsVisited.clear();
+    _cursorsHandled.clear();
+    for (auto & count : nodeCounts)
+    {
+        count = 0;
+    }
+    byteCount = 0;
+}
+
+static void AddCounts(std::vector<uint64_t> & total, const std::vector<uint64_t> & counts)
+{
+    if (total.size() < counts.size())
+        total.resize(counts.size());
+    for (size_t index = 0; index < counts.size(); ++index)
+    {
+        total[index] += counts[index];
+    }
+}
+
+void Stats::Add(const std::string & file, const ParseStats & stats)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    FileStats & fileStats = File(file);
+    for (size_t index = 0; index < StatsPhaseCount; ++index)
+    {
+        fileStats.phases[index] += stats.phases[index];
+    }
+    fileStats.memory += stats.memory;
+    AddCounts(_cursorsVisited, stats.cursorsVisited);
+    AddCounts(_cursorsHandled, stats.cursorsHandled);
+}
+
+void Stats::AddTime(const std::string & file, StatsPhase phase, const PhaseTime & time)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    File(file).phases[static_cast<size_t>(phase)] += time;
+}
+
+PhaseTime Stats::Total(StatsPhase phase)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    PhaseTime result;
+    for (auto const & file : _files)
+    {
+        result += file.phases[static_cast<size_t>(phase)];
+    }
+    return result;
+}
+
+uint64_t Stats::Nodes(ElementKind kind)
+{
+    return nodeCounts[static_cast<size_t>(kind)];
+}
+
+uint64_t Stats::Bytes()
+{
+    return byteCount;
+}
+
+MemoryUsage Stats::Memory(const std::string & file)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    auto it = _fileIndex.find(file);
+    return (it != _fileIndex.end()) ? _files[it->second].memory : MemoryUsage();
+}
+
+uint64_t Stats::PeakResidentBytes()
+{
+    rusage usage {};
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    // Linux reports the size in kilobytes
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+}
+
+const char * Stats::PhaseName(StatsPhase phase)
+{
+    switch (phase)
+    {
+        case StatsPhase::Cache:     return "cache";
+        case StatsPhase::Parse:     return "parse";
+        case StatsPhase::Visit:     return "visit";
+        case StatsPhase::TreeBuild: return "tree-build";
+        case StatsPhase::Output:    return "output";
+    }
+    return "";
+}
+
+static void ReportTime(std::ostream & stream, const PhaseTime & time)
+{
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(3) << time.wallSeconds << " / " << time.cpuSeconds;
+    stream << std::setw(20) << text.str();
+}
+
+// Supporting structures of a MemoryUsage, and the total, in the order they are reported
+static std::vector<std::pair<const char *, MemoryCount>> MemoryCategories(const MemoryUsage & memory)
+{
+    return {
+        {"parameters", memory.parameters},
+        {"fileNames", memory.fileNames},
+        {"strings", memory.strings},
+        {"lookupMaps", memory.lookupMaps},
+        {"symbols", memory.symbols},
+        {"translationUnits", memory.translationUnits},
+        {"total", memory.Total()},
+    };
+}
+
+static void ReportMemory(std::ostream & stream, const char * name, const MemoryCount & count)
+{
+    stream << "    " << std::left << std::setw(36) << name << std::right
+           << std::setw(12) << count.count << " / " << count.bytes << endl;
+}
+
+void Stats::Report(std::ostream & stream)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    std::array<PhaseTime, StatsPhaseCount> total {};
+    stream << "Time per phase (wall / CPU seconds)" << endl;
+    stream << std::left << std::setw(40) << "  File" << std::right;
+    for (size_t index = 0; index < StatsPhaseCount; ++index)
+    {
+        stream << std::setw(20) << PhaseName(static_cast<StatsPhase>(index));
+    }
+    stream << endl;
+    for (auto const & file : _files)
+    {
+        stream << "  " << std::left << std::setw(38) << file.path << std::right;
+        for (size_t index = 0; index < StatsPhaseCount; ++index)
+        {
+            ReportTime(stream, file.phases[index]);
+            total[index] += file.phases[index];
+        }
+        stream << endl;
+    }
+    stream << std::left << std::setw(40) << "  Total" << std::right;
+    for (size_t index = 0; index < StatsPhaseCount; ++index)
+    {
+        ReportTime(stream, total[index]);
+    }
+    stream << endl;
+
+    stream << "Cursors per kind (visited / handled)" << endl;
+    for (size_t index = 0; index < _cursorsVisited.size(); ++index)
+    {
+        if (_cursorsVisited[index] == 0)
+            continue;
+        uint64_t handled = (index < _cursorsHandled.size()) ? _cursorsHandled[index] : 0;
+        stream << "  " << std::left << std::setw(38)
+               << ConvertString(clang_getCursorKindSpelling(static_cast<CXCursorKind>(index))) << std::right
+               << std::setw(12) << _cursorsVisited[index] << " / " << handled << endl;
+    }
+
+    stream << "Nodes created per kind" << endl;
+    for (size_t index = 0; index < MaxElementKinds; ++index)
+    {
+        if (nodeCounts[index] == 0)
+            continue;
+        stream << "  " << std::left << std::setw(38) << ElementKindName(static_cast<ElementKind>(index)) << std::right
+               << std::setw(12) << nodeCounts[index] << endl;
+    }
+
+    stream << "Memory per file (count / approximate bytes)" << endl;
+    for (auto const & file : _files)
+    {
+        stream << "  " << file.path << endl;
+        for (size_t index = 0; index < file.memory.nodes.size(); ++index)
+        {
+            if (file.memory.nodes[index].count != 0)
+                ReportMemory(stream, ElementKindName(static_cast<ElementKind>(index)), file.memory.nodes[index]);
+        }
+        for (auto const & category : MemoryCategories(file.memory))
+        {
+            ReportMemory(stream, category.first, category.second);
+        }
+    }
+    stream << "Peak resident set size: " << PeakResidentBytes() << " bytes" << endl;
+
+    stream << "Bytes emitted: " << byteCount << endl;
+}
+
+static void ReportTimeJSON(std::ostream & stream, const std::array<PhaseTime, StatsPhaseCount> & phases)
+{
+    stream << "{";
+    for (size_t index = 0; index < StatsPhaseCount; ++index)
+    {
+        stream << ((index > 0) ? ", " : "") << JSONString(Stats::PhaseName(static_cast<StatsPhase>(index)))
+               << ": {\"wall\": " << phases[index].wallSeconds << ", \"cpu\": " << phases[index].cpuSeconds << "}";
+    }
+    stream << "}";
+}
+
+static void ReportMemoryJSON(std::ostream & stream, const MemoryCount & count)
+{
+    stream << "{\"count\": " << count.count << ", \"bytes\": " << count.bytes << "}";
+}
+
+static void ReportMemoryJSON(std::ostream & stream, const MemoryUsage & memory)
+{
+    stream << "{\"nodes\": {";
+    bool first = true;
+    for (size_t index = 0; index < memory.nodes.size(); ++index)
+    {
+        if (memory.nodes[index].count == 0)
+            continue;
+        stream << (first ? "" : ", ") << JSONString(ElementKindName(static_cast<ElementKind>(index))) << ": ";
+        ReportMemoryJSON(stream, memory.nodes[index]);
+        first = false;
+    }
+    stream << "}";
+    for (auto const & category : MemoryCategories(memory))
+    {
+        stream << ", " << JSONString(category.first) << ": ";
+        ReportMemoryJSON(stream, category.second);
+    }
+    stream << "}";
+}
+
+void Stats::ReportJSON(std::ostream & stream)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    std::array<PhaseTime, StatsPhaseCount> total {};
+    stream << "{" << endl << "  \"files\": [";
+    for (size_t fileIndex = 0; fileIndex < _files.size(); ++fileIndex)
+    {
+        const FileStats & file = _files[fileIndex];
+        stream << ((fileIndex > 0) ? "," : "") << endl
+               << "    {\"path\": " << JSONString(file.path) << ", \"phases\": ";
+        ReportTimeJSON(stream, file.phases);
+        stream << ", \"memory\": ";
+        ReportMemoryJSON(stream, file.memory);
+        stream << "}";
+        for (size_t index = 0; index < StatsPhaseCount; ++index)
+        {
+            total[index] += file.phases[index];
+        }
+    }
+    stream << endl << "  ]," << endl << "  \"total\": ";
+    ReportTimeJSON(stream, total);
+
+    stream << "," << endl << "  \"cursors\": [";
+    bool first = true;
+    for (size_t index = 0; index < _cursorsVisited.size(); ++index)
+    {
+        if (_cursorsVisited[index] == 0)
+            continue;
+        uint64_t handled = (index < _cursorsHandled.size()) ? _cursorsHandled[index] : 0;
+        stream << (first ? "" : ",") << endl << "    {\"kind\": "
+               << JSONString(ConvertString(clang_getCursorKindSpelling(static_cast<CXCursorKind>(index))))
+               << ", \"id\": " << index << ", \"visited\": " << _cursorsVisited[index]
+               << ", \"handled\": " << handled << "}";
+        first = false;
+    }
+
+    stream << endl << "  ]," << endl << "  \"nodes\": {";
+    first = true;
+    for (size_t index = 0; index < MaxElementKinds; ++index)
+    {
+        if (nodeCounts[index] == 0)
+            continue;
+        stream << (first ? "" : ",") << endl << "    "
+               << JSONString(ElementKindName(static_cast<ElementKind>(index))) << ": " << nodeCounts[index];
+        first = false;
+    }
+    stream << endl << "  }," << endl << "  \"peakResidentBytes\": " << PeakResidentBytes() << "," << endl
+           << "  \"bytesEmitted\": " << byteCount << endl << "}" << endl;
+}
+
+void Stats::AddNode(ElementKind kind)
+{
+    nodeCounts[static_cast<size_t>(kind)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void Stats::AddBytes(size_t count)
+{
+    byteCount.fetch_add(count, std::memory_order_relaxed);
+}
+
+Stats::FileStats & Stats::File(const std::string & path)
+{
+    auto it = _fileIndex.find(path);
+    if (it != _fileIndex.end())
+        return _files[it->second];
+    _fileIndex.insert({path, _files.size()});
+    _files.push_back({path, {}, MemoryUsage()});
+    return _files.back();
+}
+
+} // namespace CPPParser
@@ -0,0 +1,113 @@
+#include "include/SymbolIndex.h"
+
+#include "include/Utility.h"
+
+using namespace std;
+using namespace Utility;
+
+namespace CPPParser
+{
+
+SymbolIndex::SymbolIndex()
+    : _lock()
+    , _symbols()
+{
+}
+
+bool SymbolIndex::Add(const std::string & usr, Declaration::Ptr declaration)
+{
+    if (usr.empty() || (declaration == nullptr))
+        return false;
+    std::lock_guard<std::mutex> lock(_lock);
+    return _symbols.insert({usr, std::move(declaration)}).second;
+}
+
+Declaration::Ptr SymbolIndex::Find(const std::string & usr) const
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    auto it = _symbols.find(usr);
+    return (it != _symbols.end()) ? it->second : nullptr;
+}
+
+void SymbolIndex::Merge(const SymbolIndex & other)
+{
+    if (&other == this)
+        return;
+    // Copied first, so the two indices are never locked at the same time
+    std::vector<std::pair<std::string, Declaration::Ptr>> symbols = other.Entries();
+    std::lock_guard<std::mutex> lock(_lock);
+    for (auto & symbol : symbols)
+    {
+        _symbols.insert(std::move(symbol));
+    }
+}
+
+std::vector<std::pair<std::string, Declaration::Ptr>> SymbolIndex::Entries() const
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    return {_symbols.begin(), _symbols.end()};
+}
+
+size_t SymbolIndex::Count() const
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    return _symbols.size();
+}
+
+size_t SymbolIndex::MemorySize() const
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    size_t result = HashTableMemory(_symbols);
+    for (auto const & element : _symbols)
+    {
+        result += StringMemory(element.first) - sizeof(std::string);
+    }
+    return result;
+}
+
+void SymbolIndex::Clear()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    _symbols.clear();
+}
+
+void SymbolIndex::Show(std::ostream & stream) const
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    stream << "Symbol index:" << endl;
+    for (auto const & element : _symbols)
+    {
+        stream << element.second->QualifiedName() << " : " << element.first << endl;
+    }
+}
+
+std::string SymbolIndex::USR(CXCursor token)
+{
+    return ConvertString(clang_getCursorUSR(token));
+}
+
+std::string SymbolIndex::USR(CXType type)
+{
+    CXCursor declaration = clang_getTypeDeclaration(clang_getCanonicalType(type));
+    if (clang_Cursor_isNull(declaration) || (clang_getCursorKind(declaration) == CXCursor_NoDeclFound))
+        return {};
+    return USR(declaration);
+}
+
+bool SymbolIndex::IsTypeKind(CXCursorKind kind)
+{
+    switch (kind)
+    {
+        case CXCursorKind::CXCursor_ClassDecl:
+        case CXCursorKind::CXCursor_StructDecl:
+        case CXCursorKind::CXCursor_ClassTemplate:
+        case CXCursorKind::CXCursor_EnumDecl:
+        case CXCursorKind::CXCursor_TypedefDecl:
+        case CXCursorKind::CXCursor_TypeAliasDecl:
+            return true;
+        default:
+            return false;
+    }
+}
+
+} // namespace CPPParser
@@ -0,0 +1,64 @@
+#include "include/Trace.h"
+
+#include <vector>
+
+using namespace std;
+
+namespace Utility
+{
+
+std::atomic<TraceCategory> Trace::_categories(TraceCategory::TraceNone);
+std::atomic<TraceLevel> Trace::_level(TraceLevel::Off);
+
+void Trace::Enable(TraceCategory categories, TraceLevel level)
+{
+    _categories = categories;
+    _level = level;
+}
+
+void Trace::Disable()
+{
+    Enable(TraceCategory::TraceNone, TraceLevel::Off);
+}
+
+bool Trace::Configure(const std::string & specification)
+{
+    std::string categoryList = specification;
+    TraceLevel level = TraceLevel::Debug;
+    size_t colonPos = specification.find(':');
+    if (colonPos != string::npos)
+    {
+        categoryList = specification.substr(0, colonPos);
+        std::string levelName = Trim(specification.substr(colonPos + 1));
+        if (levelName == "error")
+            level = TraceLevel::Error;
+        else if (levelName == "info")
+            level = TraceLevel::Info;
+        else if (levelName == "debug")
+            level = TraceLevel::Debug;
+        else
+            return false;
+    }
+    std::vector<std::string> categoryNames;
+    Split(categoryList, ',', categoryNames);
+    uint16_t categories = TraceCategory::TraceNone;
+    for (auto const & categoryName : categoryNames)
+    {
+        if (categoryName == "cursor")
+            categories |= TraceCategory::TraceCursor;
+        else if (categoryName == "tree-build")
+            categories |= TraceCategory::TraceTreeBuild;
+        else if (categoryName == "codegen")
+            categories |= TraceCategory::TraceCodeGen;
+        else if (categoryName == "cache")
+            categories |= TraceCategory::TraceCache;
+        else if (categoryName == "all")
+            categories |= TraceCategory::TraceAll;
+        else
+            return false;
+    }
+    Enable(static_cast<TraceCategory>(categories), level);
+    return true;
+}
+
+} // namespace Utility
@@ -0,0 +1,106 @@
+#include "include/TraceEvents.h"
+
+#include <atomic>
+#include <iomanip>
+#include <unistd.h>
+#include "include/Utility.h"
+
+using namespace std;
+using namespace Utility;
+
+namespace CPPParser
+{
+
+std::atomic<bool> TraceEvents::_enabled(false);
+std::mutex TraceEvents::_lock;
+TraceEvents::Clock::time_point TraceEvents::_origin = TraceEvents::Clock::now();
+std::vector<TraceEvents::Event> TraceEvents::_events;
+std::vector<std::pair<unsigned, std::string>> TraceEvents::_threadNames;
+
+void TraceEvents::Enable(bool enable)
+{
+    _enabled = enable;
+}
+
+void TraceEvents::Reset()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    _origin = Clock::now();
+    _events.clear();
+    _threadNames.clear();
+}
+
+unsigned TraceEvents::ThreadId()
+{
+    // Small numbers in order of first use read better in a viewer than system thread ids
+    static std::atomic<unsigned> nextThreadId(1);
+    static thread_local unsigned threadId = nextThreadId++;
+    return threadId;
+}
+
+void TraceEvents::SetThreadName(const std::string & name)
+{
+    if (!_enabled)
+        return;
+    unsigned threadId = ThreadId();
+    std::lock_guard<std::mutex> lock(_lock);
+    for (auto & threadName : _threadNames)
+    {
+        if (threadName.first == threadId)
+        {
+            threadName.second = name;
+            return;
+        }
+    }
+    _threadNames.emplace_back(threadId, name);
+}
+
+void TraceEvents::AddSpan(const char * name, const std::string & file, Clock::time_point start, Clock::time_point end)
+{
+    unsigned threadId = ThreadId();
+    std::lock_guard<std::mutex> lock(_lock);
+    _events.push_back({name, file, threadId, start, end});
+}
+
+size_t TraceEvents::Count()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    return _events.size();
+}
+
+void TraceEvents::Write(std::ostream & stream)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    int processId = static_cast<int>(getpid());
+    std::ios::fmtflags flags = stream.flags();
+    std::streamsize precision = stream.precision();
+    stream << std::fixed << std::setprecision(3);
+    stream << "{\"traceEvents\": [";
+    bool first = true;
+    for (auto const & threadName : _threadNames)
+    {
+        stream << (first ? "" : ",") << endl
+               << "  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": " << processId
+               << ", \"tid\": " << threadName.first << ", \"args\": {\"name\": " << JSONString(threadName.second) << "}}";
+        first = false;
+    }
+    for (auto const & event : _events)
+    {
+        // Timestamps are in microseconds since recording started
+        double start = std::chrono::duration<double, std::micro>(event.start - _origin).count();
+        double duration = std::chrono::duration<double, std::micro>(event.end - event.start).count();
+        stream << (first ? "" : ",") << endl
+               << "  {\"name\": " << JSONString(event.name) << ", \"cat\": \"psgenerator\", \"ph\": \"X\""
+               << ", \"ts\": " << start << ", \"dur\": " << duration
+               << ", \"pid\": " << processId << ", \"tid\": " << event.threadId;
+        if (!event.file.empty())
+            stream << ", \"args\": {\"file\": " << JSONString(event.file) << "}";
+        stream << "}";
+        first = false;
+    }
+    stream << endl << "], \"displayTimeUnit\": \"ms\"}" << endl;
+    stream.flags(flags);
+    stream.precision(precision);
+}
+
+} // namespace CPPParser
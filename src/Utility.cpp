@@ -1,10 +1,45 @@
 #include "include/Utility.h"
 
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <sys/stat.h>
+
 using namespace std;
 
 namespace Utility
 {
 
+static thread_local std::ostream * _logStream = &std::cout;
+static thread_local std::ostream * _errorStream = &std::cerr;
+
+std::ostream & LogStream()
+{
+    return *_logStream;
+}
+
+std::ostream & ErrorStream()
+{
+    return *_errorStream;
+}
+
+void SetLogStream(std::ostream & stream)
+{
+    _logStream = &stream;
+}
+
+void SetErrorStream(std::ostream & stream)
+{
+    _errorStream = &stream;
+}
+
+void ResetLogStreams()
+{
+    _logStream = &std::cout;
+    _errorStream = &std::cerr;
+}
+
 string Trim(const string & input)
 {
     size_t first = 0;
@@ -60,4 +95,113 @@ void SplitPath(const string & path, string & directory, string & fileName, strin
     }
 }
 
+bool ParseNumber(const string & text, unsigned & value)
+{
+    if (text.empty() || (text.find_first_not_of("0123456789") != string::npos))
+        return false;
+    errno = 0;
+    unsigned long long result = strtoull(text.c_str(), nullptr, 10);
+    if ((errno == ERANGE) || (result > numeric_limits<unsigned>::max()))
+        return false;
+    value = static_cast<unsigned>(result);
+    return true;
+}
+
+string RealPath(const string & path)
+{
+    char * resolved = realpath(path.c_str(), nullptr);
+    if (resolved == nullptr)
+        return path;
+    string result = resolved;
+    free(resolved);
+    return result;
+}
+
+bool CreateDirectory(const string & path)
+{
+    for (size_t slashPos = path.find('/', 1); ; slashPos = path.find('/', slashPos + 1))
+    {
+        string directory = path.substr(0, slashPos);
+        if ((mkdir(directory.c_str(), 0777) != 0) && (errno != EEXIST))
+            return false;
+        if (slashPos == string::npos)
+            return true;
+    }
+}
+
+static const uint64_t HashPrime = 1099511628211ULL;
+
+uint64_t Hash(uint64_t hash, const char * data, size_t size)
+{
+    for (size_t index = 0; index < size; ++index)
+    {
+        hash ^= static_cast<unsigned char>(data[index]);
+        hash *= HashPrime;
+    }
+    return hash;
+}
+
+uint64_t Hash(uint64_t hash, const string & value)
+{
+    return Hash(hash, value.c_str(), value.size() + 1);
+}
+
+bool HashFile(const string & path, uint64_t & hash)
+{
+    ifstream file(path, ios::binary);
+    if (!file)
+        return false;
+    hash = HashOffsetBasis;
+    char buffer[16384];
+    while (file.read(buffer, sizeof(buffer)) || (file.gcount() > 0))
+    {
+        hash = Hash(hash, buffer, static_cast<size_t>(file.gcount()));
+    }
+    return true;
+}
+
+string HexString(uint64_t value)
+{
+    static const char digits[] = "0123456789abcdef";
+    string result(16, '0');
+    for (size_t index = 0; index < result.size(); ++index)
+    {
+        result[result.size() - index - 1] = digits[value & 0xF];
+        value >>= 4;
+    }
+    return result;
+}
+
+string JSONString(const string & value)
+{
+    static const char digits[] = "0123456789abcdef";
+    string result = "\"";
+    for (char ch : value)
+    {
+        unsigned char code = static_cast<unsigned char>(ch);
+        if ((ch == '"') || (ch == '\\'))
+        {
+            result += '\\';
+            result += ch;
+        }
+        else if (code < 0x20)
+        {
+            result += "\\u00";
+            result += digits[code >> 4];
+            result += digits[code & 0xF];
+        }
+        else
+            result += ch;
+    }
+    result += '"';
+    return result;
+}
+
+size_t StringMemory(const string & value)
+{
+    const char * object = reinterpret_cast<const char *>(&value);
+    bool local = (value.data() >= object) && (value.data() < object + sizeof(string));
+    return sizeof(string) + (local ? 0 : value.capacity() + 1);
+}
+
 } // namespace Utility
@@ -36,6 +36,7 @@ inline std::string EnumAnonymousHeader() { return CombinePath(TestRoot(), "EnumA
 inline std::string InheritanceHeader() { return CombinePath(TestRoot(), "Inheritance.h"); }
 inline std::string TemplateFunctionHeader() { return CombinePath(TestRoot(), "TemplateFunction.h"); }
 inline std::string TemplateClassHeader() { return CombinePath(TestRoot(), "TemplateClass.h"); }
+inline std::string InlineBodiesHeader() { return CombinePath(TestRoot(), "InlineBodies.h"); }
 inline std::string IMemoryHeader() { return CombinePath(TestRoot(), "IMemory.hpp"); }
 inline std::string IPluginHeader() { return CombinePath(TestRoot(), "IPlugin.h"); }
 
@@ -1,6 +1,8 @@
 #include <unittest-c++/UnitTestC++.h>
 
 #include <iostream>
+#include <thread>
+#include <vector>
 #include <include/CodeGenerator.h>
 #include <include/TestData.h>
 
@@ -27,6 +29,123 @@ TEST_FIXTURE(ASTBuildTest, EmptyAST)
     AST ast;
 
     EXPECT_FALSE(ast.IsValid());
+    EXPECT_TRUE(ElementKind::AST == ast.Kind());
+}
+
+TEST_FIXTURE(ASTBuildTest, AddSortsByKind)
+{
+    AST ast;
+    auto aNamespace = make_shared<Namespace>(Element::WeakPtr(), SourceLocation(), "NS");
+    auto aClass = make_shared<Class>(aNamespace, SourceLocation(), "A", AccessSpecifier::Public);
+    aClass->Add(make_shared<Constructor>(aClass, SourceLocation(), "A", AccessSpecifier::Public, ParameterList(), FunctionFlags::Default));
+    aClass->Add(make_shared<Destructor>(aClass, SourceLocation(), "~A", AccessSpecifier::Public, FunctionFlags::Virtual));
+    aClass->Add(make_shared<Method>(aClass, SourceLocation(), "DoIt", AccessSpecifier::Public, "int", ParameterList(), FunctionFlags::None));
+    aClass->Add(make_shared<DataMember>(aClass, SourceLocation(), "x", AccessSpecifier::Private, "int"));
+    aClass->Add(make_shared<Enum>(aClass, SourceLocation(), "E", AccessSpecifier::Public, ""));
+    aNamespace->Add(aClass);
+    aNamespace->Add(make_shared<Struct>(aNamespace, SourceLocation(), "B", AccessSpecifier::Public));
+    aNamespace->Add(make_shared<Typedef>(aNamespace, SourceLocation(), "T", AccessSpecifier::Invalid, "int"));
+    aNamespace->Add(make_shared<Variable>(aNamespace, SourceLocation(), "v", AccessSpecifier::Invalid, "int"));
+    aNamespace->Add(make_shared<Function>(aNamespace, SourceLocation(), "f", "void", ParameterList(), FunctionFlags::None));
+    ast.Add(aNamespace);
+
+    EXPECT_EQ(size_t {1}, ast.Namespaces().size());
+    EXPECT_EQ(size_t {5}, aNamespace->Contents().size());
+    EXPECT_EQ(size_t {1}, aNamespace->Classes().size());
+    EXPECT_EQ(size_t {1}, aNamespace->Structs().size());
+    EXPECT_EQ(size_t {1}, aNamespace->Typedefs().size());
+    EXPECT_EQ(size_t {1}, aNamespace->Variables().size());
+    EXPECT_EQ(size_t {1}, aNamespace->Functions().size());
+    EXPECT_EQ(size_t {5}, aClass->Contents().size());
+    EXPECT_EQ(size_t {1}, aClass->Constructors().size());
+    EXPECT_EQ(size_t {1}, aClass->Destructors().size());
+    EXPECT_EQ(size_t {1}, aClass->Methods().size());
+    EXPECT_EQ(size_t {1}, aClass->DataMembers().size());
+    EXPECT_EQ(size_t {1}, aClass->Enums().size());
+    EXPECT_TRUE(aClass->IsObject());
+    EXPECT_FALSE(aNamespace->IsObject());
+    EXPECT_TRUE(aClass->Methods()[0]->Parent()->IsObject());
+}
+
+TEST_FIXTURE(ASTBuildTest, FindByName)
+{
+    auto aNamespace = make_shared<Namespace>(Element::WeakPtr(), SourceLocation(), "Exchange");
+    const int count = 1000;
+    for (int index = 0; index < count; ++index)
+    {
+        aNamespace->Add(make_shared<Struct>(aNamespace, SourceLocation(), "I" + std::to_string(index), AccessSpecifier::Public));
+    }
+    // A class with the name of an existing struct is indexed separately, the first of each kind is found
+    auto aClass = make_shared<Class>(aNamespace, SourceLocation(), "I1", AccessSpecifier::Public);
+    aNamespace->Add(aClass);
+    aNamespace->Add(make_shared<Class>(aNamespace, SourceLocation(), "I1", AccessSpecifier::Public));
+
+    Struct::Ptr aStruct;
+    for (int index = 0; index < count; ++index)
+    {
+        ASSERT_TRUE(aNamespace->FindStruct("I" + std::to_string(index), aStruct));
+        EXPECT_EQ(aNamespace->Structs()[static_cast<size_t>(index)], aStruct);
+    }
+    Class::Ptr foundClass;
+    EXPECT_TRUE(aNamespace->FindClass("I1", foundClass));
+    EXPECT_EQ(aClass, foundClass);
+    EXPECT_FALSE(aNamespace->FindClass("I2", foundClass));
+    EXPECT_TRUE(foundClass == nullptr);
+    EXPECT_FALSE(aNamespace->FindStruct("ASTBuildTestUnknownName", aStruct));
+    Namespace::Ptr foundNamespace;
+    EXPECT_FALSE(aNamespace->FindNamespace("I1", foundNamespace));
+}
+
+TEST_FIXTURE(ASTBuildTest, QualifiedNamesAreKept)
+{
+    auto aNamespace = make_shared<Namespace>(Element::WeakPtr(), SourceLocation(), "NS");
+    auto aClassTemplate = make_shared<ClassTemplate>(aNamespace, SourceLocation(), "T", AccessSpecifier::Public);
+    aNamespace->Add(aClassTemplate);
+    EXPECT_EQ("class template<> NS::T", aClassTemplate->QualifiedDescription());
+    // Adding a template parameter changes the name
+    aClassTemplate->AddTemplateParameter("X");
+    auto aMethod = make_shared<Method>(aClassTemplate, SourceLocation(), "M", AccessSpecifier::Public, "int",
+                                       ParameterList{Parameter("a", "int")}, FunctionFlags::None);
+    aClassTemplate->Add(aMethod);
+    EXPECT_EQ("class template<class X> NS::T", aClassTemplate->QualifiedDescription());
+    EXPECT_EQ("int template<class X> NS::T::M(int)", aMethod->QualifiedName());
+    EXPECT_EQ(&aMethod->QualifiedName(), &aMethod->QualifiedName());
+    EXPECT_EQ(&aNamespace->QualifiedName(), &aNamespace->QualifiedName());
+}
+
+TEST_FIXTURE(ASTBuildTest, TemplateParameterResetsNamesBelow)
+{
+    auto aClassTemplate = make_shared<ClassTemplate>(Element::WeakPtr(), SourceLocation(), "T", AccessSpecifier::Public);
+    auto aMethod = make_shared<Method>(aClassTemplate, SourceLocation(), "M", AccessSpecifier::Public, "int",
+                                       ParameterList(), FunctionFlags::None);
+    aClassTemplate->Add(aMethod);
+    EXPECT_EQ("int template<> T::M()", aMethod->QualifiedName());
+    aClassTemplate->AddTemplateParameter("X");
+    EXPECT_EQ("int template<class X> T::M()", aMethod->QualifiedName());
+}
+
+TEST_FIXTURE(ASTBuildTest, QualifiedNamesFromThreads)
+{
+    auto aNamespace = make_shared<Namespace>(Element::WeakPtr(), SourceLocation(), "NS");
+    auto aClass = make_shared<Class>(aNamespace, SourceLocation(), "C", AccessSpecifier::Public);
+    aNamespace->Add(aClass);
+    const size_t threadCount = 4;
+    std::vector<const std::string *> names(threadCount);
+    std::vector<std::thread> threads;
+    for (size_t index = 0; index < threadCount; ++index)
+    {
+        threads.emplace_back([&names, &aClass, index]() { names[index] = &aClass->QualifiedName(); });
+    }
+    for (auto & thread : threads)
+    {
+        thread.join();
+    }
+    // Every thread gets the name that was kept
+    for (size_t index = 0; index < threadCount; ++index)
+    {
+        EXPECT_EQ(&aClass->QualifiedName(), names[index]);
+    }
+    EXPECT_EQ("NS::C", aClass->QualifiedName());
 }
 
 } // namespace Test
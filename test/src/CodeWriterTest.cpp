@@ -0,0 +1,88 @@
+#include <unittest-c++/UnitTestC++.h>
+#include <sstream>
+#include <benchmark/SyntheticTree.h>
+#include <include/CodeGenerator.h>
+#include <include/CodeWriter.h>
+
+namespace CPPParser {
+namespace Test {
+
+class CodeWriterTest : public ::UnitTestCpp::TestFixture {
+};
+
+TEST_FIXTURE(CodeWriterTest, WritesText)
+{
+    std::ostringstream stream;
+    {
+        CodeWriter writer(stream);
+        writer.Indent(0) << "namespace " << std::string("NS") << " {" << EndLine;
+        writer.Indent(1) << InternedString("x") << " = " << -42 << ',' << ' ' << 1234567890123LL << EndLine;
+        writer.Indent(1) << AccessSpecifier::Protected << " " << AccessSpecifier::Invalid << EndLine;
+        writer.Indent(0) << "}" << EndLine;
+    }
+    std::string expected =
+        "namespace NS {\n"
+        "    x = -42, 1234567890123\n"
+        "    protected \n"
+        "}\n";
+    EXPECT_EQ(expected, stream.str());
+}
+
+TEST_FIXTURE(CodeWriterTest, DeepIndentation)
+{
+    std::ostringstream stream;
+    {
+        CodeWriter writer(stream);
+        writer.Indent(40) << "x" << EndLine;
+        writer.Indent(-1) << "y" << EndLine;
+    }
+    EXPECT_EQ(std::string(160, ' ') + "x\ny\n", stream.str());
+}
+
+TEST_FIXTURE(CodeWriterTest, WritesInChunks)
+{
+    std::ostringstream stream;
+    CodeWriter writer(stream, 100);
+    // Indented lines are kept until the chunk is full
+    writer.Indent(1) << std::string(50, 'a') << EndLine;
+    EXPECT_EQ(std::string(), stream.str());
+    writer.Indent(1) << std::string(50, 'b') << EndLine;
+    EXPECT_EQ(size_t {110}, stream.str().size());
+    // A line at level 0 completes a top level declaration, and is written at once
+    writer.Indent(0) << "}" << EndLine;
+    EXPECT_EQ(size_t {112}, stream.str().size());
+    EXPECT_EQ(size_t {112}, writer.Size());
+    writer.Indent(1) << "c";
+    writer.Flush();
+    EXPECT_EQ(size_t {117}, stream.str().size());
+}
+
+TEST_FIXTURE(CodeWriterTest, GenerateCode)
+{
+    SyntheticTree tree;
+    tree.AddInterfaces(1, 1);
+
+    std::ostringstream stream;
+    CodeGenerator visitor(stream);
+    EXPECT_TRUE(tree.Tree().Visit(visitor));
+    // All output is written when the visit ends, without waiting for the visitor to be destroyed
+    std::string expected =
+        "namespace Interfaces0 {\n"
+        "    class I0 {\n"
+        "        I0() = default;\n"
+        "        virtual ~I0();\n"
+        "        virtual uint32_t Method0(const string & a, int b) = 0;\n"
+        "        virtual uint32_t Method1(const string & a, int b) = 0;\n"
+        "        virtual uint32_t Method2(const string & a, int b) = 0;\n"
+        "        virtual uint32_t Method3(const string & a, int b) = 0;\n"
+        "        virtual uint32_t Method4(const string & a, int b) = 0;\n"
+        "        int _member0;\n"
+        "        int _member1;\n"
+        "        int _member2;\n"
+        "    }; // class I0\n"
+        "} // namespace Interfaces0\n";
+    EXPECT_EQ(expected, stream.str());
+}
+
+} // namespace Test
+} // namespace CPPParser
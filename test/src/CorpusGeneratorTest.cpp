@@ -0,0 +1,66 @@
+#include <unittest-c++/UnitTestC++.h>
+#include <sstream>
+#include <corpus/CorpusGenerator.h>
+
+namespace CPPParser {
+namespace Test {
+
+class CorpusGeneratorTest : public ::UnitTestCpp::TestFixture {
+protected:
+    virtual void SetUp()
+    {
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    static std::string Generate(const CorpusOptions & options, unsigned index)
+    {
+        std::ostringstream stream;
+        CorpusGenerator generator(options);
+        generator.GenerateFile(index, stream);
+        return stream.str();
+    }
+};
+
+TEST_FIXTURE(CorpusGeneratorTest, SameSeedSameCorpus)
+{
+    CorpusOptions options;
+    EXPECT_EQ(Generate(options, 3), Generate(options, 3));
+    EXPECT_TRUE(Generate(options, 3) != Generate(options, 4));
+    CorpusOptions otherOptions;
+    otherOptions.seed = 2;
+    EXPECT_TRUE(Generate(options, 3) != Generate(otherOptions, 3));
+}
+
+TEST_FIXTURE(CorpusGeneratorTest, FileContents)
+{
+    CorpusOptions options;
+    options.interfacesPerFile = 3;
+    options.notificationPercentage = 100;
+    options.templatesPerFile = 1;
+    options.includesPerFile = 1;
+    std::string text = Generate(options, 2);
+    EXPECT_TRUE(text.find("#include \"Module.h\"") != std::string::npos);
+    EXPECT_TRUE(text.find("namespace WPEFramework {") != std::string::npos);
+    EXPECT_TRUE(text.find("template <typename TYPE>") != std::string::npos);
+    // Interfaces are numbered across the corpus, and get the IDs following those of the files before
+    EXPECT_TRUE(text.find("6 : virtual public Core::IUnknown {") != std::string::npos);
+    EXPECT_TRUE(text.find("ID = 0x0001000C") != std::string::npos);
+    EXPECT_TRUE(text.find("struct EXTERNAL INotification : virtual public Core::IUnknown {") != std::string::npos);
+    EXPECT_TRUE(text.find("ID = 0x0001000D") != std::string::npos);
+    EXPECT_TRUE(text.find("virtual uint32 Register(INotification * sink) = 0;") != std::string::npos);
+    // Headers only include the headers before them
+    EXPECT_TRUE(text.find("#include \"" + CorpusGenerator::FileName(2) + "\"") == std::string::npos);
+    EXPECT_TRUE(text.find("#include \"" + CorpusGenerator::FileName(3) + "\"") == std::string::npos);
+}
+
+TEST_FIXTURE(CorpusGeneratorTest, FileName)
+{
+    EXPECT_EQ("Corpus0000.h", CorpusGenerator::FileName(0));
+    EXPECT_EQ("Corpus0123.h", CorpusGenerator::FileName(123));
+}
+
+} // namespace Test
+} // namespace CPPParser
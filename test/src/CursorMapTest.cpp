@@ -0,0 +1,70 @@
+#include <unittest-c++/UnitTestC++.h>
+#include <include/CursorMap.h>
+#include <include/Utility.h>
+
+namespace CPPParser {
+namespace Test {
+
+class CursorMapTest : public ::UnitTestCpp::TestFixture {
+protected:
+    virtual void SetUp() {}
+
+    virtual void TearDown() {}
+};
+
+static CXCursor MakeCursor(CXCursorKind kind, size_t id)
+{
+    CXCursor cursor {};
+    cursor.kind = kind;
+    cursor.data[0] = reinterpret_cast<const void *>(16 * (id + 1));
+    return cursor;
+}
+
+TEST_FIXTURE(CursorMapTest, InsertAndFind)
+{
+    CursorMap<int> map;
+    EXPECT_TRUE(map.IsEmpty());
+    const size_t count = 1000;
+    for (size_t index = 0; index < count; ++index)
+    {
+        EXPECT_TRUE(map.Insert(MakeCursor(CXCursor_ClassDecl, index), static_cast<int>(index)));
+    }
+    EXPECT_EQ(count, map.Count());
+    for (size_t index = 0; index < count; ++index)
+    {
+        const int * value = map.Find(MakeCursor(CXCursor_ClassDecl, index));
+        ASSERT_TRUE(value != nullptr);
+        EXPECT_EQ(static_cast<int>(index), *value);
+    }
+    EXPECT_TRUE(map.Find(MakeCursor(CXCursor_ClassDecl, count)) == nullptr);
+    EXPECT_TRUE(map.Find(MakeCursor(CXCursor_StructDecl, 0)) == nullptr);
+}
+
+TEST_FIXTURE(CursorMapTest, InsertKeepsExistingValue)
+{
+    CursorMap<int> map;
+    EXPECT_TRUE(map.Insert(MakeCursor(CXCursor_Namespace, 1), 1));
+    EXPECT_FALSE(map.Insert(MakeCursor(CXCursor_Namespace, 1), 2));
+    EXPECT_EQ(size_t {1}, map.Count());
+    EXPECT_EQ(1, *map.Find(MakeCursor(CXCursor_Namespace, 1)));
+}
+
+TEST_FIXTURE(CursorMapTest, IteratesInInsertionOrder)
+{
+    CursorMap<int> map;
+    for (int index = 0; index < 100; ++index)
+    {
+        map.Insert(MakeCursor(CXCursor_FieldDecl, static_cast<size_t>(99 - index)), index);
+    }
+    int expected = 0;
+    for (auto const & entry : map)
+    {
+        EXPECT_EQ(expected++, entry.second);
+    }
+    map.Clear();
+    EXPECT_TRUE(map.IsEmpty());
+    EXPECT_TRUE(map.Find(MakeCursor(CXCursor_FieldDecl, 0)) == nullptr);
+}
+
+} // namespace Test
+} // namespace CPPParser
@@ -0,0 +1,134 @@
+#include <unittest-c++/UnitTestC++.h>
+#include <thread>
+#include <vector>
+#include <include/InternedString.h>
+#include <include/NodeArena.h>
+#include <include/Utility.h>
+
+namespace Utility {
+namespace Test {
+
+class InternedStringTest : public ::UnitTestCpp::TestFixture {
+protected:
+    virtual void SetUp() {}
+
+    virtual void TearDown() {}
+};
+
+TEST_FIXTURE(InternedStringTest, Empty)
+{
+    InternedString value;
+    EXPECT_TRUE(value.empty());
+    EXPECT_EQ(std::string(), value.str());
+    EXPECT_TRUE(value == InternedString(""));
+    EXPECT_TRUE(value == InternedString(std::string()));
+    EXPECT_TRUE(value == InternedString(static_cast<const char *>(nullptr)));
+}
+
+TEST_FIXTURE(InternedStringTest, EqualStringsShareStorage)
+{
+    std::string name = "WPEFramework";
+    InternedString first(name);
+    InternedString second("WPEFramework");
+    InternedString other("uint32");
+
+    EXPECT_TRUE(first == second);
+    EXPECT_TRUE(first != other);
+    EXPECT_EQ(&first.str(), &second.str());
+    EXPECT_EQ(name, first.str());
+    EXPECT_TRUE(first == name);
+    EXPECT_TRUE(first == "WPEFramework");
+    EXPECT_TRUE(other != name);
+}
+
+TEST_FIXTURE(InternedStringTest, FindDoesNotIntern)
+{
+    InternedString pooled("InternedStringTestFind");
+    InternedString found;
+    EXPECT_TRUE(InternedString::Find("InternedStringTestFind", found));
+    EXPECT_TRUE(found == pooled);
+    size_t count = InternedString::PoolCount();
+    EXPECT_FALSE(InternedString::Find("InternedStringTestNotPooled", found));
+    EXPECT_EQ(count, InternedString::PoolCount());
+    EXPECT_TRUE(InternedString::Find("", found));
+    EXPECT_TRUE(found.empty());
+}
+
+TEST_FIXTURE(InternedStringTest, PoolGrowsOncePerString)
+{
+    InternedString("InternedStringTest::PoolGrowsOncePerString");
+    size_t count = InternedString::PoolCount();
+    size_t size = InternedString::PoolSize();
+    InternedString("InternedStringTest::PoolGrowsOncePerString");
+    EXPECT_EQ(count, InternedString::PoolCount());
+    EXPECT_EQ(size, InternedString::PoolSize());
+}
+
+TEST_FIXTURE(InternedStringTest, ConcurrentInterning)
+{
+    const size_t threadCount = 4;
+    std::vector<std::vector<const std::string *>> results(threadCount);
+    std::vector<std::thread> threads;
+    for (size_t index = 0; index < threadCount; ++index)
+    {
+        threads.emplace_back([&results, index]()
+        {
+            for (int i = 0; i < 1000; ++i)
+            {
+                results[index].push_back(&InternedString("name" + std::to_string(i)).str());
+            }
+        });
+    }
+    for (auto & thread : threads)
+    {
+        thread.join();
+    }
+    for (size_t index = 1; index < threadCount; ++index)
+    {
+        EXPECT_TRUE(results[0] == results[index]);
+    }
+}
+
+TEST_FIXTURE(InternedStringTest, ScopeSelectsPool)
+{
+    auto pool = std::make_shared<StringPool>();
+    InternedString outside("InternedStringTest::ScopeSelectsPool");
+    {
+        StringPool::Scope scope(pool);
+        EXPECT_TRUE(StringPool::Current() == pool);
+        InternedString inside("InternedStringTest::ScopeSelectsPool");
+        EXPECT_EQ(size_t{1}, pool->Count());
+        EXPECT_EQ(pool->Find("InternedStringTest::ScopeSelectsPool"), &inside.str());
+        // Handles from different pools do not share storage, but still compare equal
+        EXPECT_TRUE(&outside.str() != &inside.str());
+        EXPECT_TRUE(outside == inside);
+        EXPECT_TRUE(outside != InternedString("InternedStringTest::Other"));
+    }
+    EXPECT_TRUE(StringPool::Current() == nullptr);
+    EXPECT_TRUE(StringPool::Default().Find("InternedStringTest::ScopeSelectsPool") != nullptr);
+}
+
+TEST_FIXTURE(InternedStringTest, PoolIsReleasedWithArena)
+{
+    auto pool = std::make_shared<StringPool>();
+    std::weak_ptr<StringPool> weakPool = pool;
+    std::shared_ptr<CPPParser::NodeArena> arena;
+    {
+        StringPool::Scope scope(pool);
+        arena = std::make_shared<CPPParser::NodeArena>();
+    }
+    pool.reset();
+    EXPECT_FALSE(weakPool.expired());
+    arena.reset();
+    EXPECT_TRUE(weakPool.expired());
+}
+
+TEST_FIXTURE(InternedStringTest, ClangString)
+{
+    ClangString kind(clang_getCursorKindSpelling(CXCursor_ClassDecl));
+    EXPECT_EQ(std::string("ClassDecl"), kind.str());
+    EXPECT_EQ(std::string("Namespace"), ConvertString(clang_getCursorKindSpelling(CXCursor_Namespace)));
+}
+
+} // namespace Test
+} // namespace Utility
@@ -0,0 +1,84 @@
+#include <unittest-c++/UnitTestC++.h>
+#include <include/AST.h>
+#include <include/Function.h>
+#include <include/MemoryUsage.h>
+#include <include/Typedef.h>
+
+namespace CPPParser {
+namespace Test {
+
+class MemoryUsageTest : public ::UnitTestCpp::TestFixture {
+protected:
+    virtual void SetUp()
+    {
+    }
+
+    virtual void TearDown()
+    {
+    }
+};
+
+TEST_FIXTURE(MemoryUsageTest, EmptyTree)
+{
+    AST ast;
+    MemoryUsage memory;
+    memory.AddTree(ast);
+    EXPECT_EQ(uint64_t {1}, memory.Nodes(ElementKind::AST).count);
+    EXPECT_TRUE(memory.Nodes(ElementKind::AST).bytes >= sizeof(AST));
+    EXPECT_EQ(uint64_t {0}, memory.Nodes(ElementKind::Class).count);
+    EXPECT_EQ(uint64_t {0}, memory.parameters.count);
+}
+
+TEST_FIXTURE(MemoryUsageTest, CountsNodesByKind)
+{
+    AST ast;
+    SourceLocation location;
+    location.fileName = "A.h";
+    auto aNamespace = std::make_shared<Namespace>(Element::WeakPtr(), location, "NS");
+    auto aClass = std::make_shared<Class>(aNamespace, location, "A", AccessSpecifier::Public);
+    ParameterList parameters {Parameter("x", "int"), Parameter("y", "int")};
+    aClass->Add(std::make_shared<Method>(aClass, location, "DoIt", AccessSpecifier::Public, "int",
+                                         parameters, FunctionFlags::None));
+    aClass->Add(std::make_shared<Method>(aClass, location, "DoThat", AccessSpecifier::Public, "int",
+                                         parameters, FunctionFlags::None));
+    aNamespace->Add(aClass);
+    aNamespace->Add(std::make_shared<Typedef>(aNamespace, location, "T", AccessSpecifier::Invalid, "int"));
+    ast.Add(aNamespace);
+
+    MemoryUsage memory;
+    memory.AddTree(ast);
+    EXPECT_EQ(uint64_t {1}, memory.Nodes(ElementKind::Namespace).count);
+    EXPECT_EQ(uint64_t {1}, memory.Nodes(ElementKind::Class).count);
+    EXPECT_EQ(uint64_t {2}, memory.Nodes(ElementKind::Method).count);
+    EXPECT_EQ(uint64_t {1}, memory.Nodes(ElementKind::Typedef).count);
+    EXPECT_TRUE(memory.Nodes(ElementKind::Method).bytes >= 2 * sizeof(Method));
+    EXPECT_EQ(uint64_t {4}, memory.parameters.count);
+    EXPECT_TRUE(memory.parameters.bytes >= 4 * sizeof(Parameter));
+
+    // Names and types are pooled, so "int" is counted once, and the parameter names are counted with the parameters
+    MemoryUsage names;
+    names.AddTree(*aClass);
+    // "A", "DoIt", "int" and "DoThat"
+    EXPECT_EQ(uint64_t {4}, names.strings.count);
+    EXPECT_EQ(uint64_t {1}, names.fileNames.count);
+}
+
+TEST_FIXTURE(MemoryUsageTest, Accumulate)
+{
+    AST ast;
+    ast.Add(std::make_shared<Namespace>(Element::WeakPtr(), SourceLocation(), "NS"));
+    MemoryUsage memory;
+    memory.AddTree(ast);
+    TokenLookupMap map;
+    memory.AddLookupMap(map);
+    MemoryUsage total;
+    total += memory;
+    total += memory;
+    EXPECT_EQ(uint64_t {2}, total.Nodes(ElementKind::Namespace).count);
+    EXPECT_EQ(2 * memory.Nodes(ElementKind::Namespace).bytes, total.Nodes(ElementKind::Namespace).bytes);
+    EXPECT_EQ(2 * memory.Total().bytes, total.Total().bytes);
+    EXPECT_TRUE(memory.lookupMaps.bytes > 0);
+}
+
+} // namespace Test
+} // namespace CPPParser
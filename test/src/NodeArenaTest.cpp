@@ -0,0 +1,109 @@
+#include <unittest-c++/UnitTestC++.h>
+#include <cstdint>
+#include <include/AST.h>
+#include <include/Function.h>
+#include <include/NodeArena.h>
+
+namespace CPPParser {
+namespace Test {
+
+class NodeArenaTest : public ::UnitTestCpp::TestFixture {
+};
+
+TEST_FIXTURE(NodeArenaTest, AllocateAligned)
+{
+    NodeArena arena;
+    EXPECT_EQ(size_t {0}, arena.BlockCount());
+    void * first = arena.Allocate(1, 1);
+    void * second = arena.Allocate(8, 8);
+    void * third = arena.Allocate(16, 16);
+    EXPECT_EQ(size_t {1}, arena.BlockCount());
+    EXPECT_EQ(size_t {25}, arena.BytesAllocated());
+    EXPECT_TRUE(first != second);
+    EXPECT_EQ(size_t {0}, reinterpret_cast<uintptr_t>(second) % 8);
+    EXPECT_EQ(size_t {0}, reinterpret_cast<uintptr_t>(third) % 16);
+}
+
+TEST_FIXTURE(NodeArenaTest, AllocateAcrossBlocks)
+{
+    NodeArena arena;
+    const size_t size = 1000;
+    const size_t count = 3 * (NodeArena::BlockSize / size);
+    for (size_t index = 0; index < count; ++index)
+    {
+        arena.Allocate(size, 8);
+    }
+    EXPECT_EQ(size_t {3}, arena.BlockCount());
+    // A large allocation gets a block of its own, and does not end the current block. The current block is nearly
+    // full, as it holds as many allocations of the size as fit, so only a smaller allocation still fits in it.
+    arena.Allocate(NodeArena::BlockSize, 8);
+    EXPECT_EQ(size_t {4}, arena.BlockCount());
+    const size_t remaining = NodeArena::BlockSize % size;
+    arena.Allocate(remaining, 8);
+    EXPECT_EQ(size_t {4}, arena.BlockCount());
+    arena.Allocate(size, 8);
+    EXPECT_EQ(size_t {5}, arena.BlockCount());
+}
+
+TEST_FIXTURE(NodeArenaTest, NodesLiveAsLongAsACopyOfTheTree)
+{
+    AST copy;
+    copy.Add(MakeNode<Namespace>(copy.Arena(), Element::WeakPtr(), SourceLocation(), "N"));
+    {
+        AST ast;
+        auto aClass = MakeNode<Class>(ast.Arena(), Element::WeakPtr(), SourceLocation(), "A", AccessSpecifier::Public);
+        aClass->Add(MakeNode<Method>(ast.Arena(), aClass, SourceLocation(), "DoIt", AccessSpecifier::Public, "int",
+                                     ParameterList(), FunctionFlags::None));
+        ast.Add(aClass);
+        EXPECT_TRUE(ast.Arena()->BytesAllocated() > 0);
+        // The namespace is released before the arena it was allocated from
+        copy = ast;
+    }
+    // The copy keeps the arena alive
+    ASSERT_EQ(size_t {1}, copy.Classes().size());
+    auto aClass = copy.Classes()[0];
+    ASSERT_EQ(size_t {1}, aClass->Contents().size());
+    EXPECT_EQ(aClass.get(), aClass->Contents()[0]->Parent());
+    EXPECT_EQ("int A::DoIt()", aClass->Contents()[0]->QualifiedName());
+}
+
+TEST_FIXTURE(NodeArenaTest, LinkedArenaOutlivesItsTree)
+{
+    AST derivedTree;
+    {
+        AST baseTree;
+        auto base = MakeNode<Class>(baseTree.Arena(), Element::WeakPtr(), SourceLocation(), "Base", AccessSpecifier::Public);
+        baseTree.Add(base);
+        auto derived = MakeNode<Class>(derivedTree.Arena(), Element::WeakPtr(), SourceLocation(), "Derived",
+                                       AccessSpecifier::Public);
+        derived->AddBase(MakeNode<Inheritance>(derivedTree.Arena(), derived, SourceLocation(), "Base",
+                                               AccessSpecifier::Public, base, false));
+        derivedTree.Add(derived);
+        derivedTree.LinkArena(baseTree.Arena());
+    }
+    // The base class is released with its tree, the link to it stays valid
+    ASSERT_EQ(size_t {1}, derivedTree.Classes().size());
+    ASSERT_EQ(size_t {1}, derivedTree.Classes()[0]->BaseTypes().size());
+    EXPECT_TRUE(derivedTree.Classes()[0]->BaseTypes()[0]->BaseType() == nullptr);
+}
+
+TEST_FIXTURE(NodeArenaTest, ParentLinkIsClearedWithParent)
+{
+    AST ast;
+    auto aClass = MakeNode<Class>(ast.Arena(), Element::WeakPtr(), SourceLocation(), "A", AccessSpecifier::Public);
+    auto method = MakeNode<Method>(ast.Arena(), aClass, SourceLocation(), "DoIt", AccessSpecifier::Public, "int",
+                                   ParameterList(), FunctionFlags::None);
+    aClass->Add(method);
+    auto base = MakeNode<Inheritance>(ast.Arena(), aClass, SourceLocation(), "Base", AccessSpecifier::Public,
+                                      Element::Ptr(), false);
+    aClass->AddBase(base);
+    EXPECT_EQ(aClass.get(), method->Parent());
+    EXPECT_EQ(aClass.get(), base->Parent());
+
+    aClass.reset();
+    EXPECT_TRUE(method->Parent() == nullptr);
+    EXPECT_TRUE(base->Parent() == nullptr);
+}
+
+} // namespace Test
+} // namespace CPPParser
@@ -0,0 +1,204 @@
+#include <unittest-c++/UnitTestC++.h>
+#include <cstdlib>
+#include <fstream>
+#include <include/ParseCache.h>
+#include <include/TestData.h>
+
+namespace CPPParser {
+namespace Test {
+
+class ParseCacheTest : public ::UnitTestCpp::TestFixture {
+protected:
+    virtual void SetUp()
+    {
+        char directoryTemplate[] = "/tmp/PSGeneratorCacheTest.XXXXXX";
+        _directory = mkdtemp(directoryTemplate);
+    }
+
+    virtual void TearDown()
+    {
+        std::system(("rm -rf " + _directory).c_str());
+    }
+
+    std::string _directory;
+};
+
+static OptionsList compileOptions =
+    {
+        "-x",
+        "c++",
+        "-std=c++11",
+    };
+
+static std::string ShowAST(const AST & ast)
+{
+    std::ostringstream stream;
+    ast.Show(stream, 0);
+    return stream.str();
+}
+
+static void WriteFile(const std::string & path, const std::string & contents)
+{
+    std::ofstream file(path);
+    file << contents;
+}
+
+TEST_FIXTURE(ParseCacheTest, SerializeRoundTrip)
+{
+    Parser parser(TestData::IPluginHeader());
+    ASSERT_TRUE(parser.Parse(compileOptions));
+
+    std::stringstream stream;
+    ASSERT_TRUE(ParseCache::Serialize(parser.GetAST(), stream));
+    AST ast;
+    ASSERT_TRUE(ParseCache::Deserialize(stream, ast));
+
+    EXPECT_EQ(ShowAST(parser.GetAST()), ShowAST(ast));
+    std::ostringstream expected;
+    ParseCache::Serialize(parser.GetAST(), expected);
+    std::ostringstream actual;
+    ParseCache::Serialize(ast, actual);
+    EXPECT_EQ(expected.str(), actual.str());
+}
+
+TEST_FIXTURE(ParseCacheTest, SerializeKeepsIncludes)
+{
+    Parser parser(TestData::IMemoryHeader(), ParseFlags::PreprocessorDirectives);
+    ASSERT_TRUE(parser.Parse(compileOptions));
+
+    std::stringstream stream;
+    ASSERT_TRUE(ParseCache::Serialize(parser.GetAST(), stream));
+    AST ast;
+    ASSERT_TRUE(ParseCache::Deserialize(stream, ast));
+
+    std::ostringstream expected;
+    parser.GetAST().GenerateCode(expected, 0);
+    std::ostringstream actual;
+    ast.GenerateCode(actual, 0);
+    EXPECT_EQ(expected.str(), actual.str());
+    EXPECT_NE(std::string::npos, actual.str().find("#include \"Module.h\"\n"));
+}
+
+TEST_FIXTURE(ParseCacheTest, SerializeKeepsBaseTypes)
+{
+    Parser parser(TestData::InheritanceHeader());
+    ASSERT_TRUE(parser.Parse(compileOptions));
+
+    std::stringstream stream;
+    ASSERT_TRUE(ParseCache::Serialize(parser.GetAST(), stream));
+    AST ast;
+    ASSERT_TRUE(ParseCache::Deserialize(stream, ast));
+
+    std::ostringstream expected;
+    parser.GetAST().GenerateCode(expected, 0);
+    std::ostringstream actual;
+    ast.GenerateCode(actual, 0);
+    EXPECT_EQ(expected.str(), actual.str());
+}
+
+TEST_FIXTURE(ParseCacheTest, SerializeKeepsBaseUSR)
+{
+    std::string header = TestData::CombinePath(_directory, "Header.h");
+    WriteFile(header, "class Base {};\nnamespace NS { class A : public Base {}; }\n");
+    Parser parser(header);
+    ASSERT_TRUE(parser.Parse(compileOptions));
+
+    std::stringstream stream;
+    ASSERT_TRUE(ParseCache::Serialize(parser.GetAST(), stream));
+    AST ast;
+    ASSERT_TRUE(ParseCache::Deserialize(stream, ast));
+
+    ASSERT_EQ(size_t{1}, ast.Namespaces().size());
+    ASSERT_EQ(size_t{1}, ast.Namespaces()[0]->Classes().size());
+    auto const & bases = ast.Namespaces()[0]->Classes()[0]->BaseTypes();
+    ASSERT_EQ(size_t{1}, bases.size());
+    EXPECT_EQ("c:@S@Base", bases[0]->BaseUSR());
+}
+
+TEST_FIXTURE(ParseCacheTest, SerializeKeepsSymbols)
+{
+    Parser parser(TestData::InheritanceHeader());
+    ASSERT_TRUE(parser.Parse(compileOptions));
+
+    std::stringstream stream;
+    ASSERT_TRUE(ParseCache::Serialize(parser.GetAST(), stream, &parser.Symbols()));
+    AST ast;
+    SymbolIndex symbols;
+    ASSERT_TRUE(ParseCache::Deserialize(stream, ast, &symbols));
+
+    ASSERT_NE(size_t{0}, symbols.Count());
+    EXPECT_EQ(parser.Symbols().Count(), symbols.Count());
+    for (auto const & symbol : parser.Symbols().Entries())
+    {
+        Declaration::Ptr declaration = symbols.Find(symbol.first);
+        ASSERT_NE(nullptr, declaration);
+        EXPECT_EQ(symbol.second->QualifiedName(), declaration->QualifiedName());
+    }
+}
+
+TEST_FIXTURE(ParseCacheTest, DeserializeInvalid)
+{
+    std::istringstream stream(" 1\nunknown -1 1:A 0 0: 0 0 0\n");
+    AST ast;
+    EXPECT_FALSE(ParseCache::Deserialize(stream, ast));
+}
+
+TEST_FIXTURE(ParseCacheTest, SecondParseIsTakenFromCache)
+{
+    ParseCache cache(_directory);
+    Parser parser(TestData::ClassHeader(), ParseFlags::NoParseFlags, &cache);
+    ASSERT_TRUE(parser.Parse(compileOptions));
+    EXPECT_FALSE(parser.FromCache());
+
+    Parser cachedParser(TestData::ClassHeader(), ParseFlags::NoParseFlags, &cache);
+    ASSERT_TRUE(cachedParser.Parse(compileOptions));
+    EXPECT_TRUE(cachedParser.FromCache());
+    EXPECT_EQ(ShowAST(parser.GetAST()), ShowAST(cachedParser.GetAST()));
+}
+
+TEST_FIXTURE(ParseCacheTest, OtherOptionsAreNotTakenFromCache)
+{
+    ParseCache cache(_directory);
+    Parser parser(TestData::ClassHeader(), ParseFlags::NoParseFlags, &cache);
+    ASSERT_TRUE(parser.Parse(compileOptions));
+
+    OptionsList otherOptions = compileOptions;
+    otherOptions.push_back("-DOTHER");
+    Parser otherParser(TestData::ClassHeader(), ParseFlags::NoParseFlags, &cache);
+    ASSERT_TRUE(otherParser.Parse(otherOptions));
+    EXPECT_FALSE(otherParser.FromCache());
+}
+
+TEST_FIXTURE(ParseCacheTest, ChangedIncludeInvalidatesEntry)
+{
+    std::string header = TestData::CombinePath(_directory, "Header.h");
+    std::string include = TestData::CombinePath(_directory, "Include.h");
+    WriteFile(header, "#include \"Include.h\"\nnamespace NS { class A : public Base {}; }\n");
+    WriteFile(include, "class Base {};\n");
+
+    // Use a fresh cache object for every parse, as a new run would, so file hashes are computed again.
+    std::string cacheDirectory = TestData::CombinePath(_directory, "cache");
+    {
+        ParseCache cache(cacheDirectory);
+        Parser parser(header, ParseFlags::NoParseFlags, &cache);
+        ASSERT_TRUE(parser.Parse(compileOptions));
+        EXPECT_FALSE(parser.FromCache());
+    }
+    {
+        ParseCache cache(cacheDirectory);
+        Parser parser(header, ParseFlags::NoParseFlags, &cache);
+        ASSERT_TRUE(parser.Parse(compileOptions));
+        EXPECT_TRUE(parser.FromCache());
+    }
+    WriteFile(include, "class Base { int x; };\n");
+    {
+        ParseCache cache(cacheDirectory);
+        Parser parser(header, ParseFlags::NoParseFlags, &cache);
+        ASSERT_TRUE(parser.Parse(compileOptions));
+        EXPECT_FALSE(parser.FromCache());
+        EXPECT_EQ(size_t{1}, parser.GetAST().Classes().size());
+    }
+}
+
+} // namespace Test
+} // namespace CPPParser
@@ -0,0 +1,198 @@
+#include <unittest-c++/UnitTestC++.h>
+#include <cstdlib>
+#include <fstream>
+#include <include/Class.h>
+#include <include/Namespace.h>
+#include <include/ParseCache.h>
+#include <include/ParserPool.h>
+#include <include/TestData.h>
+
+namespace CPPParser {
+namespace Test {
+
+class ParserPoolTest : public ::UnitTestCpp::TestFixture {
+protected:
+    virtual void SetUp()
+    {
+        char directoryTemplate[] = "/tmp/PSGeneratorPoolTest.XXXXXX";
+        _directory = mkdtemp(directoryTemplate);
+    }
+
+    virtual void TearDown()
+    {
+        std::system(("rm -rf " + _directory).c_str());
+    }
+
+    std::string _directory;
+};
+
+static OptionsList compileOptions =
+    {
+        "-x",
+        "c++",
+        "-std=c++11",
+    };
+
+static std::vector<std::string> inputFiles =
+    {
+        TestData::SingleNamespaceHeader(),
+        TestData::NestedNamespaceHeader(),
+        TestData::ClassHeader(),
+        TestData::StructHeader(),
+        TestData::EnumHeader(),
+        TestData::InheritanceHeader(),
+        TestData::TemplateClassHeader(),
+        TestData::IPluginHeader(),
+    };
+
+static std::string ParseAndShow(size_t jobs, std::string & log)
+{
+    std::ostringstream logStream;
+    std::ostringstream errorStream;
+    Utility::SetLogStream(logStream);
+    Utility::SetErrorStream(errorStream);
+    ParserPool parserPool(jobs);
+    bool ok = parserPool.Parse(inputFiles, compileOptions);
+    Utility::ResetLogStreams();
+    log = logStream.str() + errorStream.str();
+    if (!ok)
+        return {};
+
+    std::ostringstream stream;
+    for (auto const & ast : parserPool.GetASTs())
+    {
+        ast.Show(stream, 0);
+    }
+    return stream.str();
+}
+
+static void WriteFile(const std::string & path, const std::string & contents)
+{
+    std::ofstream file(path);
+    file << contents;
+}
+
+// Shows the trees, each followed by the declarations the bases of its classes in a namespace resolved to
+static std::string ShowWithBases(const ParserPool & parserPool)
+{
+    std::ostringstream stream;
+    for (auto const & ast : parserPool.GetASTs())
+    {
+        ast.Show(stream, 0);
+        for (auto const & aNamespace : ast.Namespaces())
+        {
+            for (auto const & aClass : aNamespace->Classes())
+            {
+                for (auto const & base : aClass->BaseTypes())
+                {
+                    Element::Ptr baseType = base->BaseType();
+                    stream << aClass->QualifiedName() << " : "
+                           << ((baseType != nullptr) ? baseType->QualifiedName() : "<unresolved>") << std::endl;
+                }
+            }
+        }
+    }
+    return stream.str();
+}
+
+TEST_FIXTURE(ParserPoolTest, JobsZeroSelectsHardwareThreads)
+{
+    ParserPool parserPool(0);
+    EXPECT_LE(size_t{1}, parserPool.Jobs());
+}
+
+TEST_FIXTURE(ParserPoolTest, ParallelOutputMatchesSerial)
+{
+    std::string expectedLog;
+    std::string expected = ParseAndShow(1, expectedLog);
+    ASSERT_NE("", expected);
+
+    std::string actualLog;
+    std::string actual = ParseAndShow(4, actualLog);
+    EXPECT_EQ(expected, actual);
+    EXPECT_EQ(expectedLog, actualLog);
+}
+
+TEST_FIXTURE(ParserPoolTest, ReuseTranslationUnitsReparses)
+{
+    std::string expectedLog;
+    std::string expected = ParseAndShow(1, expectedLog);
+    ASSERT_NE("", expected);
+
+    ParserPool parserPool(1, ParseFlags::ReuseTranslationUnits);
+    ASSERT_TRUE(parserPool.Parse(inputFiles, compileOptions));
+    EXPECT_EQ(size_t{0}, parserPool.ReparseCount());
+    ASSERT_TRUE(parserPool.Parse(inputFiles, compileOptions));
+    EXPECT_EQ(inputFiles.size(), parserPool.ReparseCount());
+
+    std::ostringstream stream;
+    for (auto const & ast : parserPool.GetASTs())
+    {
+        ast.Show(stream, 0);
+    }
+    EXPECT_EQ(expected, stream.str());
+}
+
+TEST_FIXTURE(ParserPoolTest, ParallelReuseTranslationUnitsReparses)
+{
+    std::string expectedLog;
+    std::string expected = ParseAndShow(1, expectedLog);
+    ASSERT_NE("", expected);
+
+    ParserPool parserPool(4, ParseFlags::ReuseTranslationUnits);
+    ASSERT_TRUE(parserPool.Parse(inputFiles, compileOptions));
+    EXPECT_EQ(size_t{0}, parserPool.ReparseCount());
+    ASSERT_TRUE(parserPool.Parse(inputFiles, compileOptions));
+    EXPECT_EQ(inputFiles.size(), parserPool.ReparseCount());
+
+    std::ostringstream stream;
+    for (auto const & ast : parserPool.GetASTs())
+    {
+        ast.Show(stream, 0);
+    }
+    EXPECT_EQ(expected, stream.str());
+}
+
+TEST_FIXTURE(ParserPoolTest, BaseTypesResolveAcrossInputs)
+{
+    // The base is declared in an include, which is skipped when parsing the derived class, and is another input
+    std::string derived = TestData::CombinePath(_directory, "Derived.h");
+    std::string base = TestData::CombinePath(_directory, "Base.h");
+    WriteFile(derived, "#include \"Base.h\"\nnamespace NS { class Derived : public Base {}; }\n");
+    WriteFile(base, "namespace NS { class Base {}; }\n");
+    std::vector<std::string> files = { derived, base };
+
+    ParserPool serialPool(1, ParseFlags::MainFileOnly);
+    ASSERT_TRUE(serialPool.Parse(files, compileOptions));
+    std::string expected = ShowWithBases(serialPool);
+    EXPECT_NE(std::string::npos, expected.find("NS::Derived : NS::Base\n"));
+
+    ParserPool parallelPool(4, ParseFlags::MainFileOnly);
+    ASSERT_TRUE(parallelPool.Parse(files, compileOptions));
+    EXPECT_EQ(expected, ShowWithBases(parallelPool));
+
+    ParseCache cache(TestData::CombinePath(_directory, "cache"));
+    ParserPool storingPool(4, ParseFlags::MainFileOnly, &cache);
+    ASSERT_TRUE(storingPool.Parse(files, compileOptions));
+    EXPECT_EQ(expected, ShowWithBases(storingPool));
+
+    // A new cache object, as a new run would use
+    ParseCache loadingCache(TestData::CombinePath(_directory, "cache"));
+    ParserPool cachedPool(4, ParseFlags::MainFileOnly, &loadingCache);
+    ASSERT_TRUE(cachedPool.Parse(files, compileOptions));
+    EXPECT_EQ(expected, ShowWithBases(cachedPool));
+}
+
+TEST_FIXTURE(ParserPoolTest, ParallelStopsAtFirstFailure)
+{
+    ParserPool parserPool(4);
+    std::ostringstream errorStream;
+    Utility::SetErrorStream(errorStream);
+    EXPECT_FALSE(parserPool.Parse({ TestData::ClassHeader(), TestData::CombinePath(TestData::TestRoot(), "DoesNotExist.h") },
+                                  compileOptions));
+    Utility::ResetLogStreams();
+    EXPECT_EQ(size_t{1}, parserPool.GetASTs().size());
+}
+
+} // namespace Test
+} // namespace CPPParser
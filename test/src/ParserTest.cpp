@@ -2,6 +2,7 @@
 #include <include/Parser.h>
 #include <include/TestData.h>
 #include <include/CodeGenerator.h>
+#include <include/PreprocessorDirectives.h>
 
 namespace CPPParser {
 namespace Test {
@@ -145,7 +146,7 @@ TEST_FIXTURE(ParserTest, NestedNamespace)
     const Namespace::Ptr ns2 = ns1->Namespaces()[0];
     ASSERT_NE(nullptr, ns2);
     EXPECT_EQ("NS2", ns2->Name());
-    EXPECT_EQ(ns1, ns2->Parent());
+    EXPECT_EQ(ns1.get(), ns2->Parent());
 
     EXPECT_EQ(size_t{0}, ns2->Namespaces().size());
     EXPECT_EQ(size_t{0}, ns2->Classes().size());
@@ -219,7 +220,7 @@ TEST_FIXTURE(ParserTest, AnonymousNamespace)
     const Namespace::Ptr ns2 = ns1->Namespaces()[0];
     ASSERT_NE(nullptr, ns2);
     EXPECT_EQ("", ns2->Name());
-    EXPECT_EQ(ns1, ns2->Parent());
+    EXPECT_EQ(ns1.get(), ns2->Parent());
 
     EXPECT_EQ(size_t{0}, ns2->Namespaces().size());
     EXPECT_EQ(size_t{0}, ns2->Classes().size());
@@ -354,7 +355,7 @@ TEST_FIXTURE(ParserTest, Class)
     Class::Ptr classDef = ns1->Classes()[0];
     ASSERT_NE(nullptr, classDef);
     EXPECT_EQ("interface", classDef->Name());
-    EXPECT_EQ(ns1, classDef->Parent());
+    EXPECT_EQ(ns1.get(), classDef->Parent());
 
     EXPECT_EQ(size_t{0}, classDef->Namespaces().size());
     EXPECT_EQ(size_t{0}, classDef->Classes().size());
@@ -373,7 +374,7 @@ TEST_FIXTURE(ParserTest, Class)
     const Namespace::Ptr ns2 = ns1->Namespaces()[0];
     ASSERT_NE(nullptr, ns2);
     EXPECT_EQ("NS2", ns2->Name());
-    EXPECT_EQ(ns1, ns2->Parent());
+    EXPECT_EQ(ns1.get(), ns2->Parent());
 
     EXPECT_EQ(size_t{0}, ns2->Namespaces().size());
     EXPECT_EQ(size_t{1}, ns2->Classes().size());
@@ -389,7 +390,7 @@ TEST_FIXTURE(ParserTest, Class)
 
     classDef = ns2->Classes()[0];
     EXPECT_EQ("c", classDef->Name());
-    EXPECT_EQ(ns2, classDef->Parent());
+    EXPECT_EQ(ns2.get(), classDef->Parent());
 
     EXPECT_EQ(size_t{0}, classDef->Namespaces().size());
     EXPECT_EQ(size_t{0}, classDef->Classes().size());
@@ -449,6 +450,255 @@ TEST_FIXTURE(ParserTest, Class)
     EXPECT_EQ(expected, actual);
 }
 
+TEST_FIXTURE(ParserTest, InlineBodies)
+{
+    Parser parser(TestData::InlineBodiesHeader());
+
+    ASSERT_TRUE(parser.Parse(compileOptions));
+
+    const ASTCollection & astCollection = parser.GetASTCollection();
+    EXPECT_EQ(size_t{1}, astCollection.Namespaces().size());
+    EXPECT_EQ(size_t{0}, astCollection.Structs().size());
+
+    const Namespace::Ptr ns1 = astCollection.Namespaces()[0];
+    ASSERT_NE(nullptr, ns1);
+    EXPECT_EQ(size_t{1}, ns1->Classes().size());
+    EXPECT_EQ(size_t{0}, ns1->Structs().size());
+
+    const Class::Ptr c = ns1->Classes()[0];
+    ASSERT_NE(nullptr, c);
+    EXPECT_EQ(size_t{0}, c->Structs().size());
+
+    std::string expected =
+        "namespace NS1 {\n"
+        "    class c {\n"
+        "        c();\n"
+        "        int X() const;\n"
+        "        int _x;\n"
+        "    }; // class c\n"
+        "} // namespace NS1\n";
+    std::ostringstream stream;
+    astCollection.GenerateCode(stream, 0);
+    std::string actual = stream.str();
+    EXPECT_EQ(expected, actual);
+
+    stream.str("");
+    parser.TraverseTree(stream);
+    actual = stream.str();
+    EXPECT_EQ(expected, actual);
+}
+
+TEST_FIXTURE(ParserTest, InlineBodiesSkipFunctionBodies)
+{
+    Parser parser(TestData::InlineBodiesHeader(), ParseFlags::SkipFunctionBodies);
+
+    ASSERT_TRUE(parser.Parse(compileOptions));
+
+    std::string expected =
+        "namespace NS1 {\n"
+        "    class c {\n"
+        "        c();\n"
+        "        int X() const;\n"
+        "        int _x;\n"
+        "    }; // class c\n"
+        "} // namespace NS1\n";
+    std::ostringstream stream;
+    parser.GetASTCollection().GenerateCode(stream, 0);
+    std::string actual = stream.str();
+    EXPECT_EQ(expected, actual);
+
+    stream.str("");
+    parser.TraverseTree(stream);
+    actual = stream.str();
+    EXPECT_EQ(expected, actual);
+}
+
+TEST_FIXTURE(ParserTest, TranslationUnitOptions)
+{
+    EXPECT_EQ(unsigned {CXTranslationUnit_None}, Parser::TranslationUnitOptions(ParseFlags::NoParseFlags));
+    EXPECT_EQ(unsigned {CXTranslationUnit_DetailedPreprocessingRecord},
+              Parser::TranslationUnitOptions(ParseFlags::PreprocessorDirectives));
+    EXPECT_EQ(unsigned {CXTranslationUnit_DetailedPreprocessingRecord | CXTranslationUnit_SkipFunctionBodies},
+              Parser::TranslationUnitOptions(static_cast<ParseFlags>(ParseFlags::PreprocessorDirectives |
+                                                                     ParseFlags::SkipFunctionBodies)));
+}
+
+TEST_FIXTURE(ParserTest, PreprocessorDirectivesOnlyWithFlag)
+{
+    Parser parser(TestData::IMemoryHeader());
+    ASSERT_TRUE(parser.Parse(compileOptions));
+    for (auto const & element : parser.GetAST().Contents())
+    {
+        EXPECT_TRUE(element->Kind() != ElementKind::IncludeDirective);
+    }
+    std::ostringstream code;
+    parser.GetASTCollection().GenerateCode(code, 0);
+    EXPECT_EQ(std::string::npos, code.str().find("#include"));
+
+    Parser parserDirectives(TestData::IMemoryHeader(), ParseFlags::PreprocessorDirectives);
+    ASSERT_TRUE(parserDirectives.Parse(compileOptions));
+    std::vector<const IncludeDirective *> includes;
+    for (auto const & element : parserDirectives.GetAST().Contents())
+    {
+        if (element->Kind() == ElementKind::IncludeDirective)
+            includes.push_back(static_cast<const IncludeDirective *>(element.get()));
+    }
+    ASSERT_EQ(size_t{1}, includes.size());
+    EXPECT_EQ("Module.h", includes[0]->Name());
+    EXPECT_EQ(IncludeSpecifier::Local, includes[0]->IncludeType());
+    std::ostringstream codeDirectives;
+    parserDirectives.GetASTCollection().GenerateCode(codeDirectives, 0);
+    EXPECT_NE(std::string::npos, codeDirectives.str().find("#include \"Module.h\"\n"));
+}
+
+TEST_FIXTURE(ParserTest, ASTCollectionOnlyMatchesMergedAST)
+{
+    std::vector<std::string> headers =
+        {
+            TestData::NestedNamespaceHeader(),
+            TestData::NamespaceWithVarsAndFunctionsHeader(),
+            TestData::ClassHeader(),
+            TestData::EnumHeader(),
+            TestData::InheritanceHeader(),
+            TestData::TemplateFunctionHeader(),
+            TestData::TemplateClassHeader(),
+            TestData::IMemoryHeader(),
+        };
+    for (auto const & header : headers)
+    {
+        Parser parser(header);
+        ASSERT_TRUE(parser.Parse(compileOptions));
+        Parser parserCollectionOnly(header, ParseFlags::ASTCollectionOnly);
+        ASSERT_TRUE(parserCollectionOnly.Parse(compileOptions));
+
+        EXPECT_EQ(size_t{0}, parserCollectionOnly.GetAST().Contents().size());
+
+        std::ostringstream expected;
+        parserCollectionOnly.GetASTCollection().GenerateCode(expected, 0);
+        std::ostringstream actual;
+        parser.GetASTCollection().GenerateCode(actual, 0);
+        EXPECT_EQ(expected.str(), actual.str());
+
+        expected.str("");
+        parserCollectionOnly.GetASTCollection().Show(expected, 0);
+        actual.str("");
+        parser.GetASTCollection().Show(actual, 0);
+        EXPECT_EQ(expected.str(), actual.str());
+    }
+}
+
+// Writes a line for every event, indented by the number of declarations entered
+class RecordingListener : public IDeclarationListener
+{
+public:
+    RecordingListener()
+        : _stream()
+        , _depth()
+    {}
+
+    std::string Events() const { return _stream.str(); }
+
+    virtual void Enter(const DeclarationEvent & declaration) override
+    {
+        Line() << "enter " << declaration.name;
+        if (!declaration.type.empty())
+            _stream << " : " << declaration.type;
+        if (!declaration.parameters.empty())
+            _stream << " (" << declaration.parameters.size() << " parameters)";
+        if ((declaration.flags & FunctionFlags::PureVirtual) != 0)
+            _stream << " pure virtual";
+        _stream << std::endl;
+        ++_depth;
+    }
+    virtual void Leave(const DeclarationEvent & declaration) override
+    {
+        --_depth;
+        Line() << "leave " << declaration.name << std::endl;
+    }
+    virtual void EnumValue(const EnumConstant & value) override
+    {
+        Line() << "value " << value.Name() << " = " << value.Value() << std::endl;
+    }
+    virtual void BaseClass(const SourceLocation &, const std::string & name, AccessSpecifier, bool) override
+    {
+        Line() << "base " << name << std::endl;
+    }
+    virtual void TemplateParameter(const std::string & name) override
+    {
+        Line() << "template parameter " << name << std::endl;
+    }
+
+private:
+    std::ostringstream _stream;
+    int _depth;
+
+    std::ostream & Line()
+    {
+        _stream << std::string(static_cast<size_t>(2 * _depth), ' ');
+        return _stream;
+    }
+};
+
+TEST_FIXTURE(ParserTest, ListenerOnly)
+{
+    RecordingListener listener;
+    Parser parser(TestData::ClassHeader(), ParseFlags::ListenerOnly);
+    parser.SetDeclarationListener(&listener);
+
+    ASSERT_TRUE(parser.Parse(compileOptions));
+
+    EXPECT_EQ(size_t{0}, parser.GetAST().Contents().size());
+    EXPECT_EQ(size_t{0}, parser.GetASTCollection().Namespaces().size());
+
+    std::string expected =
+        "enter NS1\n"
+        "  enter interface\n"
+        "    enter interface\n"
+        "    leave interface\n"
+        "    enter ~interface\n"
+        "    leave ~interface\n"
+        "    enter callme : void pure virtual\n"
+        "    leave callme\n"
+        "  leave interface\n"
+        "  enter NS2\n"
+        "    enter c\n"
+        "      enter c (1 parameters)\n"
+        "      leave c\n"
+        "      enter ~c\n"
+        "      leave ~c\n"
+        "      enter X : const NS1::interface *\n"
+        "      leave X\n"
+        "      enter _interface : const NS1::interface *\n"
+        "      leave _interface\n"
+        "    leave c\n"
+        "  leave NS2\n"
+        "leave NS1\n";
+    EXPECT_EQ(expected, listener.Events());
+}
+
+TEST_FIXTURE(ParserTest, ListenerWithTree)
+{
+    RecordingListener listener;
+    Parser parser(TestData::EnumHeader());
+    parser.SetDeclarationListener(&listener);
+
+    ASSERT_TRUE(parser.Parse(compileOptions));
+
+    // The tree is built as well
+    EXPECT_EQ(size_t{1}, parser.GetASTCollection().Namespaces().size());
+
+    std::string expected =
+        "enter NS1\n"
+        "  enter NS2\n"
+        "    enter e : short\n"
+        "      value a = 0\n"
+        "      value b = 1\n"
+        "    leave e\n"
+        "  leave NS2\n"
+        "leave NS1\n";
+    EXPECT_EQ(expected, listener.Events());
+}
+
 TEST_FIXTURE(ParserTest, Struct)
 {
     Parser parser(TestData::StructHeader());
@@ -488,7 +738,7 @@ TEST_FIXTURE(ParserTest, Struct)
     const Namespace::Ptr ns2 = ns1->Namespaces()[0];
     ASSERT_NE(nullptr, ns2);
     EXPECT_EQ("NS2", ns2->Name());
-    EXPECT_EQ(ns1, ns2->Parent());
+    EXPECT_EQ(ns1.get(), ns2->Parent());
 
     EXPECT_EQ(size_t{0}, ns2->Namespaces().size());
     EXPECT_EQ(size_t{0}, ns2->Classes().size());
@@ -505,7 +755,7 @@ TEST_FIXTURE(ParserTest, Struct)
     Struct::Ptr structDef = ns2->Structs()[0];
     ASSERT_NE(nullptr, structDef);
     EXPECT_EQ("interface", structDef->Name());
-    EXPECT_EQ(ns2, structDef->Parent());
+    EXPECT_EQ(ns2.get(), structDef->Parent());
 
     EXPECT_EQ(size_t{0}, structDef->Namespaces().size());
     EXPECT_EQ(size_t{0}, structDef->Classes().size());
@@ -524,7 +774,7 @@ TEST_FIXTURE(ParserTest, Struct)
     structDef = ns2->Structs()[1];
     ASSERT_NE(nullptr, structDef);
     EXPECT_EQ("s", structDef->Name());
-    EXPECT_EQ(ns2, structDef->Parent());
+    EXPECT_EQ(ns2.get(), structDef->Parent());
 
     EXPECT_EQ(size_t{0}, structDef->Namespaces().size());
     EXPECT_EQ(size_t{0}, structDef->Classes().size());
@@ -623,7 +873,7 @@ TEST_FIXTURE(ParserTest, Enum)
     const Namespace::Ptr ns2 = ns1->Namespaces()[0];
     ASSERT_NE(nullptr, ns2);
     EXPECT_EQ("NS2", ns2->Name());
-    EXPECT_EQ(ns1, ns2->Parent());
+    EXPECT_EQ(ns1.get(), ns2->Parent());
 
     EXPECT_EQ("namespace NS1::NS2", ns2->QualifiedDescription());
 
@@ -642,7 +892,7 @@ TEST_FIXTURE(ParserTest, Enum)
     const Enum::Ptr enumeration = ns2->Enums()[0];
     ASSERT_NE(nullptr, enumeration);
     EXPECT_EQ("e", enumeration->Name());
-    EXPECT_EQ(ns2, enumeration->Parent());
+    EXPECT_EQ(ns2.get(), enumeration->Parent());
     EXPECT_EQ(size_t {2}, enumeration->Values().size());
 
     std::string expected =
@@ -714,7 +964,7 @@ TEST_FIXTURE(ParserTest, EnumAnonymous)
     const Namespace::Ptr ns2 = ns1->Namespaces()[0];
     ASSERT_NE(nullptr, ns2);
     EXPECT_EQ("NS2", ns2->Name());
-    EXPECT_EQ(ns1, ns2->Parent());
+    EXPECT_EQ(ns1.get(), ns2->Parent());
 
     EXPECT_EQ("namespace NS1::NS2", ns2->QualifiedDescription());
 
@@ -733,7 +983,7 @@ TEST_FIXTURE(ParserTest, EnumAnonymous)
     const Enum::Ptr enumeration = ns2->Enums()[0];
     ASSERT_NE(nullptr, enumeration);
     EXPECT_EQ("", enumeration->Name());
-    EXPECT_EQ(ns2, enumeration->Parent());
+    EXPECT_EQ(ns2.get(), enumeration->Parent());
 
     std::string expected =
         "namespace NS1 {\n"
@@ -804,7 +1054,7 @@ TEST_FIXTURE(ParserTest, Inheritance)
     const Namespace::Ptr ns2 = ns1->Namespaces()[0];
     ASSERT_NE(nullptr, ns2);
     EXPECT_EQ("NS2", ns2->Name());
-    EXPECT_EQ(ns1, ns2->Parent());
+    EXPECT_EQ(ns1.get(), ns2->Parent());
 
     EXPECT_EQ("namespace NS1::NS2", ns2->QualifiedDescription());
 
@@ -821,12 +1071,12 @@ TEST_FIXTURE(ParserTest, Inheritance)
     const Class::Ptr A = ns2->Classes()[0];
     ASSERT_NE(nullptr, A);
     EXPECT_EQ("A", A->Name());
-    EXPECT_EQ(ns2, A->Parent());
+    EXPECT_EQ(ns2.get(), A->Parent());
 
     const Class::Ptr B = ns2->Classes()[1];
     ASSERT_NE(nullptr, B);
     EXPECT_EQ("B", B->Name());
-    EXPECT_EQ(ns2, B->Parent());
+    EXPECT_EQ(ns2.get(), B->Parent());
 
     EXPECT_EQ("class NS1::NS2::A", ns2->Classes()[0]->QualifiedDescription());
     EXPECT_EQ("class NS1::NS2::B", ns2->Classes()[1]->QualifiedDescription());
@@ -1183,7 +1433,7 @@ TEST_FIXTURE(ParserTest, IMemory)
     const Namespace::Ptr nsPluginHost = nsWPEFramework->Namespaces()[0];
     ASSERT_NE(nullptr, nsPluginHost);
     EXPECT_EQ("PluginHost", nsPluginHost->Name());
-    EXPECT_EQ(nsWPEFramework, nsPluginHost->Parent());
+    EXPECT_EQ(nsWPEFramework.get(), nsPluginHost->Parent());
 
     EXPECT_EQ(size_t{0}, nsPluginHost->Namespaces().size());
     EXPECT_EQ(size_t{1}, nsPluginHost->Classes().size());
@@ -1198,7 +1448,7 @@ TEST_FIXTURE(ParserTest, IMemory)
     const Namespace::Ptr nsWeb = nsWPEFramework->Namespaces()[1];
     ASSERT_NE(nullptr, nsWeb);
     EXPECT_EQ("Web", nsWeb->Name());
-    EXPECT_EQ(nsWPEFramework, nsWeb->Parent());
+    EXPECT_EQ(nsWPEFramework.get(), nsWeb->Parent());
 
     EXPECT_EQ(size_t{0}, nsWeb->Namespaces().size());
     EXPECT_EQ(size_t{2}, nsWeb->Classes().size());
@@ -1213,7 +1463,7 @@ TEST_FIXTURE(ParserTest, IMemory)
     const Namespace::Ptr nsExchange = nsWPEFramework->Namespaces()[2];
     ASSERT_NE(nullptr, nsExchange);
     EXPECT_EQ("Exchange", nsExchange->Name());
-    EXPECT_EQ(nsWPEFramework, nsExchange->Parent());
+    EXPECT_EQ(nsWPEFramework.get(), nsExchange->Parent());
 
     EXPECT_EQ(size_t{0}, nsExchange->Namespaces().size());
     EXPECT_EQ(size_t{0}, nsExchange->Classes().size());
@@ -1228,7 +1478,7 @@ TEST_FIXTURE(ParserTest, IMemory)
     const Struct::Ptr intf = nsExchange->Structs()[0];
     ASSERT_NE(nullptr, intf);
     EXPECT_EQ("IMemory", intf->Name());
-    EXPECT_EQ(nsExchange, intf->Parent());
+    EXPECT_EQ(nsExchange.get(), intf->Parent());
 
     std::string expected =
         "namespace Core {\n"
@@ -1332,6 +1582,62 @@ TEST_FIXTURE(ParserTest, IMemory)
     EXPECT_EQ(expected, actual);
 }
 
+TEST_FIXTURE(ParserTest, IMemoryMainFileOnly)
+{
+    Parser parser(TestData::IMemoryHeader(), ParseFlags::MainFileOnly);
+
+    ASSERT_TRUE(parser.Parse(compileOptionsWPEFramework));
+
+    // Module.h is skipped, so the base class is only known by name
+    std::string expected =
+        "namespace WPEFramework {\n"
+        "    namespace Exchange {\n"
+        "        struct IMemory : virtual public Core::IUnknown {\n"
+        "            enum {\n"
+        "                ID = 82,\n"
+        "            }; // enum <anonymous>\n"
+        "            virtual ~IMemory();\n"
+        "            virtual uint64 Resident() const = 0;\n"
+        "            virtual uint64 Allocated() const = 0;\n"
+        "            virtual uint64 Shared() const = 0;\n"
+        "            virtual uint8 Processes() const = 0;\n"
+        "            virtual const bool IsOperational() const = 0;\n"
+        "        }; // struct IMemory\n"
+        "    } // namespace Exchange\n"
+        "} // namespace WPEFramework\n";
+    std::ostringstream stream;
+    parser.TraverseTree(stream);
+    EXPECT_EQ(expected, stream.str());
+
+    auto const & bases = parser.GetAST().Namespaces()[0]->Namespaces()[0]->Structs()[0]->BaseTypes();
+    ASSERT_EQ(size_t{1}, bases.size());
+    EXPECT_EQ(nullptr, bases[0]->BaseType());
+    EXPECT_EQ("c:@N@Core@S@IUnknown", bases[0]->BaseUSR());
+}
+
+TEST_FIXTURE(ParserTest, IMemoryAllowedPaths)
+{
+    Parser parser(TestData::IMemoryHeader());
+    ASSERT_TRUE(parser.Parse(compileOptionsWPEFramework));
+
+    // Module.h is in the allowed directory, so nothing is skipped
+    Parser parserAllowed(TestData::IMemoryHeader(), ParseFlags::MainFileOnly);
+    parserAllowed.SetAllowedPaths({TestData::TestRoot()});
+    ASSERT_TRUE(parserAllowed.Parse(compileOptionsWPEFramework));
+
+    std::ostringstream expected;
+    parser.TraverseTree(expected);
+    std::ostringstream actual;
+    parserAllowed.TraverseTree(actual);
+    EXPECT_EQ(expected.str(), actual.str());
+
+    // A directory that merely starts with the same name does not match
+    Parser parserOther(TestData::IMemoryHeader());
+    parserOther.SetAllowedPaths({TestData::CombinePath(TestData::TestRoot(), "Mod")});
+    ASSERT_TRUE(parserOther.Parse(compileOptionsWPEFramework));
+    EXPECT_EQ(size_t{1}, parserOther.GetASTCollection().Namespaces().size());
+}
+
 TEST_FIXTURE(ParserTest, IPluginComplete)
 {
     Parser parser(TestData::IPluginHeader());
@@ -1384,7 +1690,7 @@ TEST_FIXTURE(ParserTest, IPluginComplete)
     const Namespace::Ptr nsPluginHost = nsWPEFramework->Namespaces()[0];
     ASSERT_NE(nullptr, nsPluginHost);
     EXPECT_EQ("PluginHost", nsPluginHost->Name());
-    EXPECT_EQ(nsWPEFramework, nsPluginHost->Parent());
+    EXPECT_EQ(nsWPEFramework.get(), nsPluginHost->Parent());
 
     EXPECT_EQ(size_t{0}, nsPluginHost->Namespaces().size());
     EXPECT_EQ(size_t{1}, nsPluginHost->Classes().size());
@@ -1399,7 +1705,7 @@ TEST_FIXTURE(ParserTest, IPluginComplete)
     const Namespace::Ptr nsWeb = nsWPEFramework->Namespaces()[1];
     ASSERT_NE(nullptr, nsWeb);
     EXPECT_EQ("Web", nsWeb->Name());
-    EXPECT_EQ(nsWPEFramework, nsWeb->Parent());
+    EXPECT_EQ(nsWPEFramework.get(), nsWeb->Parent());
 
     EXPECT_EQ(size_t{0}, nsWeb->Namespaces().size());
     EXPECT_EQ(size_t{2}, nsWeb->Classes().size());
@@ -1414,7 +1720,7 @@ TEST_FIXTURE(ParserTest, IPluginComplete)
     const Struct::Ptr IPlugin = nsPluginHost->Structs()[1];
     ASSERT_NE(nullptr, IPlugin);
     EXPECT_EQ("IPlugin", IPlugin->Name());
-    EXPECT_EQ(nsPluginHost, IPlugin->Parent());
+    EXPECT_EQ(nsPluginHost.get(), IPlugin->Parent());
 
     std::string expected =
         "namespace Core {\n"
@@ -1660,7 +1966,7 @@ TEST_FIXTURE(ParserTest, IPlugin)
     const Namespace::Ptr nsPluginHost = nsWPEFramework->Namespaces()[0];
     ASSERT_NE(nullptr, nsPluginHost);
     EXPECT_EQ("PluginHost", nsPluginHost->Name());
-    EXPECT_EQ(nsWPEFramework, nsPluginHost->Parent());
+    EXPECT_EQ(nsWPEFramework.get(), nsPluginHost->Parent());
 
     EXPECT_EQ(size_t{0}, nsPluginHost->Namespaces().size());
     EXPECT_EQ(size_t{1}, nsPluginHost->Classes().size());
@@ -1675,7 +1981,7 @@ TEST_FIXTURE(ParserTest, IPlugin)
     const Namespace::Ptr nsWeb = nsWPEFramework->Namespaces()[1];
     ASSERT_NE(nullptr, nsWeb);
     EXPECT_EQ("Web", nsWeb->Name());
-    EXPECT_EQ(nsWPEFramework, nsWeb->Parent());
+    EXPECT_EQ(nsWPEFramework.get(), nsWeb->Parent());
 
     EXPECT_EQ(size_t{0}, nsWeb->Namespaces().size());
     EXPECT_EQ(size_t{2}, nsWeb->Classes().size());
@@ -1690,7 +1996,7 @@ TEST_FIXTURE(ParserTest, IPlugin)
     const Struct::Ptr IPlugin = nsPluginHost->Structs()[1];
     ASSERT_NE(nullptr, IPlugin);
     EXPECT_EQ("IPlugin", IPlugin->Name());
-    EXPECT_EQ(nsPluginHost, IPlugin->Parent());
+    EXPECT_EQ(nsPluginHost.get(), IPlugin->Parent());
 
     std::string expected =
         "struct IPlugin : virtual public Core::IUnknown {\n"
@@ -1753,7 +2059,7 @@ TEST_FIXTURE(ParserTest, IPluginExtended)
     const Namespace::Ptr nsPluginHost = nsWPEFramework->Namespaces()[0];
     ASSERT_NE(nullptr, nsPluginHost);
     EXPECT_EQ("PluginHost", nsPluginHost->Name());
-    EXPECT_EQ(nsWPEFramework, nsPluginHost->Parent());
+    EXPECT_EQ(nsWPEFramework.get(), nsPluginHost->Parent());
 
     EXPECT_EQ(size_t{0}, nsPluginHost->Namespaces().size());
     EXPECT_EQ(size_t{1}, nsPluginHost->Classes().size());
@@ -1768,7 +2074,7 @@ TEST_FIXTURE(ParserTest, IPluginExtended)
     const Struct::Ptr IPluginExtended = nsPluginHost->Structs()[2];
     ASSERT_NE(nullptr, IPluginExtended);
     EXPECT_EQ("IPluginExtended", IPluginExtended->Name());
-    EXPECT_EQ(nsPluginHost, IPluginExtended->Parent());
+    EXPECT_EQ(nsPluginHost.get(), IPluginExtended->Parent());
 
     std::string expected =
         "struct IPluginExtended : public struct WPEFramework::PluginHost::IPlugin {\n"
@@ -1925,7 +2231,7 @@ TEST_FIXTURE(ParserTest, IWeb)
     const Namespace::Ptr nsPluginHost = nsWPEFramework->Namespaces()[0];
     ASSERT_NE(nullptr, nsPluginHost);
     EXPECT_EQ("PluginHost", nsPluginHost->Name());
-    EXPECT_EQ(nsWPEFramework, nsPluginHost->Parent());
+    EXPECT_EQ(nsWPEFramework.get(), nsPluginHost->Parent());
 
     EXPECT_EQ(size_t{0}, nsPluginHost->Namespaces().size());
     EXPECT_EQ(size_t{1}, nsPluginHost->Classes().size());
@@ -1940,7 +2246,7 @@ TEST_FIXTURE(ParserTest, IWeb)
     const Struct::Ptr IWeb = nsPluginHost->Structs()[3];
     ASSERT_NE(nullptr, IWeb);
     EXPECT_EQ("IWeb", IWeb->Name());
-    EXPECT_EQ(nsPluginHost, IWeb->Parent());
+    EXPECT_EQ(nsPluginHost.get(), IWeb->Parent());
 
     std::string expected =
         "struct IWeb : virtual public Core::IUnknown {\n"
@@ -2009,7 +2315,7 @@ TEST_FIXTURE(ParserTest, IWebSocket)
     const Namespace::Ptr nsPluginHost = nsWPEFramework->Namespaces()[0];
     ASSERT_NE(nullptr, nsPluginHost);
     EXPECT_EQ("PluginHost", nsPluginHost->Name());
-    EXPECT_EQ(nsWPEFramework, nsPluginHost->Parent());
+    EXPECT_EQ(nsWPEFramework.get(), nsPluginHost->Parent());
 
     EXPECT_EQ(size_t{0}, nsPluginHost->Namespaces().size());
     EXPECT_EQ(size_t{1}, nsPluginHost->Classes().size());
@@ -2024,7 +2330,7 @@ TEST_FIXTURE(ParserTest, IWebSocket)
     const Namespace::Ptr nsWeb = nsWPEFramework->Namespaces()[1];
     ASSERT_NE(nullptr, nsWeb);
     EXPECT_EQ("Web", nsWeb->Name());
-    EXPECT_EQ(nsWPEFramework, nsWeb->Parent());
+    EXPECT_EQ(nsWPEFramework.get(), nsWeb->Parent());
 
     EXPECT_EQ(size_t{0}, nsWeb->Namespaces().size());
     EXPECT_EQ(size_t{2}, nsWeb->Classes().size());
@@ -2039,7 +2345,7 @@ TEST_FIXTURE(ParserTest, IWebSocket)
     const Struct::Ptr IWebSocket = nsPluginHost->Structs()[4];
     ASSERT_NE(nullptr, IWebSocket);
     EXPECT_EQ("IWebSocket", IWebSocket->Name());
-    EXPECT_EQ(nsPluginHost, IWebSocket->Parent());
+    EXPECT_EQ(nsPluginHost.get(), IWebSocket->Parent());
 
     std::string expected =
         "struct IWebSocket : virtual public Core::IUnknown {\n"
@@ -2093,7 +2399,7 @@ TEST_FIXTURE(ParserTest, IChannel)
     const Namespace::Ptr nsPluginHost = nsWPEFramework->Namespaces()[0];
     ASSERT_NE(nullptr, nsPluginHost);
     EXPECT_EQ("PluginHost", nsPluginHost->Name());
-    EXPECT_EQ(nsWPEFramework, nsPluginHost->Parent());
+    EXPECT_EQ(nsWPEFramework.get(), nsPluginHost->Parent());
 
     EXPECT_EQ(size_t{0}, nsPluginHost->Namespaces().size());
     EXPECT_EQ(size_t{1}, nsPluginHost->Classes().size());
@@ -2108,7 +2414,7 @@ TEST_FIXTURE(ParserTest, IChannel)
     const Struct::Ptr IChannel = nsPluginHost->Structs()[5];
     ASSERT_NE(nullptr, IChannel);
     EXPECT_EQ("IChannel", IChannel->Name());
-    EXPECT_EQ(nsPluginHost, IChannel->Parent());
+    EXPECT_EQ(nsPluginHost.get(), IChannel->Parent());
 
     std::string expected =
         "struct IChannel : virtual public Core::IUnknown {\n"
@@ -2162,7 +2468,7 @@ TEST_FIXTURE(ParserTest, ISecurity)
     const Namespace::Ptr nsPluginHost = nsWPEFramework->Namespaces()[0];
     ASSERT_NE(nullptr, nsPluginHost);
     EXPECT_EQ("PluginHost", nsPluginHost->Name());
-    EXPECT_EQ(nsWPEFramework, nsPluginHost->Parent());
+    EXPECT_EQ(nsWPEFramework.get(), nsPluginHost->Parent());
 
     EXPECT_EQ(size_t{0}, nsPluginHost->Namespaces().size());
     EXPECT_EQ(size_t{1}, nsPluginHost->Classes().size());
@@ -2177,7 +2483,7 @@ TEST_FIXTURE(ParserTest, ISecurity)
     const Struct::Ptr ISecurity = nsPluginHost->Structs()[6];
     ASSERT_NE(nullptr, ISecurity);
     EXPECT_EQ("ISecurity", ISecurity->Name());
-    EXPECT_EQ(nsPluginHost, ISecurity->Parent());
+    EXPECT_EQ(nsPluginHost.get(), ISecurity->Parent());
 
     std::string expected =
         "struct ISecurity : virtual public Core::IUnknown {\n"
@@ -0,0 +1,130 @@
+#include <unittest-c++/UnitTestC++.h>
+#include <cstdlib>
+#include <fstream>
+#include <include/PrecompiledPrefix.h>
+#include <include/Parser.h>
+
+namespace CPPParser {
+namespace Test {
+
+class PrecompiledPrefixTest : public ::UnitTestCpp::TestFixture {
+protected:
+    virtual void SetUp()
+    {
+        char directoryTemplate[] = "/tmp/PSGeneratorPrefixTest.XXXXXX";
+        _directory = mkdtemp(directoryTemplate);
+    }
+
+    virtual void TearDown()
+    {
+        std::system(("rm -rf " + _directory).c_str());
+    }
+
+    std::string _directory;
+};
+
+static OptionsList compileOptions =
+    {
+        "-x",
+        "c++",
+        "-std=c++11",
+    };
+
+static void WriteFile(const std::string & path, const std::string & contents)
+{
+    std::ofstream file(path);
+    file << contents;
+}
+
+static std::string ShowAST(const AST & ast)
+{
+    std::ostringstream stream;
+    ast.Show(stream, 0);
+    return stream.str();
+}
+
+TEST_FIXTURE(PrecompiledPrefixTest, IncludePrefix)
+{
+    std::string path = _directory + "/IFirst.h";
+    WriteFile(_directory + "/Module.h", "#pragma once\n");
+    WriteFile(path,
+              "// Copyright\n"
+              "#ifndef IFIRST_H\n"
+              "#define IFIRST_H\n"
+              "\n"
+              "/* Module include */\n"
+              "#include \"Module.h\"\n"
+              "#  include <string>\n"
+              "\n"
+              "namespace Core {\n"
+              "#include <vector>\n"
+              "}\n"
+              "#endif\n");
+
+    std::vector<std::string> expected =
+        {
+            "#include \"" + _directory + "/Module.h\"",
+            "#include <string>",
+        };
+    EXPECT_TRUE(expected == PrecompiledPrefix::IncludePrefix(path));
+}
+
+TEST_FIXTURE(PrecompiledPrefixTest, CommonPrefix)
+{
+    std::vector<std::vector<std::string>> prefixes =
+        {
+            { "#include <string>", "#include <vector>", "#include <map>" },
+            { "#include <string>", "#include <vector>" },
+            { "#include <string>", "#include <vector>", "#include <list>" },
+        };
+    std::vector<std::string> expected = { "#include <string>", "#include <vector>" };
+    EXPECT_TRUE(expected == PrecompiledPrefix::CommonPrefix(prefixes));
+    EXPECT_TRUE(PrecompiledPrefix::CommonPrefix({}).empty());
+}
+
+TEST_FIXTURE(PrecompiledPrefixTest, NoCommonPrefix)
+{
+    WriteFile(_directory + "/A.h", "#include <string>\nclass A {};\n");
+    WriteFile(_directory + "/B.h", "class B {};\n");
+
+    PrecompiledPrefix prefix(_directory);
+    EXPECT_FALSE(prefix.Build({ _directory + "/A.h", _directory + "/B.h" }, compileOptions));
+    EXPECT_FALSE(prefix.IsValid());
+}
+
+TEST_FIXTURE(PrecompiledPrefixTest, ParseWithPrecompiledPrefix)
+{
+    WriteFile(_directory + "/Module.h", "#pragma once\nnamespace Core { class Base { public: virtual ~Base(); }; }\n");
+    WriteFile(_directory + "/IFirst.h", "#include \"Module.h\"\nnamespace Core { class IFirst : public Base { public: virtual void First() = 0; }; }\n");
+    WriteFile(_directory + "/ISecond.h", "#include \"Module.h\"\nnamespace Core { class ISecond : public Base { public: virtual int Second() = 0; }; }\n");
+    std::vector<std::string> inputFiles = { _directory + "/IFirst.h", _directory + "/ISecond.h" };
+
+    PrecompiledPrefix prefix(_directory);
+    ASSERT_TRUE(prefix.Build(inputFiles, compileOptions));
+    EXPECT_TRUE(prefix.IsValid());
+    EXPECT_FALSE(prefix.Files().empty());
+
+    ParseContext context;
+    context.SetPrecompiledPrefix(&prefix);
+    for (auto const & inputFile : inputFiles)
+    {
+        Parser parser(inputFile);
+        ASSERT_TRUE(parser.Parse(compileOptions));
+        Parser prefixParser(inputFile, ParseFlags::NoParseFlags, nullptr, &context);
+        ASSERT_TRUE(prefixParser.Parse(compileOptions));
+        EXPECT_EQ(ShowAST(parser.GetAST()), ShowAST(prefixParser.GetAST()));
+    }
+
+    // An up to date header is reused, a changed prefix header causes a rebuild
+    std::string pchPath = prefix.PCHPath();
+    PrecompiledPrefix reused(_directory);
+    ASSERT_TRUE(reused.Build(inputFiles, compileOptions));
+    EXPECT_EQ(pchPath, reused.PCHPath());
+    WriteFile(_directory + "/Module.h", "#pragma once\nnamespace Core { class Base { public: virtual ~Base(); int x; }; }\n");
+    PrecompiledPrefix rebuilt(_directory);
+    ASSERT_TRUE(rebuilt.Build(inputFiles, compileOptions));
+    EXPECT_TRUE(prefix.Files() == rebuilt.Files());
+}
+
+} // namespace Test
+} // namespace CPPParser
@@ -0,0 +1,27 @@
+#include <unittest-c++/UnitTestC++.h>
+#include <include/SourceFilter.h>
+
+namespace CPPParser {
+namespace Test {
+
+class SourceFilterTest : public ::UnitTestCpp::TestFixture {
+};
+
+TEST_FIXTURE(SourceFilterTest, MatchesPath)
+{
+    std::vector<std::string> allowedPaths = { "/usr/include/plugins", "/home/user/Module.h", "/opt/" };
+
+    EXPECT_TRUE(SourceFilter::MatchesPath("/usr/include/plugins", allowedPaths));
+    EXPECT_TRUE(SourceFilter::MatchesPath("/usr/include/plugins/IPlugin.h", allowedPaths));
+    EXPECT_TRUE(SourceFilter::MatchesPath("/usr/include/plugins/interfaces/IMemory.h", allowedPaths));
+    EXPECT_TRUE(SourceFilter::MatchesPath("/home/user/Module.h", allowedPaths));
+    EXPECT_TRUE(SourceFilter::MatchesPath("/opt/Module.h", allowedPaths));
+    EXPECT_FALSE(SourceFilter::MatchesPath("/usr/include/plugins2/IPlugin.h", allowedPaths));
+    EXPECT_FALSE(SourceFilter::MatchesPath("/usr/include/stdio.h", allowedPaths));
+    EXPECT_FALSE(SourceFilter::MatchesPath("/home/user/Module.hpp", allowedPaths));
+    EXPECT_FALSE(SourceFilter::MatchesPath("/usr/include/plugins", {}));
+    EXPECT_FALSE(SourceFilter::MatchesPath("/usr/include/plugins", { "" }));
+}
+
+} // namespace Test
+} // namespace CPPParser
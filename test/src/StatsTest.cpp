@@ -0,0 +1,113 @@
+#include <unittest-c++/UnitTestC++.h>
+#include <sstream>
+#include <include/AST.h>
+#include <include/Class.h>
+#include <include/Namespace.h>
+#include <include/Stats.h>
+
+namespace CPPParser {
+namespace Test {
+
+class StatsTest : public ::UnitTestCpp::TestFixture {
+protected:
+    virtual void SetUp()
+    {
+        Stats::Reset();
+    }
+
+    virtual void TearDown()
+    {
+        Stats::Enable(false);
+        Stats::Reset();
+    }
+};
+
+TEST_FIXTURE(StatsTest, DisabledByDefault)
+{
+    EXPECT_FALSE(Stats::IsEnabled());
+    Namespace aNamespace(Element::WeakPtr(), SourceLocation(), "NS");
+    EXPECT_EQ(uint64_t {0}, Stats::Nodes(ElementKind::Namespace));
+}
+
+TEST_FIXTURE(StatsTest, CountsNodesAndBytes)
+{
+    Stats::Enable(true);
+    Namespace aNamespace(Element::WeakPtr(), SourceLocation(), "NS");
+    Class class1(Element::WeakPtr(), SourceLocation(), "A", AccessSpecifier::Public);
+    Class class2(Element::WeakPtr(), SourceLocation(), "B", AccessSpecifier::Public);
+    EXPECT_EQ(uint64_t {1}, Stats::Nodes(ElementKind::Namespace));
+    EXPECT_EQ(uint64_t {2}, Stats::Nodes(ElementKind::Class));
+    EXPECT_EQ(uint64_t {0}, Stats::Nodes(ElementKind::Struct));
+
+    AST ast;
+    ast.Add(std::make_shared<Namespace>(Element::WeakPtr(), SourceLocation(), "NS"));
+    std::ostringstream stream;
+    ast.GenerateCode(stream, 0);
+    ASSERT_NE(size_t {0}, stream.str().size());
+    EXPECT_EQ(uint64_t {stream.str().size()}, Stats::Bytes());
+}
+
+TEST_FIXTURE(StatsTest, PhaseTimes)
+{
+    Stats::Enable(true);
+    PhaseTime time;
+    time.wallSeconds = 2.0;
+    time.cpuSeconds = 1.0;
+    ParseStats parseStats;
+    parseStats.AddTime(StatsPhase::Parse, time);
+    parseStats.AddTime(StatsPhase::Parse, time);
+    ParseStats::CountCursor(parseStats.cursorsVisited, CXCursor_Namespace);
+    ParseStats::CountCursor(parseStats.cursorsVisited, CXCursor_CompoundStmt);
+    ParseStats::CountCursor(parseStats.cursorsHandled, CXCursor_Namespace);
+    Stats::Add("A.h", parseStats);
+    Stats::Add("B.h", parseStats);
+    Stats::AddTime("A.h", StatsPhase::Output, time);
+    Stats::AddTime("B.h", StatsPhase::TreeBuild, time);
+
+    EXPECT_EQ(8.0, Stats::Total(StatsPhase::Parse).wallSeconds);
+    EXPECT_EQ(4.0, Stats::Total(StatsPhase::Parse).cpuSeconds);
+    EXPECT_EQ(2.0, Stats::Total(StatsPhase::Output).wallSeconds);
+    EXPECT_EQ(0.0, Stats::Total(StatsPhase::Visit).wallSeconds);
+    EXPECT_EQ(1.0, Stats::Total(StatsPhase::TreeBuild).cpuSeconds);
+
+    std::ostringstream stream;
+    Stats::ReportJSON(stream);
+    std::string json = stream.str();
+    EXPECT_TRUE(json.find("\"path\": \"A.h\"") != std::string::npos);
+    EXPECT_TRUE(json.find("\"path\": \"B.h\"") != std::string::npos);
+    EXPECT_TRUE(json.find("\"visited\": 2, \"handled\": 2") != std::string::npos);
+    EXPECT_TRUE(json.find("\"visited\": 2, \"handled\": 0") != std::string::npos);
+    EXPECT_TRUE(json.find("\"tree-build\"") != std::string::npos);
+
+    stream.str("");
+    Stats::Report(stream);
+    EXPECT_TRUE(stream.str().find("Bytes emitted: 0") != std::string::npos);
+}
+
+TEST_FIXTURE(StatsTest, MemoryPerFile)
+{
+    Stats::Enable(true);
+    AST ast;
+    ast.Add(std::make_shared<Namespace>(Element::WeakPtr(), SourceLocation(), "NS"));
+    ParseStats parseStats;
+    parseStats.memory.AddTree(ast);
+    Stats::Add("A.h", parseStats);
+    Stats::Add("A.h", parseStats);
+    EXPECT_EQ(uint64_t {2}, Stats::Memory("A.h").Nodes(ElementKind::Namespace).count);
+    EXPECT_EQ(uint64_t {0}, Stats::Memory("B.h").Nodes(ElementKind::Namespace).count);
+    EXPECT_TRUE(Stats::PeakResidentBytes() > 0);
+
+    std::ostringstream stream;
+    Stats::ReportJSON(stream);
+    std::string json = stream.str();
+    EXPECT_TRUE(json.find("\"memory\": {\"nodes\": {\"AST\": {\"count\": 2") != std::string::npos);
+    EXPECT_TRUE(json.find("\"Namespace\": {\"count\": 2") != std::string::npos);
+    EXPECT_TRUE(json.find("\"peakResidentBytes\": ") != std::string::npos);
+
+    stream.str("");
+    Stats::Report(stream);
+    EXPECT_TRUE(stream.str().find("Peak resident set size: ") != std::string::npos);
+}
+
+} // namespace Test
+} // namespace CPPParser
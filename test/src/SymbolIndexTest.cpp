@@ -0,0 +1,89 @@
+#include <unittest-c++/UnitTestC++.h>
+#include <include/Class.h>
+#include <include/Parser.h>
+#include <include/ParserPool.h>
+#include <include/SymbolIndex.h>
+#include <include/TestData.h>
+
+namespace CPPParser {
+namespace Test {
+
+class SymbolIndexTest : public ::UnitTestCpp::TestFixture {
+protected:
+    virtual void SetUp() {}
+
+    virtual void TearDown() {}
+};
+
+static OptionsList compileOptions =
+    {
+        "-x",
+        "c++",
+        "-std=c++11",
+    };
+
+TEST_FIXTURE(SymbolIndexTest, AddAndFind)
+{
+    SymbolIndex index;
+    auto a = make_shared<Class>(Element::WeakPtr(), SourceLocation(), "A", AccessSpecifier::Public);
+    auto b = make_shared<Class>(Element::WeakPtr(), SourceLocation(), "B", AccessSpecifier::Public);
+    EXPECT_TRUE(index.Add("c:@S@A", a));
+    EXPECT_FALSE(index.Add("c:@S@A", b));
+    EXPECT_FALSE(index.Add("", b));
+    EXPECT_TRUE(index.Add("c:@S@B", b));
+    EXPECT_EQ(size_t {2}, index.Count());
+    EXPECT_TRUE(index.Find("c:@S@A") == a);
+    EXPECT_TRUE(index.Find("c:@S@B") == b);
+    EXPECT_TRUE(index.Find("c:@S@C") == nullptr);
+    index.Clear();
+    EXPECT_EQ(size_t {0}, index.Count());
+}
+
+TEST_FIXTURE(SymbolIndexTest, MergeKeepsFirstDeclaration)
+{
+    SymbolIndex first;
+    SymbolIndex second;
+    auto a = make_shared<Class>(Element::WeakPtr(), SourceLocation(), "A", AccessSpecifier::Public);
+    auto otherA = make_shared<Class>(Element::WeakPtr(), SourceLocation(), "A", AccessSpecifier::Public);
+    auto b = make_shared<Class>(Element::WeakPtr(), SourceLocation(), "B", AccessSpecifier::Public);
+    first.Add("c:@S@A", a);
+    second.Add("c:@S@A", otherA);
+    second.Add("c:@S@B", b);
+    first.Merge(second);
+    EXPECT_EQ(size_t {2}, first.Count());
+    EXPECT_TRUE(first.Find("c:@S@A") == a);
+    EXPECT_TRUE(first.Find("c:@S@B") == b);
+}
+
+TEST_FIXTURE(SymbolIndexTest, TypeKinds)
+{
+    EXPECT_TRUE(SymbolIndex::IsTypeKind(CXCursor_ClassDecl));
+    EXPECT_TRUE(SymbolIndex::IsTypeKind(CXCursor_TypedefDecl));
+    EXPECT_TRUE(SymbolIndex::IsTypeKind(CXCursor_TypeAliasDecl));
+    EXPECT_FALSE(SymbolIndex::IsTypeKind(CXCursor_Namespace));
+    EXPECT_FALSE(SymbolIndex::IsTypeKind(CXCursor_CXXMethod));
+}
+
+TEST_FIXTURE(SymbolIndexTest, ParseFillsIndex)
+{
+    Parser parser(TestData::InheritanceHeader());
+    ASSERT_TRUE(parser.Parse(compileOptions));
+
+    Declaration::Ptr a = parser.Symbols().Find("c:@N@NS1@N@NS2@S@A");
+    Declaration::Ptr b = parser.Symbols().Find("c:@N@NS1@N@NS2@S@B");
+    ASSERT_TRUE(a != nullptr);
+    ASSERT_TRUE(b != nullptr);
+    EXPECT_EQ("NS1::NS2::A", a->QualifiedName());
+    EXPECT_EQ("NS1::NS2::B", b->QualifiedName());
+}
+
+TEST_FIXTURE(SymbolIndexTest, PoolSharesIndexAcrossInputs)
+{
+    ParserPool parserPool(2);
+    ASSERT_TRUE(parserPool.Parse({ TestData::ClassHeader(), TestData::InheritanceHeader() }, compileOptions));
+    EXPECT_TRUE(parserPool.Symbols().Find("c:@N@NS1@N@NS2@S@B") != nullptr);
+    EXPECT_TRUE(parserPool.Symbols().Count() > 2);
+}
+
+} // namespace Test
+} // namespace CPPParser
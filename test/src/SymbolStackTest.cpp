@@ -0,0 +1,59 @@
+#include <unittest-c++/UnitTestC++.h>
+#include <string>
+#include <include/SymbolStack.h>
+
+namespace CPPParser {
+namespace Test {
+
+class SymbolStackTest : public ::UnitTestCpp::TestFixture {
+};
+
+TEST_FIXTURE(SymbolStackTest, PushAndFind)
+{
+    SymbolStack<int, std::string> stack;
+    EXPECT_EQ(ssize_t {-1}, stack.Find(1));
+    stack.Push(1, "one");
+    stack.Push(2, "two");
+    stack.Push(3, "three");
+    EXPECT_EQ(size_t {3}, stack.Count());
+    EXPECT_TRUE(stack.AtTop(3));
+    EXPECT_EQ(ssize_t {0}, stack.Find(3));
+    EXPECT_EQ(ssize_t {2}, stack.Find(1));
+    EXPECT_EQ(ssize_t {-1}, stack.Find(4));
+    EXPECT_EQ(2, stack.At(1));
+    EXPECT_EQ(std::string("two"), stack.ValueAt(1));
+}
+
+TEST_FIXTURE(SymbolStackTest, RemoveTopElements)
+{
+    SymbolStack<int, std::string> stack;
+    for (int index = 0; index < 100; ++index)
+    {
+        stack.Push(index, std::to_string(index));
+    }
+    stack.RemoveTopElements(90);
+    EXPECT_EQ(size_t {10}, stack.Count());
+    EXPECT_EQ(ssize_t {-1}, stack.Find(50));
+    EXPECT_EQ(ssize_t {0}, stack.Find(9));
+    EXPECT_EQ(9, stack.Pop());
+    EXPECT_EQ(ssize_t {-1}, stack.Find(9));
+    stack.RemoveTopElements(100);
+    EXPECT_EQ(size_t {0}, stack.Count());
+    EXPECT_EQ(ssize_t {-1}, stack.Find(0));
+}
+
+TEST_FIXTURE(SymbolStackTest, PushAgainHidesDeeperEntry)
+{
+    SymbolStack<int, std::string> stack;
+    stack.Push(1, "outer");
+    stack.Push(2, "middle");
+    stack.Push(1, "inner");
+    EXPECT_EQ(ssize_t {0}, stack.Find(1));
+    EXPECT_EQ(std::string("inner"), stack.ValueAt(0));
+    stack.Pop();
+    EXPECT_EQ(ssize_t {1}, stack.Find(1));
+    EXPECT_EQ(std::string("outer"), stack.ValueAt(static_cast<size_t>(stack.Find(1))));
+}
+
+} // namespace Test
+} // namespace CPPParser
@@ -0,0 +1,54 @@
+#include <unittest-c++/UnitTestC++.h>
+#include <sstream>
+#include <include/TraceEvents.h>
+
+namespace CPPParser {
+namespace Test {
+
+class TraceEventsTest : public ::UnitTestCpp::TestFixture {
+protected:
+    virtual void SetUp()
+    {
+        TraceEvents::Reset();
+    }
+
+    virtual void TearDown()
+    {
+        TraceEvents::Enable(false);
+        TraceEvents::Reset();
+    }
+};
+
+TEST_FIXTURE(TraceEventsTest, DisabledByDefault)
+{
+    EXPECT_FALSE(TraceEvents::IsEnabled());
+    {
+        TraceSpan span("parse");
+    }
+    EXPECT_EQ(size_t {0}, TraceEvents::Count());
+}
+
+TEST_FIXTURE(TraceEventsTest, WriteSpans)
+{
+    TraceEvents::Enable(true);
+    TraceEvents::SetThreadName("main");
+    const std::string file = "A.h";
+    {
+        TraceSpan outer("parse", file);
+        TraceSpan inner("build prefix");
+    }
+    EXPECT_EQ(size_t {2}, TraceEvents::Count());
+
+    std::ostringstream stream;
+    TraceEvents::Write(stream);
+    std::string json = stream.str();
+    EXPECT_TRUE(json.find("\"traceEvents\": [") != std::string::npos);
+    EXPECT_TRUE(json.find("\"name\": \"thread_name\", \"ph\": \"M\"") != std::string::npos);
+    EXPECT_TRUE(json.find("\"args\": {\"name\": \"main\"}") != std::string::npos);
+    EXPECT_TRUE(json.find("\"name\": \"parse\", \"cat\": \"psgenerator\", \"ph\": \"X\"") != std::string::npos);
+    EXPECT_TRUE(json.find("\"args\": {\"file\": \"A.h\"}") != std::string::npos);
+    EXPECT_TRUE(json.find("\"name\": \"build prefix\"") != std::string::npos);
+}
+
+} // namespace Test
+} // namespace CPPParser
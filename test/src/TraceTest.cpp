@@ -0,0 +1,87 @@
+#include <unittest-c++/UnitTestC++.h>
+#include <sstream>
+#include <include/Trace.h>
+
+namespace Utility {
+namespace Test {
+
+class TraceTest : public ::UnitTestCpp::TestFixture {
+protected:
+    virtual void SetUp()
+    {
+        SetLogStream(_stream);
+    }
+
+    virtual void TearDown()
+    {
+        Trace::Disable();
+        ResetLogStreams();
+    }
+
+    std::ostringstream _stream;
+};
+
+static int evaluationCount = 0;
+
+static std::string CountedMessage()
+{
+    ++evaluationCount;
+    return "message";
+}
+
+TEST_FIXTURE(TraceTest, DisabledByDefault)
+{
+    EXPECT_FALSE(Trace::IsEnabled(TraceCursor, TraceLevel::Error));
+    EXPECT_FALSE(Trace::IsEnabled(TraceTreeBuild, TraceLevel::Error));
+    EXPECT_FALSE(Trace::IsEnabled(TraceCodeGen, TraceLevel::Error));
+}
+
+TEST_FIXTURE(TraceTest, DisabledTraceDoesNotEvaluateMessage)
+{
+    evaluationCount = 0;
+    TRACE_LOG(TraceCursor, TraceLevel::Debug, CountedMessage());
+    EXPECT_EQ(0, evaluationCount);
+    EXPECT_EQ("", _stream.str());
+}
+
+#if !defined(PSGENERATOR_NO_TRACE)
+TEST_FIXTURE(TraceTest, EnabledTraceWritesMessage)
+{
+    Trace::Enable(TraceCursor, TraceLevel::Debug);
+    evaluationCount = 0;
+    TRACE_LOG(TraceCursor, TraceLevel::Debug, CountedMessage() << " " << 1);
+    TRACE_LOG(TraceCodeGen, TraceLevel::Debug, CountedMessage());
+    EXPECT_EQ(1, evaluationCount);
+    EXPECT_EQ("message 1\n", _stream.str());
+}
+#endif
+
+TEST_FIXTURE(TraceTest, LevelSelection)
+{
+    Trace::Enable(TraceAll, TraceLevel::Info);
+    EXPECT_TRUE(Trace::IsEnabled(TraceTreeBuild, TraceLevel::Error));
+    EXPECT_TRUE(Trace::IsEnabled(TraceTreeBuild, TraceLevel::Info));
+    EXPECT_FALSE(Trace::IsEnabled(TraceTreeBuild, TraceLevel::Debug));
+}
+
+TEST_FIXTURE(TraceTest, Configure)
+{
+    EXPECT_TRUE(Trace::Configure("cursor,codegen"));
+    EXPECT_TRUE(Trace::IsEnabled(TraceCursor, TraceLevel::Debug));
+    EXPECT_FALSE(Trace::IsEnabled(TraceTreeBuild, TraceLevel::Error));
+    EXPECT_TRUE(Trace::IsEnabled(TraceCodeGen, TraceLevel::Debug));
+
+    EXPECT_TRUE(Trace::Configure("tree-build:error"));
+    EXPECT_FALSE(Trace::IsEnabled(TraceCursor, TraceLevel::Error));
+    EXPECT_TRUE(Trace::IsEnabled(TraceTreeBuild, TraceLevel::Error));
+    EXPECT_FALSE(Trace::IsEnabled(TraceTreeBuild, TraceLevel::Info));
+
+    EXPECT_TRUE(Trace::Configure("all:info"));
+    EXPECT_TRUE(Trace::IsEnabled(TraceCodeGen, TraceLevel::Info));
+
+    EXPECT_FALSE(Trace::Configure("unknown"));
+    EXPECT_FALSE(Trace::Configure("cursor:verbose"));
+}
+
+} // namespace Test
+} // namespace Utility
@@ -107,5 +107,36 @@ TEST_FIXTURE(UtilityTest, SplitPath)
     EXPECT_EQ(expectedExtension, actualExtension);
 }
 
+TEST_FIXTURE(UtilityTest, ParseNumber)
+{
+    unsigned value = 7;
+    EXPECT_TRUE(ParseNumber("0", value));
+    EXPECT_EQ(0u, value);
+    EXPECT_TRUE(ParseNumber("4294967295", value));
+    EXPECT_EQ(4294967295u, value);
+    EXPECT_FALSE(ParseNumber("", value));
+    EXPECT_FALSE(ParseNumber("-1", value));
+    EXPECT_FALSE(ParseNumber("12abc", value));
+    EXPECT_FALSE(ParseNumber(" 12", value));
+    EXPECT_FALSE(ParseNumber("4294967296", value));
+    EXPECT_EQ(4294967295u, value);
+}
+
+TEST_FIXTURE(UtilityTest, JSONString)
+{
+    EXPECT_EQ("\"\"", JSONString(""));
+    EXPECT_EQ("\"/Path/Dir/File.h\"", JSONString("/Path/Dir/File.h"));
+    EXPECT_EQ("\"a\\\"b\\\\c\\u000a\"", JSONString("a\"b\\c\n"));
+}
+
+TEST_FIXTURE(UtilityTest, StringMemory)
+{
+    std::string shortString = "a";
+    std::string longString(1000, 'a');
+    EXPECT_TRUE(StringMemory(shortString) >= sizeof(std::string));
+    EXPECT_TRUE(StringMemory(shortString) < sizeof(std::string) + 1000);
+    EXPECT_TRUE(StringMemory(longString) >= sizeof(std::string) + 1001);
+}
+
 } // namespace Test
 } // namespace Utility
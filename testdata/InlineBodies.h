@@ -0,0 +1,28 @@
+#pragma once
+
+namespace NS1 {
+
+class c
+{
+public:
+    c()
+        : _x(0)
+    {
+        struct Local { int y; };
+        Local local { 1 };
+        _x = local.y;
+    }
+    int X() const
+    {
+        auto f = [this](int y) { return _x + y; };
+        for (int i = 0; i < 2; ++i)
+            if (i > 0)
+                return f(i);
+        return 0;
+    }
+
+private:
+    int _x;
+};
+
+} // namespace NS1